@@ -15,6 +15,7 @@ export DEBUG=on
 export RELEASE=off
 export COVERAGE=on
 export PROFILE=off
+export TRACE=on
 make -wB |& tee reports/gcc-mediaManager.log
 popd > /dev/null
 
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <fstream>  // NOLINT(readability/streams)
+#include <sstream>
+#include <string>
+    using std::string;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Command_batch.h"
+#include "manager/String_view.h"
+
+
+// a script of numCommands commands, each adding two integers
+static string make_script(const int numCommands) {
+    std::ostringstream script;
+    for (int i = 0; i < numCommands; i++) {
+        script << "ad " << i << " " << i % 7 << "\n";
+    }
+    return script.str();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// run a script as an interactive session does: prompt, read the command a
+// word at a time, and flush the output after it
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_Interactive(benchmark::State& state) {  // NOLINT
+    const int numCommands = static_cast<int>(state.range(0));
+    const string script = make_script(numCommands);
+    std::ofstream out("/dev/null");
+
+    while (state.KeepRunning()) {
+        std::istringstream in(script);
+        string command;
+        for (;;) {
+            out << "\nEnter command: ";
+            if (!(in >> command)) {
+                break;
+            }
+            int i1 = 0;
+            int i2 = 0;
+            in >> i1 >> i2;
+            out << i1 + i2 << std::endl;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numCommands);
+}
+BENCHMARK(BM_Interactive)->Arg(1000)->Arg(100000);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// the same script run as a Command_batch
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_Batch(benchmark::State& state) {  // NOLINT
+    const int numCommands = static_cast<int>(state.range(0));
+    const string script = make_script(numCommands);
+    std::ofstream out("/dev/null");
+
+    while (state.KeepRunning()) {
+        std::istringstream in(script);
+        Command_batch batch(&out);
+        batch.run(&in, [](Command_line* line, std::ostream* output) {
+            int i1 = 0;
+            int i2 = 0;
+            if (line->get_command() != "ad") {
+                return line->fail("Unrecognized command!");
+            }
+            if ((Command_line::OK != line->next_int(&i1)) ||
+                (Command_line::OK != line->next_int(&i2))) {
+                return Command_line::ERROR;
+            }
+            *output << i1 + i2 << "\n";
+            return Command_line::OK;
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * numCommands);
+}
+BENCHMARK(BM_Batch)->Arg(1000)->Arg(100000);
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <mutex>  // NOLINT
+#include <vector>
+    using std::vector;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Concurrent_library.h"
+#include "manager/Ordered_list.h"
+#include "manager/Sorted_array.h"
+
+
+typedef Ordered_list<int, Sorted_array_storage> List;
+
+// Records in the Library
+static const int numRecords = 10000;
+
+// a list of the IDs below numRecords
+static List make_list() {
+    vector<int> IDs;
+    for (int i = 0; i < numRecords; i++) {
+        IDs.push_back(i);
+    }
+    return List(IDs.begin(), IDs.end());
+}
+
+// shared by the threads of a benchmark
+static const List ourList = make_list();
+static std::mutex ourMutex;
+static Concurrent_library<List> ourLibrary(ourList);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// look up Records in a list guarded by a mutex
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_LookupMutex(benchmark::State& state) {  // NOLINT
+    int ID = 0;
+    int found = 0;
+    while (state.KeepRunning()) {
+        ID = (ID + 7919) % numRecords;
+        std::lock_guard<std::mutex> guard(ourMutex);
+        found += (ourList.end() != ourList.find(ID));
+    }
+    benchmark::DoNotOptimize(found);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LookupMutex)->Threads(1)->Threads(4);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// look up Records through a Concurrent_library Reader
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_LookupReader(benchmark::State& state) {  // NOLINT
+    Concurrent_library<List>::Reader reader(&ourLibrary);
+    int ID = 0;
+    int found = 0;
+    while (state.KeepRunning()) {
+        ID = (ID + 7919) % numRecords;
+        const List& list = reader.lock();
+        found += (list.end() != list.find(ID));
+        reader.unlock();
+    }
+    benchmark::DoNotOptimize(found);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LookupReader)->Threads(1)->Threads(4);
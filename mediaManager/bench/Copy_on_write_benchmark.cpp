@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <vector>
+    using std::vector;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Copy_on_write.h"
+#include "manager/Ordered_list.h"
+
+
+typedef Ordered_list<int> List;
+
+// a list of the numbers below numItems
+static List make_list(const int numItems) {
+    vector<int> items;
+    for (int i = 0; i < numItems; i++) {
+        items.push_back(i);
+    }
+    return List(items.begin(), items.end());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// a restore that fails at once, backing up the Library by copying it into a
+// local variable and rolling back by swapping it back
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_RollbackCopy(benchmark::State& state) {  // NOLINT
+    const int numItems = static_cast<int>(state.range(0));
+    List library = make_list(numItems);
+
+    while (state.KeepRunning()) {
+        List backup(library);
+        library.clear();
+        library.insert(-1);
+        library.swap(backup);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RollbackCopy)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// the same, with the Library held in a Copy_on_write
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_RollbackShared(benchmark::State& state) {  // NOLINT
+    const int numItems = static_cast<int>(state.range(0));
+    Copy_on_write<List> library;
+    *library.get_writable() = make_list(numItems);
+
+    while (state.KeepRunning()) {
+        Copy_on_write<List> backup(library);
+        library.clear();
+        library.get_writable()->insert(-1);
+        library.swap(backup);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RollbackShared)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>  // NOLINT(readability/streams)
+#include <string>
+    using std::string;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Journal.h"
+#include "manager/Snapshot.h"
+
+
+// a Library of the given size
+static void make_snapshot(const int numRecords, Snapshot* snapshot) {
+    static const char* const media[] = {"DVD", "VHS", "Blu-ray", "CD", "LP"};
+    for (int i = 1; i <= numRecords; i++) {
+        char title[64];
+        snprintf(title, sizeof(title), "Title of a rather long series %d", i);
+        snapshot->add_record(i, i % 6, media[i % 5], title);
+    }
+}
+
+// a directory for the files of one benchmark, removed when done
+class Temporary_directory {
+  public:
+    Temporary_directory() {
+        char name[] = "/tmp/Journal_benchmark.XXXXXX";
+        if (0 == mkdtemp(name)) {
+            abort();
+        }
+        path = name;
+        snapshot = path + "/library.mms";
+        journal = path + "/library.mmj";
+    }
+
+    ~Temporary_directory() {
+        remove(snapshot.c_str());
+        remove(journal.c_str());
+        rmdir(path.c_str());
+    }
+
+    string path;
+    string snapshot;
+    string journal;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// make a change to a Library of the given size durable by appending it to
+// the journal, compacting whenever the journal asks
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_JournalCommand(benchmark::State& state) {  // NOLINT
+    const int numRecords = static_cast<int>(state.range(0));
+    const Temporary_directory directory;
+    Snapshot snapshot;
+    Journal journal(directory.snapshot.c_str(), directory.journal.c_str());
+    journal.open(&snapshot);
+    journal.replay([](const Journal::Entry&) { return true; });
+    make_snapshot(numRecords, &snapshot);
+    journal.compact(snapshot, Snapshot::BINARY);
+
+    int compactions = 0;
+    int i = 0;
+    while (state.KeepRunning()) {
+        journal.modify_rating(1 + i % numRecords, i % 6);
+        if (journal.needs_compaction()) {
+            journal.compact(snapshot, Snapshot::BINARY);
+            compactions++;
+        }
+        i++;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["compactions"] = compactions;
+}
+BENCHMARK(BM_JournalCommand)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// make a change to a Library of the given size durable by saving all of it,
+// as the save command does
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_SaveEveryCommand(benchmark::State& state) {  // NOLINT
+    const int numRecords = static_cast<int>(state.range(0));
+    const Temporary_directory directory;
+    Snapshot snapshot;
+    make_snapshot(numRecords, &snapshot);
+
+    while (state.KeepRunning()) {
+        std::ofstream file(directory.snapshot.c_str(),
+                           std::ios::out | std::ios::binary);
+        snapshot.save(&file, Snapshot::BINARY);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SaveEveryCommand)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
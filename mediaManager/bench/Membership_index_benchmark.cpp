@@ -0,0 +1,106 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <vector>
+    using std::vector;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Membership_index.h"
+
+
+// Records in the Library, each a member of two Collections
+static const int numRecords = 10000;
+
+// a Collection whose members are kept in a list, as Collection keeps them
+struct Group {
+    bool is_member_present(const int ID) const {
+        return members.end() != std::find(members.begin(), members.end(), ID);
+    }
+
+    void remove_member(const int ID) {
+        members.erase(std::find(members.begin(), members.end(), ID));
+    }
+
+    vector<int> members;
+};
+
+// spread every Record over two of the given number of Groups
+static void make_catalog(const int numGroups,
+                         vector<Group>* groups,
+                         Membership_index<Group>* index) {
+    groups->resize(static_cast<size_t>(numGroups));
+    for (int ID = 1; ID <= numRecords; ID++) {
+        for (int k = 0; k < 2; k++) {
+            Group& group = (*groups)[static_cast<size_t>((ID + k * 7) %
+                                                         numGroups)];
+            if (0 != index) {
+                index->add(ID, &group);
+            }
+            group.members.push_back(ID);
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// delete a Record by asking every Collection whether it is a member, then
+// put it back
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_DeleteRecordScan(benchmark::State& state) {  // NOLINT
+    const int numGroups = static_cast<int>(state.range(0));
+    vector<Group> groups;
+    make_catalog(numGroups, &groups, 0);
+
+    int ID = 0;
+    while (state.KeepRunning()) {
+        ID = 1 + ID % numRecords;
+        vector<Group*> holders;
+        for (size_t i = 0; i < groups.size(); i++) {
+            if (groups[i].is_member_present(ID)) {
+                groups[i].remove_member(ID);
+                holders.push_back(&groups[i]);
+            }
+        }
+        for (size_t i = 0; i < holders.size(); i++) {
+            holders[i]->members.push_back(ID);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeleteRecordScan)->RangeMultiplier(8)->Range(8, 512);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// delete a Record through the Membership_index, then put it back
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_DeleteRecordIndexed(benchmark::State& state) {  // NOLINT
+    const int numGroups = static_cast<int>(state.range(0));
+    vector<Group> groups;
+    Membership_index<Group> index;
+    make_catalog(numGroups, &groups, &index);
+
+    int ID = 0;
+    while (state.KeepRunning()) {
+        ID = 1 + ID % numRecords;
+        vector<Group*> holders;
+        index.remove_record(ID, [ID, &holders](Group* group) {
+            group->remove_member(ID);
+            holders.push_back(group);
+        });
+        for (size_t i = 0; i < holders.size(); i++) {
+            index.add(ID, holders[i]);
+            holders[i]->members.push_back(ID);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeleteRecordIndexed)->RangeMultiplier(8)->Range(8, 512);
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <atomic>  // NOLINT(build/include_order)
+#include <cstdint>  // NOLINT(build/include_order)
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Memory_stats.h"
+
+
+// one counter of each, shared by the threads of a benchmark
+static std::atomic<int64_t> ourCount(0);
+static std::atomic<int64_t> ourBytes(0);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// count a node made and destroyed in counters every thread writes
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_CountShared(benchmark::State& state) {  // NOLINT
+    while (state.KeepRunning()) {
+        ourCount.fetch_add(1);
+        ourBytes.fetch_add(16);
+        ourCount.fetch_sub(1);
+        ourBytes.fetch_sub(16);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CountShared)->Threads(1)->Threads(4);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// the same, counted in Memory_stats
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_CountSharded(benchmark::State& state) {  // NOLINT
+    while (state.KeepRunning()) {
+        Memory_stats::allocated(Memory_stats::LIST_NODE, 16);
+        Memory_stats::deallocated(Memory_stats::LIST_NODE, 16);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CountSharded)->Threads(1)->Threads(4);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// add up the shards, as the pa command does
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_Totals(benchmark::State& state) {  // NOLINT
+    Memory_stats::Totals totals;
+    while (state.KeepRunning()) {
+        Memory_stats::get_totals(Memory_stats::LIST_NODE, &totals);
+        benchmark::DoNotOptimize(totals);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Totals);
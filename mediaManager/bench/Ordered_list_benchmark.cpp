@@ -0,0 +1,193 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdlib>
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Ordered_list.h"
+#include "manager/Skip_list.h"
+#include "manager/Sorted_array.h"
+
+
+typedef Ordered_list<int> Plain_list;
+typedef Ordered_list<int, Skip_list_nodes> Skip_list;
+typedef Ordered_list<int, Sorted_array_storage> Sorted_array;
+
+
+// the same shuffled keys every run, a few of them repeated
+static int* make_keys(const int numKeys) {
+    int* const keys = new int[numKeys];
+    unsigned int seed = 381;
+    for (int i = 0; i < numKeys; i++) {
+        keys[i] = rand_r(&seed) % (numKeys - numKeys / 8 + 1);
+    }
+    return keys;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// build a list of the given size one insert at a time, as "ar" does
+//
+///////////////////////////////////////////////////////////////////////////////
+template<typename List>
+static void BM_OrderedListInsert(benchmark::State& state) {  // NOLINT
+    const int numKeys = static_cast<int>(state.range(0));
+    int* const keys = make_keys(numKeys);
+
+    while (state.KeepRunning()) {
+        List list;
+        for (int i = 0; i < numKeys; i++) {
+            list.insert(keys[i]);
+        }
+        benchmark::DoNotOptimize(list.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numKeys);
+    delete [] keys;
+}
+BENCHMARK_TEMPLATE(BM_OrderedListInsert, Plain_list)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_OrderedListInsert, Skip_list)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_OrderedListInsert, Sorted_array)->Range(1 << 8, 1 << 14);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// build a list of the given size in one batch, as a restore does
+//
+///////////////////////////////////////////////////////////////////////////////
+template<typename List>
+static void BM_OrderedListInsertRange(benchmark::State& state) {  // NOLINT
+    const int numKeys = static_cast<int>(state.range(0));
+    int* const keys = make_keys(numKeys);
+
+    while (state.KeepRunning()) {
+        List list;
+        list.insert_range(keys, keys + numKeys);
+        benchmark::DoNotOptimize(list.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numKeys);
+    delete [] keys;
+}
+BENCHMARK_TEMPLATE(BM_OrderedListInsertRange, Plain_list)
+    ->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_OrderedListInsertRange, Skip_list)
+    ->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_OrderedListInsertRange, Sorted_array)
+    ->Range(1 << 8, 1 << 14);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// look up every key in a list of the given size, as "fr" does
+//
+///////////////////////////////////////////////////////////////////////////////
+template<typename List>
+static void BM_OrderedListFind(benchmark::State& state) {  // NOLINT
+    const int numKeys = static_cast<int>(state.range(0));
+    int* const keys = make_keys(numKeys);
+
+    List list;
+    for (int i = 0; i < numKeys; i++) {
+        list.insert(keys[i]);
+    }
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < numKeys; i++) {
+            benchmark::DoNotOptimize(list.find(keys[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numKeys);
+    delete [] keys;
+}
+BENCHMARK_TEMPLATE(BM_OrderedListFind, Plain_list)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_OrderedListFind, Skip_list)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_OrderedListFind, Sorted_array)->Range(1 << 8, 1 << 14);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// the same lookups through an inlined ordering and through a pointer to an
+// ordering function
+//
+///////////////////////////////////////////////////////////////////////////////
+typedef bool (*Int_ordering)(const int&, const int&);
+
+template<typename List>
+static void find_all_keys(benchmark::State& state,  // NOLINT
+                          List& list) {  // NOLINT
+    const int numKeys = static_cast<int>(state.range(0));
+    int* const keys = make_keys(numKeys);
+    list.insert_range(keys, keys + numKeys);
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < numKeys; i++) {
+            benchmark::DoNotOptimize(list.find(keys[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numKeys);
+    delete [] keys;
+}
+
+static void BM_OrderedListFindInlined(benchmark::State& state) {  // NOLINT
+    Ordered_list<int, Sorted_array_storage> list;
+    find_all_keys(state, list);
+}
+BENCHMARK(BM_OrderedListFindInlined)->Range(1 << 8, 1 << 14);
+
+static void BM_OrderedListFindFunctionPointer(
+        benchmark::State& state) {  // NOLINT
+    Ordered_list<int, Sorted_array_storage, Int_ordering> list(less_than<int>);
+    find_all_keys(state, list);
+}
+BENCHMARK(BM_OrderedListFindFunctionPointer)->Range(1 << 8, 1 << 14);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// visit every item with a lambda and with a pointer to a function
+//
+///////////////////////////////////////////////////////////////////////////////
+static int g_total = 0;
+
+static void add_to_total(const int& i) {
+    g_total += i;
+}
+
+static void BM_OrderedListApplyLambda(benchmark::State& state) {  // NOLINT
+    const int numKeys = static_cast<int>(state.range(0));
+    int* const keys = make_keys(numKeys);
+    const Plain_list list(keys, keys + numKeys);
+
+    while (state.KeepRunning()) {
+        int total = 0;
+        list.apply([&total](const int& i) {total += i;});
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numKeys);
+    delete [] keys;
+}
+BENCHMARK(BM_OrderedListApplyLambda)->Range(1 << 8, 1 << 14);
+
+static void BM_OrderedListApplyFunctionPointer(
+        benchmark::State& state) {  // NOLINT
+    const int numKeys = static_cast<int>(state.range(0));
+    int* const keys = make_keys(numKeys);
+    const Plain_list list(keys, keys + numKeys);
+
+    // keep the call indirect, as it is when the function is chosen at run time
+    void (*volatile function)(const int&) = add_to_total;
+
+    while (state.KeepRunning()) {
+        g_total = 0;
+        list.apply(function);
+        benchmark::DoNotOptimize(g_total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numKeys);
+    delete [] keys;
+}
+BENCHMARK(BM_OrderedListApplyFunctionPointer)->Range(1 << 8, 1 << 14);
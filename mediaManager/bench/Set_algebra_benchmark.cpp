@@ -0,0 +1,108 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdint>  // NOLINT(build/include_order)
+#include <vector>
+    using std::vector;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Ordered_list.h"
+#include "manager/Set_algebra.h"
+
+
+typedef Ordered_list<int> List;
+
+// the ordering the member lists are kept in
+static bool less(const int& i1, const int& i2) {
+    return i1 < i2;
+}
+
+// every step-th ID starting at first, up to about numMembers of them
+static List make_members(const int numMembers, const int first,
+                         const int step) {
+    vector<int> IDs;
+    for (int i = 0; i < numMembers; i++) {
+        IDs.push_back(first + i * step);
+    }
+    return List(IDs.begin(), IDs.end());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// the members two Collections have in common, by walking one and asking the
+// other whether each is a member
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_IntersectLookup(benchmark::State& state) {  // NOLINT
+    const int numMembers = static_cast<int>(state.range(0));
+    const List evens = make_members(numMembers, 0, 2);
+    const List threes = make_members(numMembers, 0, 3);
+
+    while (state.KeepRunning()) {
+        int64_t total = 0;
+        for (List::Iterator it = evens.begin(); evens.end() != it; ++it) {
+            if (threes.end() != threes.find(*it)) {
+                total += *it;
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numMembers);
+}
+BENCHMARK(BM_IntersectLookup)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// the same, by merging the two member lists
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_IntersectMerge(benchmark::State& state) {  // NOLINT
+    const int numMembers = static_cast<int>(state.range(0));
+    const List evens = make_members(numMembers, 0, 2);
+    const List threes = make_members(numMembers, 0, 3);
+
+    while (state.KeepRunning()) {
+        int64_t total = 0;
+        merge_intersection(evens, threes, less, [&total](const int ID) {
+            total += ID;
+        });
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numMembers);
+}
+BENCHMARK(BM_IntersectMerge)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// the Records in any of the given number of Collections of 1000 members
+// each, by merging them all at once
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_UnionAll(benchmark::State& state) {  // NOLINT
+    const int numLists = static_cast<int>(state.range(0));
+    vector<List> members;
+    for (int i = 0; i < numLists; i++) {
+        members.push_back(make_members(1000, i, 1 + i % 7));
+    }
+    vector<const List*> lists;
+    for (size_t i = 0; i < members.size(); i++) {
+        lists.push_back(&members[i]);
+    }
+
+    while (state.KeepRunning()) {
+        int64_t total = 0;
+        merge_union_all(&lists[0], numLists, less, [&total](const int ID) {
+            total += ID;
+        });
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numLists * 1000);
+}
+BENCHMARK(BM_UnionAll)->RangeMultiplier(4)->Range(2, 128);
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstdint>  // NOLINT(build/include_order)
+#include <cstdlib>
+#include <vector>
+    using std::vector;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Slot_map.h"
+
+
+// about the size of a Record
+struct Item {
+    explicit Item(const int in_id)
+      : id(in_id),
+        rating(in_id % 6) {
+    }
+
+    int id;
+    int rating;
+    char title[40];
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// total the ratings of Records allocated one at a time, visited through a
+// list of pointers, as the Library holds them now; the Records are allocated
+// interleaved with other objects and visited in a different order, as after
+// a session of adding and deleting
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_ScanHeapObjects(benchmark::State& state) {  // NOLINT
+    const int numItems = static_cast<int>(state.range(0));
+    vector<Item*> items;
+    vector<char*> others;
+    for (int i = 0; i < numItems; i++) {
+        items.push_back(new Item(i));
+        others.push_back(new char[16 + i % 64]);
+    }
+    unsigned int seed = 7;
+    for (int i = numItems - 1; i > 0; i--) {
+        std::swap(items[static_cast<size_t>(i)],
+                  items[static_cast<size_t>(rand_r(&seed) % (i + 1))]);
+    }
+
+    while (state.KeepRunning()) {
+        int64_t total = 0;
+        for (size_t i = 0; i < items.size(); i++) {
+            total += items[i]->rating;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numItems);
+    for (size_t i = 0; i < items.size(); i++) {
+        delete items[i];
+        delete [] others[i];
+    }
+}
+BENCHMARK(BM_ScanHeapObjects)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// total the ratings of Records kept in a Slot_map, after the same number of
+// erases as there are Records
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_ScanSlotMap(benchmark::State& state) {  // NOLINT
+    const int numItems = static_cast<int>(state.range(0));
+    Slot_map<Item> items;
+    vector<Slot_map<Item>::Handle> handles;
+    for (int i = 0; i < 2 * numItems; i++) {
+        handles.push_back(items.emplace(i));
+    }
+    for (int i = 0; i < 2 * numItems; i += 2) {
+        items.erase(handles[static_cast<size_t>(i)]);
+    }
+
+    while (state.KeepRunning()) {
+        int64_t total = 0;
+        const Item* const data = items.data();
+        for (int i = 0; i < items.size(); i++) {
+            total += data[i].rating;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numItems);
+}
+BENCHMARK(BM_ScanSlotMap)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// look Records up by Handle, in random order, as a Collection's members are
+// visited
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_SlotMapGet(benchmark::State& state) {  // NOLINT
+    const int numItems = static_cast<int>(state.range(0));
+    Slot_map<Item> items;
+    vector<Slot_map<Item>::Handle> handles;
+    for (int i = 0; i < numItems; i++) {
+        handles.push_back(items.emplace(i));
+    }
+    unsigned int seed = 7;
+    for (int i = numItems - 1; i > 0; i--) {
+        std::swap(handles[static_cast<size_t>(i)],
+                  handles[static_cast<size_t>(rand_r(&seed) % (i + 1))]);
+    }
+
+    while (state.KeepRunning()) {
+        int64_t total = 0;
+        for (size_t i = 0; i < handles.size(); i++) {
+            total += items.get(handles[i])->rating;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numItems);
+}
+BENCHMARK(BM_SlotMapGet)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+    using std::stringstream;
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "manager/Snapshot.h"
+#include "manager/Snapshot_reader.h"
+#include "manager/Snapshot_view.h"
+
+
+// a Library of the given size with a handful of media, and a Collection
+// holding every tenth Record
+static void make_snapshot(const int numRecords, Snapshot* snapshot) {
+    static const char* const media[] = {"DVD", "VHS", "Blu-ray", "CD", "LP"};
+    unsigned int seed = 381;
+
+    snapshot->add_collection("every_tenth");
+    for (int i = 1; i <= numRecords; i++) {
+        char title[64];
+        snprintf(title, sizeof(title), "Title %d of a rather long series %d",
+                 rand_r(&seed), i);
+        snapshot->add_record(i, i % 6, media[i % 5], title);
+        if (0 == i % 10) {
+            snapshot->add_member(i);
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// restore a save file of the given number of Records
+//
+///////////////////////////////////////////////////////////////////////////////
+template<Snapshot::Format format>
+static void BM_SnapshotRestore(benchmark::State& state) {  // NOLINT
+    const int numRecords = static_cast<int>(state.range(0));
+    stringstream file;
+    {
+        Snapshot snapshot;
+        make_snapshot(numRecords, &snapshot);
+        snapshot.save(&file, format);
+    }
+
+    while (state.KeepRunning()) {
+        file.clear();
+        file.seekg(0);
+        Snapshot snapshot;
+        snapshot.restore(&file);
+        benchmark::DoNotOptimize(snapshot.get_record_count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numRecords);
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(file.str().size()));
+}
+BENCHMARK_TEMPLATE(BM_SnapshotRestore, Snapshot::TEXT)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SnapshotRestore, Snapshot::BINARY)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// restore a text save file of the given number of Records in memory, parsing
+// on the given number of threads
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_SnapshotRestoreParallel(benchmark::State& state) {  // NOLINT
+    const int numRecords = static_cast<int>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    std::string contents;
+    {
+        Snapshot snapshot;
+        make_snapshot(numRecords, &snapshot);
+        stringstream file;
+        snapshot.save(&file, Snapshot::TEXT);
+        contents = file.str();
+    }
+
+    while (state.KeepRunning()) {
+        Snapshot snapshot;
+        snapshot.restore_parallel(contents.data(), contents.size(), threads,
+                                  0);
+        benchmark::DoNotOptimize(snapshot.get_record_count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numRecords);
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(contents.size()));
+}
+BENCHMARK(BM_SnapshotRestoreParallel)
+    ->RangeMultiplier(2)->Ranges({{1 << 20, 1 << 20}, {1, 8}})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// read a save file a chunk at a time without keeping it, as a streaming
+// restore does before building anything
+//
+///////////////////////////////////////////////////////////////////////////////
+template<Snapshot::Format format>
+static void BM_SnapshotReader(benchmark::State& state) {  // NOLINT
+    const int numRecords = static_cast<int>(state.range(0));
+    stringstream file;
+    {
+        Snapshot snapshot;
+        make_snapshot(numRecords, &snapshot);
+        snapshot.save(&file, format);
+    }
+
+    Snapshot_reader reader;
+    while (state.KeepRunning()) {
+        file.clear();
+        file.seekg(0);
+        reader.open(&file);
+        int count;
+        int64_t total = 0;
+        do {
+            reader.next_records(&count);
+            total += count;
+        } while (count > 0);
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numRecords);
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(file.str().size()));
+}
+BENCHMARK_TEMPLATE(BM_SnapshotReader, Snapshot::TEXT)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SnapshotReader, Snapshot::BINARY)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// locate the Records of a binary save file in place, as a mapped restore does
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_SnapshotViewAttach(benchmark::State& state) {  // NOLINT
+    const int numRecords = static_cast<int>(state.range(0));
+    stringstream file;
+    {
+        Snapshot snapshot;
+        make_snapshot(numRecords, &snapshot);
+        snapshot.save(&file, Snapshot::BINARY);
+    }
+    const std::string contents = file.str();
+
+    while (state.KeepRunning()) {
+        Snapshot_view view;
+        view.attach(contents.data(), contents.size());
+        benchmark::DoNotOptimize(view.get_record_count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numRecords);
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(contents.size()));
+}
+BENCHMARK(BM_SnapshotViewAttach)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// save the given number of Records
+//
+///////////////////////////////////////////////////////////////////////////////
+template<Snapshot::Format format>
+static void BM_SnapshotSave(benchmark::State& state) {  // NOLINT
+    const int numRecords = static_cast<int>(state.range(0));
+    Snapshot snapshot;
+    make_snapshot(numRecords, &snapshot);
+
+    while (state.KeepRunning()) {
+        stringstream file;
+        snapshot.save(&file, format);
+        benchmark::DoNotOptimize(file.tellp());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numRecords);
+}
+BENCHMARK_TEMPLATE(BM_SnapshotSave, Snapshot::TEXT)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SnapshotSave, Snapshot::BINARY)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
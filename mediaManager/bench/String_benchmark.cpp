@@ -0,0 +1,211 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+    using std::string;
+
+#include "benchmark/benchmark.h"
+
+#include "manager/String.h"
+
+
+// String buffers come from new[]; count those calls so the benchmarks can
+// report heap traffic alongside the timings.
+static int g_array_allocations = 0;
+
+void* operator new[](size_t size) {
+    g_array_allocations++;
+    void* const ptr = std::malloc(size);
+    if (0 == ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw() {
+    g_array_allocations++;
+    return std::malloc(size);
+}
+
+void operator delete[](void* ptr) throw() {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) throw() {
+    std::free(ptr);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// init / destroy of a single String of the given length
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_StringInit(benchmark::State& state) {  // NOLINT
+    const string contents(static_cast<size_t>(state.range(0)), 'x');
+    const int allocationsBefore = g_array_allocations;
+
+    while (state.KeepRunning()) {
+        String test;
+        test.init(contents.c_str());
+        benchmark::DoNotOptimize(test.c_str());
+    }
+
+    state.counters["heap_allocs"] =
+        static_cast<double>(g_array_allocations - allocationsBefore) /
+        static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_StringInit)->Arg(2)->Arg(3)->Arg(12)->Arg(15)->Arg(16)->Arg(64);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// load a batch of medium/title pairs, as a restore would
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_StringLoadRecords(benchmark::State& state) {  // NOLINT
+    static const char* const media[] = {"DVD", "VHS", "CD", "LP"};
+    static const char* const titles[] = {"Alien", "Casablanca", "Vertigo",
+                                         "The Third Man", "Rear Window"};
+    const int numRecords = static_cast<int>(state.range(0));
+    const int allocationsBefore = g_array_allocations;
+
+    while (state.KeepRunning()) {
+        String* const medium = new String[numRecords];
+        String* const title = new String[numRecords];
+
+        for (int i = 0; i < numRecords; i++) {
+            medium[i].init(media[i % 4]);
+            title[i].init(titles[i % 5]);
+        }
+
+        benchmark::DoNotOptimize(String::get_total_allocation());
+        delete [] medium;
+        delete [] title;
+    }
+
+    // two new[] calls per iteration are the arrays themselves
+    state.counters["heap_allocs"] =
+        static_cast<double>(g_array_allocations - allocationsBefore) /
+        static_cast<double>(state.iterations()) - 2.0;
+    state.SetItemsProcessed(state.iterations() * numRecords);
+}
+BENCHMARK(BM_StringLoadRecords)->Arg(1000)->Arg(100000);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// inline accessors - shows the cost of the TRACE_VLOG tracing per call
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_StringAccessors(benchmark::State& state) {  // NOLINT
+    String test;
+    test.init("Casablanca");
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(test.c_str());
+        benchmark::DoNotOptimize(test.size());
+        benchmark::DoNotOptimize(test.get_allocation());
+        benchmark::DoNotOptimize(String::get_number());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_StringAccessors);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// insert_before / remove at the front - shifts the whole contents each way
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_StringInsertRemove(benchmark::State& state) {  // NOLINT
+    const string contents(static_cast<size_t>(state.range(0)), 'x');
+    String test;
+    String src;
+    test.init(contents.c_str());
+    src.init("-");
+
+    while (state.KeepRunning()) {
+        test.insert_before(0, src);
+        test.remove(0, 1);
+        benchmark::DoNotOptimize(test.c_str());
+    }
+
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+BENCHMARK(BM_StringInsertRemove)->RangeMultiplier(8)->Range(8, 1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// replace in the middle with a source of a different length
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_StringReplace(benchmark::State& state) {  // NOLINT
+    const int size = static_cast<int>(state.range(0));
+    const string contents(static_cast<size_t>(size), 'x');
+    String test;
+    String longer;
+    String shorter;
+    test.init(contents.c_str());
+    longer.init("abcd");
+    shorter.init("ab");
+
+    while (state.KeepRunning()) {
+        test.replace(size / 2, 2, longer);
+        test.replace(size / 2, 4, shorter);
+        benchmark::DoNotOptimize(test.c_str());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringReplace)->RangeMultiplier(8)->Range(8, 1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// build a listing by appending raw chunks
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_StringAppend(benchmark::State& state) {  // NOLINT
+    const int total = static_cast<int>(state.range(0));
+    static const char chunk[] = "42: DVD 5 Casablanca\n";
+    const int chunkLen = static_cast<int>(sizeof(chunk)) - 1;
+
+    while (state.KeepRunning()) {
+        String listing;
+        listing.init("");
+        for (int size = 0; size < total; size += chunkLen) {
+            listing.append(chunk, chunkLen);
+        }
+        benchmark::DoNotOptimize(listing.c_str());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringAppend)->RangeMultiplier(8)->Range(8, 1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// same listing, pre-sized with reserve
+//
+///////////////////////////////////////////////////////////////////////////////
+static void BM_StringAppendReserved(benchmark::State& state) {  // NOLINT
+    const int total = static_cast<int>(state.range(0));
+    static const char chunk[] = "42: DVD 5 Casablanca\n";
+    const int chunkLen = static_cast<int>(sizeof(chunk)) - 1;
+
+    while (state.KeepRunning()) {
+        String listing;
+        listing.init("");
+        listing.reserve(total + chunkLen + 1);
+        for (int size = 0; size < total; size += chunkLen) {
+            listing.append(chunk, chunkLen);
+        }
+        benchmark::DoNotOptimize(listing.c_str());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringAppendReserved)->RangeMultiplier(8)->Range(8, 1 << 20);
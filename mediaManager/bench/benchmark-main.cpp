@@ -0,0 +1,23 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+
+
+int main(int argc, char **argv) {
+    // Initialize Google Benchmark
+    ::benchmark::Initialize(&argc, argv);
+
+    // Initialize Google's logging library.
+    google::InitGoogleLogging(argv[0]);
+
+    ::benchmark::RunSpecifiedBenchmarks();
+
+    // Shutdown google's logging library.
+    google::ShutdownGoogleLogging();
+
+    return 0;
+}
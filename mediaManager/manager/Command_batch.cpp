@@ -0,0 +1,273 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/Command_batch.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>  // NOLINT(build/include_order)
+#include <cstring>
+#include <istream>  // NOLINT(readability/streams)
+#include <new>
+  using std::nothrow;
+#include <ostream>  // NOLINT(readability/streams)
+
+#include "glog/logging.h"
+
+#include "manager/String_view.h"
+#include "manager/Utility.h"
+
+
+// initialize static members
+const size_t Command_batch::ourChunkSize;
+
+
+// whether c separates words
+static bool isBlank(const char c) {
+    return (' ' == c) || ('\t' == c);
+}
+
+// allocate a buffer of bytes characters
+static char* newBuffer(const size_t bytes) {
+    char* const buffer = new(nothrow) char[bytes];
+    if (0 == buffer) {
+        LOG(FATAL) << "Command_batch - call to new[] failed!";
+        return 0;  // unreachable
+    }
+    return buffer;
+}
+
+
+// Command_line constructor
+Command_line::Command_line(const String_view text)
+          : myNext(text.data()),
+            myEnd(text.data() + text.size()),
+            myError(0) {
+    TRACE_VLOG(1) << "Method Entry:  Command_line::Command_line";
+
+    // a blank line has an empty command, and reads fail with no message
+    skipBlanks();
+    const char* const command = myNext;
+    while ((myNext != myEnd) && !isBlank(*myNext)) {
+        myNext++;
+    }
+    myCommand = String_view(command, static_cast<int>(myNext - command));
+
+    TRACE_VLOG(1) << "Method Exit :  Command_line::Command_line";
+}
+
+// next_word
+Command_line::Status Command_line::next_word(String_view* const word) {
+    TRACE_VLOG(1) << "Method Entry:  Command_line::next_word";
+
+    skipBlanks();
+    if (myNext == myEnd) {
+        TRACE_VLOG(1) << "Method Exit :  Command_line::next_word";
+        return fail("Missing argument!");
+    }
+
+    const char* const begin = myNext;
+    while ((myNext != myEnd) && !isBlank(*myNext)) {
+        myNext++;
+    }
+    *word = String_view(begin, static_cast<int>(myNext - begin));
+
+    TRACE_VLOG(1) << "Method Exit :  Command_line::next_word";
+    return OK;
+}
+
+// next_int
+Command_line::Status Command_line::next_int(int* const value) {
+    TRACE_VLOG(1) << "Method Entry:  Command_line::next_int";
+
+    String_view word;
+    if (OK != next_word(&word)) {
+        TRACE_VLOG(1) << "Method Exit :  Command_line::next_int";
+        return fail("Could not read an integer value!");
+    }
+
+    // the whole word must be an optional sign and digits, and fit in an int
+    const char* digit = word.data();
+    const char* const end = word.data() + word.size();
+    const bool negative = ('-' == *digit);
+    if (negative || ('+' == *digit)) {
+        digit++;
+    }
+    if (digit == end) {
+        TRACE_VLOG(1) << "Method Exit :  Command_line::next_int";
+        return fail("Could not read an integer value!");
+    }
+    int64_t magnitude = 0;
+    for (; digit != end; digit++) {
+        if ((*digit < '0') || (*digit > '9') || (magnitude > INT_MAX)) {
+            TRACE_VLOG(1) << "Method Exit :  Command_line::next_int";
+            return fail("Could not read an integer value!");
+        }
+        magnitude = 10 * magnitude + (*digit - '0');
+    }
+    const int64_t result = negative ? -magnitude : magnitude;
+    if ((result < INT_MIN) || (result > INT_MAX)) {
+        TRACE_VLOG(1) << "Method Exit :  Command_line::next_int";
+        return fail("Could not read an integer value!");
+    }
+    *value = static_cast<int>(result);
+
+    TRACE_VLOG(1) << "Method Exit :  Command_line::next_int";
+    return OK;
+}
+
+// rest
+Command_line::Status Command_line::rest(String_view* const text) {
+    TRACE_VLOG(1) << "Method Entry:  Command_line::rest";
+
+    skipBlanks();
+    const char* end = myEnd;
+    while ((end != myNext) && isBlank(*(end - 1))) {
+        end--;
+    }
+    if (end == myNext) {
+        TRACE_VLOG(1) << "Method Exit :  Command_line::rest";
+        return fail("Missing argument!");
+    }
+    *text = String_view(myNext, static_cast<int>(end - myNext));
+    myNext = myEnd;
+
+    TRACE_VLOG(1) << "Method Exit :  Command_line::rest";
+    return OK;
+}
+
+// skipBlanks
+void Command_line::skipBlanks() {
+    while ((myNext != myEnd) && isBlank(*myNext)) {
+        myNext++;
+    }
+}
+
+
+// Output_buffer constructor
+Command_batch::Output_buffer::Output_buffer(std::ostream* const out)
+          : myOut(out),
+            myBuffer(newBuffer(ourChunkSize)) {
+    TRACE_VLOG(1) << "Method Entry:  Command_batch::Output_buffer::"
+                  << "Output_buffer";
+
+    setp(myBuffer, myBuffer + ourChunkSize);
+
+    TRACE_VLOG(1) << "Method Exit :  Command_batch::Output_buffer::"
+                  << "Output_buffer";
+}
+
+// Output_buffer destructor
+Command_batch::Output_buffer::~Output_buffer() {
+    TRACE_VLOG(1) << "Method Entry:  Command_batch::Output_buffer::"
+                  << "~Output_buffer";
+
+    sync();
+    delete [] myBuffer;
+
+    TRACE_VLOG(1) << "Method Exit :  Command_batch::Output_buffer::"
+                  << "~Output_buffer";
+}
+
+// Output_buffer::overflow
+Command_batch::Output_buffer::int_type
+Command_batch::Output_buffer::overflow(const int_type c) {
+    if (0 != sync()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(traits_type::eof(), c)) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+// Output_buffer::sync
+int Command_batch::Output_buffer::sync() {
+    const std::streamsize bytes = pptr() - pbase();
+    if (0 != bytes) {
+        myOut->write(pbase(), bytes);
+        setp(myBuffer, myBuffer + ourChunkSize);
+    }
+    myOut->flush();
+    return myOut->good() ? 0 : -1;
+}
+
+
+// constructor
+Command_batch::Command_batch(std::ostream* const out)
+          : myInput(newBuffer(ourChunkSize)),
+            myInputCapacity(ourChunkSize),
+            myBegin(0),
+            myEnd(0),
+            myOutputBuffer(out),
+            myOutput(&myOutputBuffer),
+            myLineNumber(0),
+            myCommandCount(0),
+            myErrorCount(0),
+            myStopped(false) {
+    TRACE_VLOG(1) << "Method Entry:  Command_batch::Command_batch";
+    TRACE_VLOG(1) << "Method Exit :  Command_batch::Command_batch";
+}
+
+// destructor
+Command_batch::~Command_batch() {
+    TRACE_VLOG(1) << "Method Entry:  Command_batch::~Command_batch";
+
+    delete [] myInput;
+
+    TRACE_VLOG(1) << "Method Exit :  Command_batch::~Command_batch";
+}
+
+// nextLine
+bool Command_batch::nextLine(std::istream* const in,
+                             String_view* const line) {
+    for (;;) {
+        const char* const begin = myInput + myBegin;
+        const char* const newline = static_cast<const char*>(
+            memchr(begin, '\n', myEnd - myBegin));
+
+        // a whole line, or the last one, which has no newline
+        if ((0 != newline) || (!in->good() && (myBegin != myEnd))) {
+            const char* end = (0 != newline) ? newline : myInput + myEnd;
+            myBegin = (0 != newline) ?
+                static_cast<size_t>(newline + 1 - myInput) : myEnd;
+            if ((end != begin) && ('\r' == *(end - 1))) {
+                end--;
+            }
+            *line = String_view(begin, static_cast<int>(end - begin));
+            myLineNumber++;
+            return true;
+        }
+        if (!in->good()) {
+            return false;
+        }
+
+        // move the start of the line to the front, growing the buffer if the
+        // line fills it, and read another chunk after it
+        memmove(myInput, begin, myEnd - myBegin);
+        myEnd -= myBegin;
+        myBegin = 0;
+        if (myInputCapacity - myEnd < ourChunkSize / 2) {
+            char* const input = newBuffer(2 * myInputCapacity);
+            memcpy(input, myInput, myEnd);
+            delete [] myInput;
+            myInput = input;
+            myInputCapacity *= 2;
+        }
+        in->read(myInput + myEnd,
+                 static_cast<std::streamsize>(myInputCapacity - myEnd));
+        myEnd += static_cast<size_t>(in->gcount());
+    }
+}
+
+// reportError
+void Command_batch::reportError(const Command_line& line) {
+    myErrorCount++;
+    myOutput << "Line " << myLineNumber << ": "
+             << ((0 != line.get_error()) ? line.get_error() :
+                                           "Command failed!")
+             << "\n";
+}
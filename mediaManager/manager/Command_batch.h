@@ -0,0 +1,369 @@
+#ifndef MEDIAMANAGER_MANAGER_COMMAND_BATCH_H_
+#define MEDIAMANAGER_MANAGER_COMMAND_BATCH_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstddef>
+#include <istream>  // NOLINT(readability/streams)
+#include <ostream>  // NOLINT(readability/streams)
+#include <streambuf>  // NOLINT(build/include_order)
+
+#include "glog/logging.h"
+#include "manager/String_view.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Command_batch.h
+ * @brief Declaration of Command_line and Command_batch classes.
+ */
+
+
+/**
+ * @class Command_line Command_batch.h manager/Command_batch.h
+ *
+ * @brief One line of a command file: the command, the first word, and its
+ * arguments, which are read from the rest of the line in turn.
+ *
+ * @details Words are separated by spaces or tabs.  The line is not copied,
+ * so the String_views handed out are valid only while the command runs.
+ * A read that fails records a message for the error report, and a command
+ * can record its own with fail().
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Command_line {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * Constructor that splits off the command.
+     *
+     * @pre  text holds no newline.
+     * @post get_command() is the first word of text, and the arguments are
+     *       read from after it.
+     *
+     * @param text The line
+     */
+    explicit Command_line(const String_view text);
+
+    /**
+     * @return the command, e.g. "fr"
+     */
+    String_view get_command() const {
+        return myCommand;
+    }
+
+    /**
+     * Read the next word.
+     *
+     * @pre  None.
+     * @post word holds the next word, or the line is failed on ERROR.
+     *
+     * @param word The word
+     *
+     * @return ERROR if there are no words left, otherwise OK
+     */
+    Status next_word(String_view* const word);
+
+    /**
+     * Read the next word as an integer, e.g. a Record ID.
+     *
+     * @pre  None.
+     * @post value holds the integer, or the line is failed on ERROR.
+     *
+     * @param value The integer
+     *
+     * @return ERROR if the next word is missing or is not an integer,
+     *         otherwise OK
+     */
+    Status next_int(int* const value);
+
+    /**
+     * Read the rest of the line, without the spaces around it, e.g. a title.
+     *
+     * @pre  None.
+     * @post text holds the rest of the line, and no words are left; the line
+     *       is failed on ERROR.
+     *
+     * @param text The rest of the line
+     *
+     * @return ERROR if the rest of the line is blank, otherwise OK
+     */
+    Status rest(String_view* const text);
+
+    /**
+     * Record why the command failed.
+     *
+     * @pre  None.
+     * @post get_error() returns message.
+     *
+     * @param message Message for the error report; a string literal
+     *
+     * @return ERROR, for the command to return
+     */
+    Status fail(const char* const message) {
+        myError = message;
+        return ERROR;
+    }
+
+    /**
+     * @return why the command failed, or 0 if no reason was recorded
+     */
+    const char* get_error() const {
+        return myError;
+    }
+
+  private:
+    /**
+     * Skip the spaces and tabs at myNext.
+     */
+    void skipBlanks();
+
+    String_view myCommand;
+
+    /**
+     * The unread part of the line.
+     */
+    const char* myNext;
+    const char* myEnd;
+
+    const char* myError;
+};
+
+
+/**
+ * @class Command_batch Command_batch.h manager/Command_batch.h
+ *
+ * @brief Runs a file of commands, one per line, without prompting.
+ *
+ * @details Interactive input prompts for each command, reads it a word at a
+ * time, and flushes the output after it, which is slow for scripts of many
+ * thousands of commands.  A Command_batch instead reads its input, a command
+ * file or stdin, in chunks of ourChunkSize bytes, hands each line to the
+ * caller's function as a Command_line, and collects the output in a buffer of
+ * ourChunkSize bytes that is written out only when it fills and at the end.
+ * Output should therefore end lines with '\\n' rather than std::endl.
+ *
+ * A command that fails does not end the batch: the error is reported in the
+ * output, in order with the rest, as "Line 12: Unrecognized command!", and
+ * the next line is run.  Blank lines and lines starting with '#' are skipped.
+ * @verbatim
+   Command_batch batch(&std::cout);
+   batch.run(&std::cin, [&](Command_line* line, std::ostream* out) {
+       if (line->get_command() == "qq") {
+           batch.stop();
+           return Command_line::OK;
+       }
+       ... look up and run the command, writing to *out ...
+       return line->fail("Unrecognized command!");
+   });
+   @endverbatim
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Command_batch {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * Bytes read from the input, and collected for the output, at a time.
+     */
+    static const size_t ourChunkSize = 64 * 1024;
+
+    /**
+     * Constructor that sets where the output goes.
+     *
+     * @pre  None.
+     * @post No line has been read.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param out Stream the output and error reports are written to
+     */
+    explicit Command_batch(std::ostream* const out);
+
+    /**
+     * Writes out any output still buffered, and deallocates the buffers.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Command_batch();
+
+    /**
+     * Run the commands in in, until its end or stop().
+     *
+     * @pre  None.
+     * @post Every line has been given to execute, and all the output
+     *       written.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param in      Stream to read the commands from
+     * @param execute Function taking a Command_line* and the std::ostream* to
+     *                write to, which runs the command and returns
+     *                Command_line::OK, or Command_line::ERROR if it failed
+     *
+     * @return ERROR if in could not be read to the end, otherwise OK, even
+     *         if commands failed
+     */
+    template<typename Execute>
+    Status run(std::istream* const in, Execute execute);
+
+    /**
+     * Stop after the command running, e.g. on a quit command.
+     *
+     * @pre  None.
+     * @post run() returns once the command returns.
+     */
+    void stop() {
+        myStopped = true;
+    }
+
+    /**
+     * @return the number of the last line read, counting from 1
+     */
+    int get_line_number() const {
+        return myLineNumber;
+    }
+
+    /**
+     * @return the number of commands run
+     */
+    int get_command_count() const {
+        return myCommandCount;
+    }
+
+    /**
+     * @return the number of commands that failed
+     */
+    int get_error_count() const {
+        return myErrorCount;
+    }
+
+  private:
+    /**
+     * A stream buffer that collects output and writes it to another stream
+     * in blocks of ourChunkSize bytes.
+     */
+    class Output_buffer : public std::streambuf {
+      public:
+        explicit Output_buffer(std::ostream* const out);
+        virtual ~Output_buffer();
+
+      protected:
+        // write out the buffer, then take c
+        virtual int_type overflow(int_type c);
+
+        // write out the buffer
+        virtual int sync();
+
+      private:
+        std::ostream* myOut;
+
+        char* myBuffer;
+
+        /**
+         * Remove copy constructor and assignment operator.
+         */
+        DISALLOW_COPY_AND_ASSIGN(Output_buffer);
+    };
+
+    /**
+     * Read the next line of in, without its line ending.
+     *
+     * @param in   Stream to read from
+     * @param line The line, valid until the next call
+     *
+     * @return false at the end of in, otherwise true
+     */
+    bool nextLine(std::istream* const in, String_view* const line);
+
+    /**
+     * Report a failed command.
+     *
+     * @param line The command's line
+     */
+    void reportError(const Command_line& line);
+
+    /**
+     * Input read but not yet handed out, in [myBegin, myEnd) of myInput.
+     */
+    char*  myInput;
+    size_t myInputCapacity;
+    size_t myBegin;
+    size_t myEnd;
+
+    Output_buffer myOutputBuffer;
+    std::ostream  myOutput;
+
+    int  myLineNumber;
+    int  myCommandCount;
+    int  myErrorCount;
+    bool myStopped;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Command_batch);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// run
+template<typename Execute>
+Command_batch::Status Command_batch::run(std::istream* const in,
+                                         Execute execute) {
+    TRACE_VLOG(1) << "Method Entry:  Command_batch::run";
+
+    myStopped = false;
+    String_view text;
+    while (!myStopped && nextLine(in, &text)) {
+        Command_line line(text);
+        if (line.get_command().empty() ||
+            ('#' == *line.get_command().data())) {
+            continue;
+        }
+
+        myCommandCount++;
+        if (Command_line::OK != execute(&line, &myOutput)) {
+            reportError(line);
+        }
+    }
+    myOutput.flush();
+
+    // the end of the input, or a stop, is the only way out of the loop
+    const Status status = (myStopped || !in->bad()) ? OK : ERROR;
+    if (ERROR == status) {
+        LOG(ERROR) << "Command_batch::run - error reading line "
+                   << myLineNumber + 1;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Command_batch::run";
+    return status;
+}
+
+#endif  // MEDIAMANAGER_MANAGER_COMMAND_BATCH_H_
@@ -0,0 +1,343 @@
+#ifndef MEDIAMANAGER_MANAGER_CONCURRENT_LIBRARY_H_
+#define MEDIAMANAGER_MANAGER_CONCURRENT_LIBRARY_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <atomic>  // NOLINT(build/include_order)
+#include <mutex>  // NOLINT
+#include <new>
+#include <thread>  // NOLINT
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Concurrent_library.h
+ * @brief Declaration and definition of Concurrent_library class template.
+ */
+
+
+/**
+ * @class Concurrent_library Concurrent_library.h manager/Concurrent_library.h
+ *
+ * @brief A container, such as the Library, that many threads can search
+ * while one at a time changes it.
+ *
+ * @details Readers take no lock and write nothing shared but their own slot,
+ * in the manner of read-copy-update: the container is never changed in
+ * place.  A writer copies the current version, changes the copy, and
+ * publishes it with one atomic store; readers that already hold the old
+ * version go on reading it, and the writer frees it once none does.
+ *
+ * Each reader thread registers a Reader, which owns one of ourMaxReaders
+ * slots.  Reader::lock() loads the current version and records it in the
+ * slot (a hazard pointer), checking that it is still current afterwards;
+ * Reader::unlock() clears the slot.  After publishing a new version,
+ * update() waits until no slot holds the old one before destroying it, so a
+ * reader should hold its lock only for a lookup or two.  Because update()
+ * returns only after that, an object removed from the container, such as a
+ * Record, can be deleted as soon as update() returns.
+ *
+ * Every version is made and destroyed by the writer, so the Strings and
+ * Ordered_lists that Memory_stats counts are made and destroyed on one
+ * thread, which keeps their high-water marks exact.  Each update copies the
+ * whole container, which for an Ordered_list with Sorted_array_storage is
+ * one allocation and a copy of the items; changes that come together, such
+ * as the Records of a file, should be made in one update.
+ * @verbatim
+   // on each reader thread
+   Concurrent_library<Library>::Reader reader(&library);
+   const Library& records = reader.lock();
+   ... find, apply ...
+   reader.unlock();
+
+   // on the writer's thread
+   library.update([record](Library* records) { records->insert(record); });
+   @endverbatim
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename C>
+class Concurrent_library {
+  public:
+    /**
+     * Largest number of Readers registered at once.
+     */
+    static const int ourMaxReaders = 64;
+
+    /**
+     * A reader thread's registration, which pins one version at a time.
+     */
+    class Reader {
+      public:
+        /**
+         * Register a reader.
+         *
+         * @pre  Fewer than ourMaxReaders Readers of library exist.
+         * @post Reader holds a slot, and no version.
+         *
+         * @warning If every slot is taken, the program will LOG and
+         *          terminate.
+         *
+         * @param library The container to read
+         */
+        explicit Reader(Concurrent_library* const library);
+
+        /**
+         * Unlock and give up the slot.
+         *
+         * @pre  None.
+         * @post Object has been destroyed.
+         */
+        ~Reader();
+
+        /**
+         * Pin the current version, letting go of any pinned before.
+         *
+         * @pre  None.
+         * @post The version returned is not destroyed until unlock().
+         *
+         * @return the current version of the container
+         */
+        const C& lock();
+
+        /**
+         * Let go of the pinned version.
+         *
+         * @pre  None.
+         * @post No version is pinned.
+         */
+        void unlock();
+
+      private:
+        Concurrent_library* myLibrary;
+
+        int mySlot;
+
+        /**
+         * Remove copy constructor and assignment operator.
+         */
+        DISALLOW_COPY_AND_ASSIGN(Reader);
+    };
+
+    /**
+     * Constructor that initializes the first version as a copy of initial.
+     *
+     * @pre  None.
+     * @post The current version holds the items of initial.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param initial Container to start from, e.g. an empty Ordered_list
+     *                with its ordering function
+     */
+    explicit Concurrent_library(const C& initial = C());
+
+    /**
+     * Deallocates the current version.
+     *
+     * @pre  No Reader exists.
+     * @post Object has been destroyed.
+     */
+    ~Concurrent_library();
+
+    /**
+     * Change the container: call function with a copy of the current
+     * version, publish the copy, and destroy the old version once no reader
+     * holds it.  Updates from several threads are made one at a time.
+     *
+     * @pre  The calling thread has no version locked.
+     * @post Readers that lock from now on see the change.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param function Function taking a C*, which changes it
+     */
+    template<typename Function>
+    void update(Function function);
+
+    /**
+     * @return the number of updates made
+     */
+    int get_version() const {
+        return myVersion.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * A reader's hazard pointer, alone in its cache line so that readers on
+     * different cores do not contend.
+     */
+    struct alignas(64) Slot {
+        std::atomic<const C*> hazard;
+        std::atomic<bool> taken;
+    };
+
+    /**
+     * @return a new version holding a copy of container
+     */
+    static C* makeVersion(const C& container);
+
+    /**
+     * The version readers lock, alone in its cache line so that writes to
+     * the members after it do not slow the readers loading it.
+     */
+    alignas(64) std::atomic<C*> myCurrent;
+
+    /**
+     * Number of updates made.
+     */
+    alignas(64) std::atomic<int> myVersion;
+
+    /**
+     * Makes writers take turns.
+     */
+    std::mutex myWriterMutex;
+
+    Slot mySlots[ourMaxReaders];  // NOLINT(runtime/arrays)
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Concurrent_library);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename C>
+const int Concurrent_library<C>::ourMaxReaders;
+
+// Reader constructor
+template<typename C>
+Concurrent_library<C>::Reader::Reader(Concurrent_library* const library)
+          : myLibrary(library),
+            mySlot(-1) {
+    TRACE_VLOG(1) << "Method Entry:  Concurrent_library::Reader::Reader";
+
+    for (int i = 0; (-1 == mySlot) && (i < ourMaxReaders); i++) {
+        bool taken = false;
+        if (library->mySlots[i].taken.compare_exchange_strong(taken, true)) {
+            mySlot = i;
+        }
+    }
+    if (-1 == mySlot) {
+        LOG(FATAL) << "Concurrent_library::Reader::Reader - more than "
+                   << ourMaxReaders << " readers!";
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Concurrent_library::Reader::Reader";
+}
+
+// Reader destructor
+template<typename C>
+Concurrent_library<C>::Reader::~Reader() {
+    TRACE_VLOG(1) << "Method Entry:  Concurrent_library::Reader::~Reader";
+
+    unlock();
+    myLibrary->mySlots[mySlot].taken.store(false);
+
+    TRACE_VLOG(1) << "Method Exit :  Concurrent_library::Reader::~Reader";
+}
+
+// Reader::lock
+template<typename C>
+const C& Concurrent_library<C>::Reader::lock() {
+    Slot& slot = myLibrary->mySlots[mySlot];
+
+    // once the slot holds the version, an update that replaces it will wait
+    // for the slot to clear; if the version was replaced before the slot
+    // was set, the update may not have seen it, so try again
+    const C* current = myLibrary->myCurrent.load();
+    for (;;) {
+        slot.hazard.store(current);
+        const C* const check = myLibrary->myCurrent.load();
+        if (check == current) {
+            return *current;
+        }
+        current = check;
+    }
+}
+
+// Reader::unlock
+template<typename C>
+void Concurrent_library<C>::Reader::unlock() {
+    myLibrary->mySlots[mySlot].hazard.store(0, std::memory_order_release);
+}
+
+// constructor
+template<typename C>
+Concurrent_library<C>::Concurrent_library(const C& initial)
+          : myCurrent(makeVersion(initial)),
+            myVersion(0) {
+    TRACE_VLOG(1) << "Method Entry:  Concurrent_library::Concurrent_library";
+
+    for (int i = 0; i < ourMaxReaders; i++) {
+        mySlots[i].hazard.store(0);
+        mySlots[i].taken.store(false);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Concurrent_library::Concurrent_library";
+}
+
+// destructor
+template<typename C>
+Concurrent_library<C>::~Concurrent_library() {
+    TRACE_VLOG(1) << "Method Entry:  Concurrent_library::~Concurrent_library";
+
+    delete myCurrent.load();
+
+    TRACE_VLOG(1) << "Method Exit :  Concurrent_library::~Concurrent_library";
+}
+
+// update
+template<typename C>
+template<typename Function>
+void Concurrent_library<C>::update(Function function) {
+    TRACE_VLOG(1) << "Method Entry:  Concurrent_library::update";
+
+    std::lock_guard<std::mutex> guard(myWriterMutex);
+
+    C* const old = myCurrent.load();
+    C* const next = makeVersion(*old);
+    function(next);
+    myCurrent.store(next);
+    myVersion.fetch_add(1, std::memory_order_relaxed);
+
+    // wait for the readers that locked the old version to let go of it;
+    // readers that lock from now on get the new one
+    for (int i = 0; i < ourMaxReaders; i++) {
+        while (old == mySlots[i].hazard.load()) {
+            std::this_thread::yield();
+        }
+    }
+    delete old;
+
+    TRACE_VLOG(1) << "Method Exit :  Concurrent_library::update";
+}
+
+// makeVersion
+template<typename C>
+C* Concurrent_library<C>::makeVersion(const C& container) {
+    C* const version = new(std::nothrow) C(container);
+    if (0 == version) {
+        LOG(FATAL) << "Concurrent_library::makeVersion - call to new failed!";
+        return 0;  // unreachable
+    }
+    return version;
+}
+
+#endif  // MEDIAMANAGER_MANAGER_CONCURRENT_LIBRARY_H_
@@ -0,0 +1,314 @@
+#ifndef MEDIAMANAGER_MANAGER_COPY_ON_WRITE_H_
+#define MEDIAMANAGER_MANAGER_COPY_ON_WRITE_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <atomic>  // NOLINT(build/include_order)
+#include <new>
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Copy_on_write.h
+ * @brief Declaration and definition of Copy_on_write class template.
+ */
+
+
+/**
+ * @class Copy_on_write Copy_on_write.h manager/Copy_on_write.h
+ *
+ * @brief A container whose copies share it until one of them changes it.
+ *
+ * @details The rA command backs up the Library and Catalog before restoring,
+ * so that a bad file can be rolled back; copying the Ordered_lists takes
+ * O(n) time and doubles the memory in use.  Held in a Copy_on_write, the
+ * backup is a copy of the handle, which takes O(1) time: both share one
+ * reference counted container (the body), and get_writable() gives the
+ * handle a copy of its own only if the body is still shared.  clear() on a
+ * shared handle does not copy either; it switches the handle to an empty
+ * body, so the restore that follows fills a new container while the backup
+ * keeps the old one.  Rolling back is then a swap with the backup.
+ * @verbatim
+   // library is a Copy_on_write<Ordered_list<Record*> > too
+   Copy_on_write<Ordered_list<Record*> > backup(library);
+   library.clear();
+   ... restore into library.get_writable() ...
+   if the file is bad
+       delete the Records in library.get(), then library.swap(backup)
+   else
+       delete the Records in backup.get()
+   @endverbatim
+ * Only the container is copied; the objects its items point to, such as
+ * Records, are shared as before.
+ *
+ * A copy can also be handed to another thread as a consistent view: the
+ * reference counts are atomic, so handles sharing a body can be used from
+ * different threads, and the body is not changed while it is shared.  One
+ * handle is not to be used from two threads at once.  The last handle to let
+ * go of a body destroys it, on whichever thread that is; Memory_stats
+ * counts the nodes of an Ordered_list correctly from any thread.
+ *
+ * Each handle also shares an empty body, copied from the container the
+ * first handle was constructed with, so that clear() need not know how to
+ * make an empty C with the same ordering.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename C>
+class Copy_on_write {
+  public:
+    /**
+     * Constructor for a handle to an empty container.
+     *
+     * @pre  empty has no items.
+     * @post Handle refers to a copy of empty.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param empty An empty container, e.g. an Ordered_list with its
+     *              ordering function
+     */
+    explicit Copy_on_write(const C& empty = C());
+
+    /**
+     * Copy constructor that shares the other handle's container.
+     *
+     * @pre  None.
+     * @post Both handles refer to the same container.
+     */
+    Copy_on_write(const Copy_on_write& other);
+
+    /**
+     * Assignment operator that shares the other handle's container.
+     *
+     * @pre  None.
+     * @post Both handles refer to the same container.
+     */
+    Copy_on_write& operator=(const Copy_on_write& rhs);
+
+    /**
+     * Lets go of the container, destroying it if no other handle refers to
+     * it.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Copy_on_write();
+
+    /**
+     * @return the container, for reading
+     */
+    const C& get() const {
+        return myBody->container;
+    }
+
+    /**
+     * Get the container for changing, first copying it if another handle
+     * refers to it.
+     *
+     * @pre  None.
+     * @post No other handle refers to the container.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @return the container, valid until the handle is next copied,
+     *         assigned, cleared or swapped
+     */
+    C* get_writable();
+
+    /**
+     * Empty the container.  If another handle refers to it, it is left
+     * alone and this handle is given an empty one instead.
+     *
+     * @pre  None.
+     * @post Container is empty.
+     */
+    void clear();
+
+    /**
+     * @return true if get_writable() would copy the container: another
+     *         handle refers to it, or it is the empty one
+     */
+    bool is_shared() const {
+        return 1 != myBody->references.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Interchange the containers of two handles, without copying either.
+     *
+     * @param other Handle to swap with
+     */
+    void swap(Copy_on_write& other);  // NOLINT(build/include_what_you_use)
+
+  private:
+    /**
+     * A container and the number of handles referring to it.
+     */
+    struct Body {
+        explicit Body(const C& in_container)
+          : references(1),
+            container(in_container) {
+        }
+
+        std::atomic<int> references;
+
+        C container;
+    };
+
+    /**
+     * @return a new body holding a copy of container
+     */
+    static Body* makeBody(const C& container);
+
+    /**
+     * Refer to body once more.
+     */
+    static Body* share(Body* const body);
+
+    /**
+     * Refer to body once less, destroying it after the last.
+     */
+    static void release(Body* const body);
+
+    /**
+     * The container.
+     */
+    Body* myBody;
+
+    /**
+     * An empty container, never changed, given to a shared handle by
+     * clear().
+     */
+    Body* myEmpty;
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// constructor
+template<typename C>
+Copy_on_write<C>::Copy_on_write(const C& empty)
+          : myBody(0),
+            myEmpty(makeBody(empty)) {
+    TRACE_VLOG(1) << "Method Entry:  Copy_on_write::Copy_on_write";
+
+    // the first change makes a container of the handle's own
+    myBody = share(myEmpty);
+
+    TRACE_VLOG(1) << "Method Exit :  Copy_on_write::Copy_on_write";
+}
+
+// copy constructor
+template<typename C>
+Copy_on_write<C>::Copy_on_write(const Copy_on_write& other)
+          : myBody(share(other.myBody)),
+            myEmpty(share(other.myEmpty)) {
+    TRACE_VLOG(1) << "Method Entry:  Copy_on_write::Copy_on_write(const "
+                     "Copy_on_write&)";
+    TRACE_VLOG(1) << "Method Exit :  Copy_on_write::Copy_on_write(const "
+                     "Copy_on_write&)";
+}
+
+// operator=
+template<typename C>
+Copy_on_write<C>& Copy_on_write<C>::operator=(const Copy_on_write& rhs) {
+    TRACE_VLOG(1) << "Method Entry:  Copy_on_write::operator=";
+
+    Copy_on_write temp(rhs);
+    swap(temp);
+
+    TRACE_VLOG(1) << "Method Exit :  Copy_on_write::operator=";
+    return *this;
+}
+
+// destructor
+template<typename C>
+Copy_on_write<C>::~Copy_on_write() {
+    TRACE_VLOG(1) << "Method Entry:  Copy_on_write::~Copy_on_write";
+
+    release(myBody);
+    release(myEmpty);
+
+    TRACE_VLOG(1) << "Method Exit :  Copy_on_write::~Copy_on_write";
+}
+
+// get_writable
+template<typename C>
+C* Copy_on_write<C>::get_writable() {
+    if (is_shared()) {
+        TRACE_VLOG(1) << "Copy_on_write::get_writable - copying the "
+                         "container";
+        Body* const body = makeBody(myBody->container);
+        release(myBody);
+        myBody = body;
+    }
+    return &myBody->container;
+}
+
+// clear
+template<typename C>
+void Copy_on_write<C>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Copy_on_write::clear";
+
+    if (is_shared()) {
+        release(myBody);
+        myBody = share(myEmpty);
+    } else {
+        myBody->container.clear();
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Copy_on_write::clear";
+}
+
+// swap
+template<typename C>
+void Copy_on_write<C>::swap(Copy_on_write& other) {
+    std::swap(myBody, other.myBody);
+    std::swap(myEmpty, other.myEmpty);
+}
+
+// makeBody
+template<typename C>
+typename Copy_on_write<C>::Body* Copy_on_write<C>::makeBody(
+        const C& container) {
+    Body* const body = new(std::nothrow) Body(container);
+    if (0 == body) {
+        LOG(FATAL) << "Copy_on_write::makeBody - call to new failed!";
+        return 0;  // unreachable
+    }
+    return body;
+}
+
+// share
+template<typename C>
+typename Copy_on_write<C>::Body* Copy_on_write<C>::share(Body* const body) {
+    body->references.fetch_add(1, std::memory_order_relaxed);
+    return body;
+}
+
+// release
+template<typename C>
+void Copy_on_write<C>::release(Body* const body) {
+    // the last handle to let go sees every other handle's use of the body
+    // before destroying it
+    if (1 == body->references.fetch_sub(1, std::memory_order_acq_rel)) {
+        delete body;
+    }
+}
+
+#endif  // MEDIAMANAGER_MANAGER_COPY_ON_WRITE_H_
@@ -0,0 +1,484 @@
+#ifndef MEDIAMANAGER_MANAGER_ID_INDEX_H_
+#define MEDIAMANAGER_MANAGER_ID_INDEX_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Id_index.h
+ * @brief Declaration and definition of Id_index class template.
+ */
+
+
+/**
+ * @class Id_index Id_index.h manager/Id_index.h
+ *
+ * @brief Hash index from ID number to object, e.g. from Record ID to Record.
+ *
+ * @details Finds an object by its ID in constant expected time, in place of
+ * scanning a second list kept in ID order.  The index holds pointers and does
+ * not own the objects; each object's ID is obtained from its get_ID() member
+ * function and must not change while the object is in the index.
+ *
+ * The table is a single array of (ID, pointer) slots using open addressing
+ * with linear probing, so a lookup usually touches one cache line.  IDs are
+ * spread over the table with Fibonacci hashing.  The table doubles once it is
+ * three quarters full.  Erasing shifts later entries of the probe run back
+ * instead of leaving tombstones, so lookups never slow down after many
+ * erases.
+ *
+ * apply_in_id_order() sorts the entries only when called, for printing a
+ * listing in ID order.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename T>
+class Id_index {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * Number of slots in the table when the first object is added.
+     */
+    static const int ourMinCapacity = 16;
+
+    /**
+     * Constructor that initializes an empty index; no table is allocated
+     * until the first object is added.
+     *
+     * @pre  None.
+     * @post Index is empty.
+     */
+    Id_index();
+
+    /**
+     * Deallocates the table.  The objects are not affected.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Id_index();
+
+    /**
+     * Add an object under its ID.
+     *
+     * @pre  None.
+     * @post object can be found by its ID.
+     *
+     * @warning If the table cannot grow, the program will LOG and terminate.
+     *
+     * @param object Object to add
+     *
+     * @return ERROR if object is NULL or an object with the same ID is already
+     *         in the index, otherwise OK
+     */
+    Status insert(T* const object);
+
+    /**
+     * @pre  None.
+     * @post Index remains unchanged.
+     *
+     * @param id ID to look up
+     *
+     * @return the object with the given ID, or NULL if there is none
+     */
+    T* find(const int id) const;
+
+    /**
+     * Remove the object with the given ID.
+     *
+     * @pre  None.
+     * @post No object can be found by id.
+     *
+     * @param id ID of the object to remove
+     *
+     * @return ERROR if there is no object with that ID, otherwise OK
+     */
+    Status erase(const int id);
+
+    /**
+     * Remove every object.  The table is kept for reuse.
+     *
+     * @pre  None.
+     * @post Index is empty.
+     */
+    void clear();
+
+    /**
+     * Make room for at least count objects without growing again.
+     *
+     * @pre  None.
+     * @post Index holds the same objects.
+     *
+     * @warning If the table cannot grow, the program will LOG and terminate.
+     *
+     * @param count Number of objects to make room for
+     */
+    void reserve(const int count);
+
+    /**
+     * @return the number of objects in the index
+     */
+    int size() const {
+        return mySize;
+    }
+
+    /**
+     * @return true if the index is empty
+     */
+    bool empty() const {
+        return 0 == mySize;
+    }
+
+    /**
+     * Call function with each object, in increasing order of ID.  The entries
+     * are sorted on each call, so this takes O(n log n) time.
+     *
+     * @pre  function does not change the index.
+     * @post Index remains unchanged.
+     *
+     * @warning If the temporary array cannot be allocated, the program will
+     *          LOG and terminate.
+     *
+     * @param function Function taking a T* (or const T*)
+     */
+    template<typename Function>
+    void apply_in_id_order(Function function) const;
+
+    /**
+     * Interchange the contents of this index with another one.
+     *
+     * @pre  None.
+     * @post Member variables of two indexes are swapped.
+     *
+     * @param other Index to swap with
+     */
+    void swap(Id_index& other);  // NOLINT(build/include_what_you_use)
+
+  private:
+    /**
+     * One entry of the table; empty when myObject is NULL.
+     */
+    struct Slot {
+        /** ID of the object, kept to avoid a pointer chase when probing. */
+        int myId;
+
+        /** The object, or NULL if the slot is empty. */
+        T* myObject;
+    };
+
+    /**
+     * @param id ID to hash
+     *
+     * @return the slot where the probe run for id starts
+     */
+    int homeSlot(const int id) const;
+
+    /**
+     * @param id ID to look up
+     *
+     * @return the slot holding id, or the empty slot ending its probe run
+     */
+    int findSlot(const int id) const;
+
+    /**
+     * Rehash every entry into a new table of the given size.
+     *
+     * @pre  capacity is a power of two large enough for the entries.
+     * @post Index holds the same objects.
+     *
+     * @param capacity Number of slots in the new table
+     */
+    void rehash(const int capacity);
+
+    /**
+     * Slots of the table, or NULL before the first insert.
+     */
+    Slot* mySlots;
+
+    /**
+     * Number of slots (always a power of two, or zero).
+     */
+    int myCapacity;
+
+    /**
+     * log2 of myCapacity.
+     */
+    int myCapacityBits;
+
+    /**
+     * Number of objects in the index.
+     */
+    int mySize;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Id_index);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename T>
+const int Id_index<T>::ourMinCapacity;
+
+// constructor
+template<typename T>
+Id_index<T>::Id_index()
+          : mySlots(0),
+            myCapacity(0),
+            myCapacityBits(0),
+            mySize(0) {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::Id_index";
+    TRACE_VLOG(1) << "Method Exit :  Id_index::Id_index";
+}
+
+// destructor
+template<typename T>
+Id_index<T>::~Id_index() {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::~Id_index";
+
+    delete [] mySlots;
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::~Id_index";
+}
+
+// insert
+template<typename T>
+typename Id_index<T>::Status Id_index<T>::insert(T* const object) {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::insert";
+
+    if (0 == object) {
+        LOG(ERROR) << "Id_index::insert - object is NULL!";
+
+        TRACE_VLOG(1) << "Method Exit :  Id_index::insert";
+        return ERROR;
+    }
+
+    const int id = object->get_ID();
+    TRACE_VLOG(2) << "Called with arguments\tid = ->" << id << "<-";
+
+    // keep the table at most three quarters full
+    reserve(mySize + 1);
+
+    const int slot = findSlot(id);
+    if (0 != mySlots[slot].myObject) {
+        LOG(ERROR) << "Id_index::insert - ID " << id << " already present!";
+
+        TRACE_VLOG(1) << "Method Exit :  Id_index::insert";
+        return ERROR;
+    }
+
+    mySlots[slot].myId = id;
+    mySlots[slot].myObject = object;
+    mySize++;
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::insert";
+    return OK;
+}
+
+// find
+template<typename T>
+T* Id_index<T>::find(const int id) const {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::find";
+    TRACE_VLOG(2) << "Called with arguments\tid = ->" << id << "<-";
+
+    T* const object = (0 == myCapacity) ? 0 : mySlots[findSlot(id)].myObject;
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::find";
+    return object;
+}
+
+// erase
+template<typename T>
+typename Id_index<T>::Status Id_index<T>::erase(const int id) {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::erase";
+    TRACE_VLOG(2) << "Called with arguments\tid = ->" << id << "<-";
+
+    if (0 == myCapacity) {
+        TRACE_VLOG(1) << "Method Exit :  Id_index::erase";
+        return ERROR;
+    }
+
+    int hole = findSlot(id);
+    if (0 == mySlots[hole].myObject) {
+        TRACE_VLOG(1) << "Method Exit :  Id_index::erase";
+        return ERROR;
+    }
+
+    // Walk the rest of the probe run.  An entry can move back into the hole
+    // unless its home slot lies cyclically after the hole (it would then be
+    // before its home, where a lookup never looks).
+    const int mask = myCapacity - 1;
+    for (int next = (hole + 1) & mask;
+         0 != mySlots[next].myObject;
+         next = (next + 1) & mask) {
+        const int home = homeSlot(mySlots[next].myId);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            mySlots[hole] = mySlots[next];
+            hole = next;
+        }
+    }
+
+    mySlots[hole].myObject = 0;
+    mySize--;
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::erase";
+    return OK;
+}
+
+// clear
+template<typename T>
+void Id_index<T>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::clear";
+
+    for (int i = 0; i < myCapacity; i++) {
+        mySlots[i].myObject = 0;
+    }
+    mySize = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::clear";
+}
+
+// reserve
+template<typename T>
+void Id_index<T>::reserve(const int count) {
+    // the table may be at most three quarters full
+    if (4 * count <= 3 * myCapacity) {
+        return;
+    }
+
+    TRACE_VLOG(1) << "Method Entry:  Id_index::reserve";
+    TRACE_VLOG(2) << "Called with arguments\tcount = ->" << count << "<-";
+
+    int capacity = std::max(static_cast<int>(ourMinCapacity), myCapacity);
+    while (4 * count > 3 * capacity) {
+        capacity *= 2;
+    }
+    rehash(capacity);
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::reserve";
+}
+
+// apply_in_id_order
+template<typename T>
+template<typename Function>
+void Id_index<T>::apply_in_id_order(Function function) const {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::apply_in_id_order";
+
+    Slot* const sorted = new(std::nothrow) Slot[static_cast<size_t>(mySize)];
+    if (0 == sorted) {
+        LOG(FATAL) << "Id_index::apply_in_id_order - call to new[] failed!";
+        return;  // unreachable
+    }
+
+    int count = 0;
+    for (int i = 0; i < myCapacity; i++) {
+        if (0 != mySlots[i].myObject) {
+            sorted[count++] = mySlots[i];
+        }
+    }
+    std::sort(sorted, sorted + count, [](const Slot& a, const Slot& b) {
+        return a.myId < b.myId;
+    });
+
+    for (int i = 0; i < count; i++) {
+        function(sorted[i].myObject);
+    }
+
+    delete [] sorted;
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::apply_in_id_order";
+}
+
+// swap
+template<typename T>
+void Id_index<T>::swap(Id_index& other) {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::swap";
+
+    std::swap(mySlots,        other.mySlots);
+    std::swap(myCapacity,     other.myCapacity);
+    std::swap(myCapacityBits, other.myCapacityBits);
+    std::swap(mySize,         other.mySize);
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::swap";
+}
+
+// homeSlot
+template<typename T>
+int Id_index<T>::homeSlot(const int id) const {
+    // Fibonacci hashing: the top bits of id * 2^32 / golden ratio; IDs
+    // handed out in sequence land far apart
+    const unsigned int product = static_cast<unsigned int>(id) * 2654435769U;
+    return static_cast<int>(product >> (32 - myCapacityBits));
+}
+
+// findSlot
+template<typename T>
+int Id_index<T>::findSlot(const int id) const {
+    const int mask = myCapacity - 1;
+    int slot = homeSlot(id);
+    while ((0 != mySlots[slot].myObject) && (id != mySlots[slot].myId)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// rehash
+template<typename T>
+void Id_index<T>::rehash(const int capacity) {
+    TRACE_VLOG(1) << "Method Entry:  Id_index::rehash";
+    TRACE_VLOG(2) << "Called with arguments\tcapacity = ->" << capacity
+                  << "<-";
+
+    Slot* const slots = new(std::nothrow) Slot[static_cast<size_t>(capacity)];
+    if (0 == slots) {
+        LOG(FATAL) << "Id_index::rehash - call to new[] failed!";
+        return;  // unreachable
+    }
+    for (int i = 0; i < capacity; i++) {
+        slots[i].myObject = 0;
+    }
+
+    Slot* const oldSlots = mySlots;
+    const int oldCapacity = myCapacity;
+
+    mySlots = slots;
+    myCapacity = capacity;
+    myCapacityBits = 0;
+    while ((1 << myCapacityBits) < capacity) {
+        myCapacityBits++;
+    }
+
+    for (int i = 0; i < oldCapacity; i++) {
+        if (0 != oldSlots[i].myObject) {
+            mySlots[findSlot(oldSlots[i].myId)] = oldSlots[i];
+        }
+    }
+    delete [] oldSlots;
+
+    TRACE_VLOG(1) << "Method Exit :  Id_index::rehash";
+}
+
+#endif  // MEDIAMANAGER_MANAGER_ID_INDEX_H_
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/InternedString.h"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+  using std::nothrow;
+
+#include "glog/logging.h"
+
+#include "manager/String.h"
+#include "manager/Utility.h"
+
+
+// initialize static members
+InternedString::Entry** InternedString::ourBuckets     = 0;
+int                     InternedString::ourBucketCount = 0;
+int                     InternedString::ourPoolSize    = 0;
+int                     InternedString::ourHitCount    = 0;
+int                     InternedString::ourMissCount   = 0;
+
+
+// FNV-1a hash of a C-string
+static unsigned int hashCStr(const char* const cstr) {
+    unsigned int hash = 2166136261U;
+    for (const char* ptr = cstr; '\0' != *ptr; ptr++) {
+        hash ^= static_cast<unsigned char>(*ptr);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+// constructor
+InternedString::InternedString()
+          : myEntry(0) {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::InternedString";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::InternedString";
+}
+
+// copy constructor
+InternedString::InternedString(const InternedString& other)
+          : myEntry(other.myEntry) {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::InternedString(const "
+                  << "InternedString&)";
+    TRACE_VLOG(2) << "Called with arguments\tother = ->" << other.c_str()
+                  << "<-";
+
+    if (0 != myEntry) {
+        myEntry->references++;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  InternedString::InternedString(const "
+                  << "InternedString&)";
+}
+
+// assignment
+InternedString& InternedString::operator=(const InternedString& other) {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::operator=";
+    TRACE_VLOG(2) << "Called with arguments\tother = ->" << other.c_str()
+                  << "<-";
+
+    // take the new reference first so self-assignment is harmless
+    Entry* const entry = other.myEntry;
+    if (0 != entry) {
+        entry->references++;
+    }
+
+    release();
+    myEntry = entry;
+
+    TRACE_VLOG(1) << "Method Exit :  InternedString::operator=";
+    return *this;
+}
+
+// init
+String::Status InternedString::init(const char* const in_cstr) {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::init";
+
+    if (0 == in_cstr) {
+        LOG(ERROR) << "Cannot intern a NULL C-String";
+        return String::ERROR;
+    }
+
+    TRACE_VLOG(2) << "Called with arguments\tin_cstr = ->" << in_cstr << "<-";
+
+    release();
+
+    // the empty string is not pooled
+    if ('\0' == in_cstr[0]) {
+        TRACE_VLOG(1) << "Method Exit :  InternedString::init";
+        return String::OK;
+    }
+
+    const unsigned int hash = hashCStr(in_cstr);
+
+    // look for an existing entry
+    if (0 != ourBucketCount) {
+        const unsigned int mask = static_cast<unsigned int>(ourBucketCount - 1);
+        for (Entry* entry = ourBuckets[hash & mask];
+             0 != entry;
+             entry = entry->next) {
+            if ((hash == entry->hash) &&
+                (0 == strcmp(in_cstr, entry->text.c_str()))) {
+                entry->references++;
+                myEntry = entry;
+                ourHitCount++;
+
+                TRACE_VLOG(1) << "Method Exit :  InternedString::init";
+                return String::OK;
+            }
+        }
+    }
+
+    // not found - keep the load factor at or below one, then add it
+    if (ourPoolSize >= ourBucketCount) {
+        growPool();
+    }
+
+    Entry* const entry = new(nothrow) Entry;
+    if (0 == entry) {
+        LOG(FATAL) << "InternedString::init - call to new failed!";
+        return String::ERROR;  // unreachable
+    }
+
+    entry->text.init(in_cstr);
+    entry->hash = hash;
+    entry->references = 1;
+
+    const unsigned int mask = static_cast<unsigned int>(ourBucketCount - 1);
+    entry->next = ourBuckets[hash & mask];
+    ourBuckets[hash & mask] = entry;
+
+    myEntry = entry;
+    ourPoolSize++;
+    ourMissCount++;
+
+    TRACE_VLOG(1) << "Method Exit :  InternedString::init";
+    return String::OK;
+}
+
+// destructor
+InternedString::~InternedString() {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::~InternedString";
+
+    release();
+
+    TRACE_VLOG(1) << "Method Exit :  InternedString::~InternedString";
+}
+
+// release
+void InternedString::release() {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::release";
+
+    if ((0 != myEntry) && (0 == --myEntry->references)) {
+        // unlink the entry from its bucket
+        const unsigned int mask = static_cast<unsigned int>(ourBucketCount - 1);
+        Entry** link = &ourBuckets[myEntry->hash & mask];
+        while (*link != myEntry) {
+            link = &(*link)->next;
+        }
+        *link = myEntry->next;
+
+        delete myEntry;
+        ourPoolSize--;
+
+        // give the table back once the pool is empty
+        if (0 == ourPoolSize) {
+            delete [] ourBuckets;
+            ourBuckets = 0;
+            ourBucketCount = 0;
+        }
+    }
+
+    myEntry = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  InternedString::release";
+}
+
+// growPool
+void InternedString::growPool() {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::growPool";
+
+    const int bucketCount = (0 == ourBucketCount) ? 8 : 2 * ourBucketCount;
+    const size_t count = static_cast<size_t>(bucketCount);
+    Entry** const buckets = new(nothrow) Entry*[count];
+    if (0 == buckets) {
+        LOG(FATAL) << "InternedString::growPool - call to new[] failed!";
+        return;  // unreachable
+    }
+
+    for (int index = 0; index < bucketCount; index++) {
+        buckets[index] = 0;
+    }
+
+    // move every entry to its bucket in the new table
+    const unsigned int mask = static_cast<unsigned int>(bucketCount - 1);
+    for (int index = 0; index < ourBucketCount; index++) {
+        Entry* entry = ourBuckets[index];
+        while (0 != entry) {
+            Entry* const next = entry->next;
+            entry->next = buckets[entry->hash & mask];
+            buckets[entry->hash & mask] = entry;
+            entry = next;
+        }
+    }
+
+    delete [] ourBuckets;
+    ourBuckets = buckets;
+    ourBucketCount = bucketCount;
+
+    TRACE_VLOG(1) << "Method Exit :  InternedString::growPool";
+}
@@ -0,0 +1,267 @@
+#ifndef MEDIAMANAGER_MANAGER_INTERNEDSTRING_H_
+#define MEDIAMANAGER_MANAGER_INTERNEDSTRING_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "glog/logging.h"
+#include "manager/String.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file InternedString.h
+ * @brief Declaration of InternedString class.
+ */
+
+
+/**
+ * @class InternedString InternedString.h manager/InternedString.h
+ *
+ * @brief An immutable String shared through a pool of distinct values.
+ *
+ * @details All InternedString objects initialized with the same characters
+ * refer to one pooled String, so a value that repeats across many objects
+ * (such as the medium name of a Record) is stored only once, and two
+ * InternedStrings are equal exactly when they refer to the same pool entry -
+ * a pointer comparison.
+ *
+ * Pool entries are reference counted: copying an InternedString adds a
+ * reference, and the entry (with its String) is destroyed when the last
+ * InternedString referring to it goes away.  The pooled Strings are ordinary
+ * Strings, so they show up in String::get_number() and
+ * String::get_total_allocation().
+ *
+ * The empty string is never pooled; a default constructed InternedString and
+ * one initialized with "" are the same value.
+ *
+ * The pool is not thread-safe.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class InternedString {
+  public:
+    /**
+     * Constructor that initializes to the empty string.
+     *
+     * @pre  None.
+     * @post Object holds the empty string; the pool is unchanged.
+     */
+    InternedString();
+
+    /**
+     * Copy constructor - shares the pool entry of other.
+     *
+     * @pre  None.
+     * @post Both objects refer to the same pool entry.
+     *
+     * @param other InternedString to share with
+     */
+    InternedString(const InternedString& other);
+
+    /**
+     * Assignment - releases the current pool entry and shares the one of
+     * other.
+     *
+     * @pre  None.
+     * @post Both objects refer to the same pool entry.
+     *
+     * @param other InternedString to share with
+     *
+     * @return reference to this InternedString
+     */
+    InternedString& operator=(const InternedString& other);
+
+    /**
+     * Look up in_cstr in the pool, adding it if not already present, and
+     * refer to that entry.
+     *
+     * @pre  None.
+     * @post Object refers to the pool entry for in_cstr.
+     *
+     * @warning If the pool cannot grow, the program will LOG and terminate.
+     *
+     * @param in_cstr C-String to intern
+     *
+     * @return String::ERROR if in_cstr is NULL, otherwise String::OK
+     */
+    String::Status init(const char* const in_cstr);
+
+    /**
+     * Releases the reference on the pool entry.
+     *
+     * @pre  None.
+     * @post Object has been destroyed; the entry is removed from the pool if
+     *       this was the last reference to it.
+     */
+    ~InternedString();
+
+    /**
+     * @pre  None.
+     * @post Object remains unchanged.
+     *
+     * @return pointer to the pooled C-String
+     */
+    const char* c_str() const;
+
+    /**
+     * @pre  None.
+     * @post Object remains unchanged.
+     *
+     * @return size of the pooled C-String
+     */
+    int size() const;
+
+    /**
+     * Equality is identity of the pool entry.
+     *
+     * @param rhs InternedString to compare with
+     *
+     * @return true if both hold the same characters
+     */
+    bool operator==(const InternedString& rhs) const;
+
+    /**
+     * @param rhs InternedString to compare with
+     *
+     * @return true if the two hold different characters
+     */
+    bool operator!=(const InternedString& rhs) const;
+
+    /**
+     * @return the number of distinct strings in the pool
+     */
+    static int get_pool_size();
+
+    /**
+     * @return the number of init calls that found their string already pooled
+     */
+    static int get_hit_count();
+
+    /**
+     * @return the number of init calls that had to add their string to the
+     *         pool
+     */
+    static int get_miss_count();
+
+  private:
+    /**
+     * A pooled string, chained into its hash bucket.
+     */
+    struct Entry {
+        /** The pooled characters. */
+        String text;
+
+        /** Hash of text, kept to avoid recomputing when the table grows. */
+        unsigned int hash;
+
+        /** Number of InternedString objects referring to this entry. */
+        int references;
+
+        /** Next entry in the same bucket. */
+        Entry* next;
+    };
+
+    /**
+     * Drop this object's reference, destroying the entry if it was the last.
+     *
+     * @pre  None.
+     * @post Object no longer refers to a pool entry.
+     */
+    void release();
+
+    /**
+     * Double the number of hash buckets and rehash the entries.
+     *
+     * @pre  None.
+     * @post Every entry is chained in its bucket for the new table size.
+     */
+    static void growPool();
+
+    /**
+     * The pool entry, or NULL for the empty string.
+     */
+    Entry* myEntry;
+
+    /**
+     * Hash buckets of the pool.
+     */
+    static Entry** ourBuckets;
+
+    /**
+     * Number of hash buckets (always a power of two, or zero).
+     */
+    static int ourBucketCount;
+
+    /**
+     * Number of entries in the pool.
+     */
+    static int ourPoolSize;
+
+    /**
+     * Counts the init calls that found an existing entry.
+     */
+    static int ourHitCount;
+
+    /**
+     * Counts the init calls that created an entry.
+     */
+    static int ourMissCount;
+};
+
+
+////////////////////////
+//  INLINE FUNCTIONS  //
+////////////////////////
+
+
+inline const char* InternedString::c_str() const {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::c_str";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::c_str";
+    return (0 == myEntry) ? "" : myEntry->text.c_str();
+}
+
+inline int InternedString::size() const {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::size";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::size";
+    return (0 == myEntry) ? 0 : myEntry->text.size();
+}
+
+inline bool InternedString::operator==(const InternedString& rhs) const {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::operator==";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::operator==";
+    return myEntry == rhs.myEntry;
+}
+
+inline bool InternedString::operator!=(const InternedString& rhs) const {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::operator!=";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::operator!=";
+    return myEntry != rhs.myEntry;
+}
+
+inline int InternedString::get_pool_size() {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::get_pool_size";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::get_pool_size";
+    return ourPoolSize;
+}
+
+inline int InternedString::get_hit_count() {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::get_hit_count";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::get_hit_count";
+    return ourHitCount;
+}
+
+inline int InternedString::get_miss_count() {
+    TRACE_VLOG(1) << "Method Entry:  InternedString::get_miss_count";
+    TRACE_VLOG(1) << "Method Exit :  InternedString::get_miss_count";
+    return ourMissCount;
+}
+
+
+#endif  // MEDIAMANAGER_MANAGER_INTERNEDSTRING_H_
@@ -0,0 +1,640 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/Journal.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>  // NOLINT(build/include_order)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+  using std::nothrow;
+#include <sstream>
+#include <string>
+
+#include "glog/logging.h"
+
+#include "manager/Mapped_file.h"
+#include "manager/Snapshot.h"
+#include "manager/String.h"
+#include "manager/Utility.h"
+
+
+// initialize static members
+const size_t Journal::ourMinCompactionSize;
+
+// the most pieces an entry is written in
+static const int maxPieces = 5;
+
+// long enough for the header, or for a number and the text around it
+typedef char Line_buffer[64];
+
+
+////////////////////////
+//  FILE HELPERS      //
+////////////////////////
+
+
+// 64-bit FNV-1a hash of the contents of a snapshot
+static uint64_t hash(const char* const data, const size_t size) {
+    uint64_t value = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+// write the first line of a journal following a snapshot of the given size
+// and hash, returning its length
+static int formatHeader(const size_t size,
+                        const uint64_t value,
+                        Line_buffer* const header) {
+    return snprintf(*header, sizeof(*header), "MMJ 1 %lu %016llx\n",
+                    static_cast<unsigned long>(size),  // NOLINT(runtime/int)
+                    static_cast<unsigned long long>(value));  // NOLINT
+}
+
+// whether a file exists, logging any other reason it cannot be checked
+static bool exists(const char* const path, bool* const found) {
+    if (0 == access(path, F_OK)) {
+        *found = true;
+        return true;
+    }
+    *found = false;
+    if (ENOENT != errno) {
+        PLOG(ERROR) << "Journal - cannot access " << path;
+        return false;
+    }
+    return true;
+}
+
+// flush the directory holding path to the disk, so that a rename in it
+// survives a system crash
+static bool syncDirectory(const String& path) {
+    const std::string file(path.c_str());
+    const std::string::size_type slash = file.rfind('/');
+    const std::string directory =
+        (std::string::npos == slash) ? std::string(".") :
+        (0 == slash) ? std::string("/") : file.substr(0, slash);
+
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (-1 == fd) {
+        PLOG(ERROR) << "Journal - cannot open " << directory;
+        return false;
+    }
+    if (0 != fsync(fd)) {
+        PLOG(ERROR) << "Journal - cannot flush " << directory;
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+    return true;
+}
+
+// replace the file at path with the given contents, flushed to the disk
+// before it takes the old file's name, and the rename flushed after
+static bool replaceFile(const String& path,
+                        const char* const data,
+                        const size_t size) {
+    String temporary;
+    temporary.init(path.c_str());
+    temporary.append(".tmp", 4);
+
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                          0644);
+    if (-1 == fd) {
+        PLOG(ERROR) << "Journal - cannot create " << temporary.c_str();
+        return false;
+    }
+    size_t written = 0;
+    while (written < size) {
+        const ssize_t count = write(fd, data + written, size - written);
+        if (-1 == count) {
+            if (EINTR == errno) {
+                continue;
+            }
+            break;
+        }
+        written += static_cast<size_t>(count);
+    }
+    if ((written < size) || (0 != fsync(fd))) {
+        PLOG(ERROR) << "Journal - cannot write " << temporary.c_str();
+        ::close(fd);
+        unlink(temporary.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    if (0 != rename(temporary.c_str(), path.c_str())) {
+        PLOG(ERROR) << "Journal - cannot rename " << temporary.c_str();
+        unlink(temporary.c_str());
+        return false;
+    }
+    return syncDirectory(path);
+}
+
+// whether s can be written as a field of an entry: not empty, and without
+// blanks if it must be a single word, or newlines if it is the rest of the
+// line
+static bool isField(const char* const s, const bool word) {
+    if ((0 == s) || ('\0' == *s)) {
+        return false;
+    }
+    for (const char* c = s; '\0' != *c; c++) {
+        if (word ? (0 != isspace(static_cast<unsigned char>(*c)))
+                 : ('\n' == *c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+////////////////////////
+//  PARSING HELPERS   //
+////////////////////////
+
+
+// the next word of a line being split, terminated in place; *position is
+// left after the blank that ends it, or at the end of the line
+static char* nextWord(char** const position) {
+    char* const word = *position;
+    char* end = word;
+    while (('\0' != *end) && (' ' != *end)) {
+        end++;
+    }
+    *position = ('\0' == *end) ? end : end + 1;
+    *end = '\0';
+    return word;
+}
+
+// parse a whole word as a number from min through max
+static bool parseNumber(const char* const word,
+                        const int min,
+                        const int max,
+                        int* const value) {
+    if (!isdigit(static_cast<unsigned char>(*word))) {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    const long number = strtol(word, &end, 10);  // NOLINT(runtime/int)
+    if ((0 != errno) || ('\0' != *end) || (number < min) || (number > max)) {
+        return false;
+    }
+    *value = static_cast<int>(number);
+    return true;
+}
+
+static bool parseID(char** const position, int* const ID) {
+    return parseNumber(nextWord(position), 1, 0x7FFFFFFF, ID);
+}
+
+static bool parseRating(char** const position, int* const rating) {
+    return parseNumber(nextWord(position), 0, Snapshot::ourMaxRating, rating);
+}
+
+static bool parseName(char** const position, const char** const name) {
+    *name = nextWord(position);
+    return '\0' != **name;
+}
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// constructor
+Journal::Journal(const char* const snapshot_path,
+                 const char* const journal_path)
+          : mySnapshotSize(0),
+            mySnapshotHash(hash("", 0)),
+            myHeaderValid(false),
+            myEntriesBegin(0),
+            myEntriesEnd(0),
+            myFd(-1),
+            mySync(false),
+            myJournalSize(0),
+            myEntryCount(0),
+            myLine(0),
+            myLineCapacity(0) {
+    TRACE_VLOG(1) << "Method Entry:  Journal::Journal";
+    TRACE_VLOG(2) << "Called with arguments\tsnapshot_path = ->"
+                  << snapshot_path << "<-\tjournal_path = ->" << journal_path
+                  << "<-";
+
+    mySnapshotPath.init(snapshot_path);
+    myJournalPath.init(journal_path);
+
+    TRACE_VLOG(1) << "Method Exit :  Journal::Journal";
+}
+
+// destructor
+Journal::~Journal() {
+    TRACE_VLOG(1) << "Method Entry:  Journal::~Journal";
+
+    close();
+    delete [] myLine;
+
+    TRACE_VLOG(1) << "Method Exit :  Journal::~Journal";
+}
+
+// open
+Journal::Status Journal::open(Snapshot* const snapshot) {
+    TRACE_VLOG(1) << "Method Entry:  Journal::open";
+
+    close();
+    myMappedJournal.close();
+    myHeaderValid = false;
+    myEntriesBegin = 0;
+    myEntriesEnd = 0;
+    myEntryCount = 0;
+    snapshot->clear();
+
+    // a missing snapshot is an empty Library, as on the first run
+    bool found;
+    if (!exists(mySnapshotPath.c_str(), &found)) {
+        TRACE_VLOG(1) << "Method Exit :  Journal::open";
+        return ERROR;
+    }
+    if (found) {
+        Mapped_file file;
+        if ((Mapped_file::OK != file.open(mySnapshotPath.c_str())) ||
+            (Snapshot::OK != snapshot->restore_parallel(file.data(),
+                                                        file.size(), 1, 0))) {
+            LOG(ERROR) << "Journal::open - cannot restore "
+                       << mySnapshotPath.c_str();
+            TRACE_VLOG(1) << "Method Exit :  Journal::open";
+            return ERROR;
+        }
+        setSnapshot(file.data(), file.size());
+    } else {
+        setSnapshot("", 0);
+    }
+
+    if (!exists(myJournalPath.c_str(), &found)) {
+        TRACE_VLOG(1) << "Method Exit :  Journal::open";
+        return ERROR;
+    }
+    if (found) {
+        if (Mapped_file::OK != myMappedJournal.open(myJournalPath.c_str())) {
+            snapshot->clear();
+            TRACE_VLOG(1) << "Method Exit :  Journal::open";
+            return ERROR;
+        }
+        checkHeader();
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Journal::open";
+    return OK;
+}
+
+// close
+void Journal::close() {
+    TRACE_VLOG(1) << "Method Entry:  Journal::close";
+
+    if (-1 != myFd) {
+        ::close(myFd);
+        myFd = -1;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Journal::close";
+}
+
+// add_record
+Journal::Status Journal::add_record(const int ID,
+                                    const int rating,
+                                    const char* const medium,
+                                    const char* const title) {
+    if ((ID <= 0) || (rating < 0) || (rating > Snapshot::ourMaxRating) ||
+        !isField(medium, true) || !isField(title, false)) {
+        LOG(ERROR) << "Journal::add_record - invalid Record";
+        return ERROR;
+    }
+
+    Line_buffer prefix;
+    Line_buffer middle;
+    snprintf(prefix, sizeof(prefix), "ar %d ", ID);
+    snprintf(middle, sizeof(middle), " %d ", rating);
+    const char* const pieces[] = {prefix, medium, middle, title, "\n"};
+    return append(pieces, 5);
+}
+
+// delete_record
+Journal::Status Journal::delete_record(const int ID) {
+    if (ID <= 0) {
+        LOG(ERROR) << "Journal::delete_record - invalid ID " << ID;
+        return ERROR;
+    }
+
+    Line_buffer line;
+    snprintf(line, sizeof(line), "dr %d\n", ID);
+    const char* const pieces[] = {line};
+    return append(pieces, 1);
+}
+
+// modify_rating
+Journal::Status Journal::modify_rating(const int ID, const int rating) {
+    if ((ID <= 0) || (rating < 0) || (rating > Snapshot::ourMaxRating)) {
+        LOG(ERROR) << "Journal::modify_rating - invalid ID or rating";
+        return ERROR;
+    }
+
+    Line_buffer line;
+    snprintf(line, sizeof(line), "mr %d %d\n", ID, rating);
+    const char* const pieces[] = {line};
+    return append(pieces, 1);
+}
+
+// add_collection
+Journal::Status Journal::add_collection(const char* const name) {
+    if (!isField(name, true)) {
+        LOG(ERROR) << "Journal::add_collection - invalid name";
+        return ERROR;
+    }
+
+    const char* const pieces[] = {"ac ", name, "\n"};
+    return append(pieces, 3);
+}
+
+// delete_collection
+Journal::Status Journal::delete_collection(const char* const name) {
+    if (!isField(name, true)) {
+        LOG(ERROR) << "Journal::delete_collection - invalid name";
+        return ERROR;
+    }
+
+    const char* const pieces[] = {"dc ", name, "\n"};
+    return append(pieces, 3);
+}
+
+// add_member
+Journal::Status Journal::add_member(const char* const name, const int ID) {
+    if (!isField(name, true) || (ID <= 0)) {
+        LOG(ERROR) << "Journal::add_member - invalid name or ID";
+        return ERROR;
+    }
+
+    Line_buffer suffix;
+    snprintf(suffix, sizeof(suffix), " %d\n", ID);
+    const char* const pieces[] = {"am ", name, suffix};
+    return append(pieces, 3);
+}
+
+// delete_member
+Journal::Status Journal::delete_member(const char* const name, const int ID) {
+    if (!isField(name, true) || (ID <= 0)) {
+        LOG(ERROR) << "Journal::delete_member - invalid name or ID";
+        return ERROR;
+    }
+
+    Line_buffer suffix;
+    snprintf(suffix, sizeof(suffix), " %d\n", ID);
+    const char* const pieces[] = {"dm ", name, suffix};
+    return append(pieces, 3);
+}
+
+// needs_compaction
+bool Journal::needs_compaction() const {
+    return myJournalSize >= std::max(ourMinCompactionSize, mySnapshotSize);
+}
+
+// compact
+Journal::Status Journal::compact(const Snapshot& snapshot,
+                                 const Snapshot::Format format) {
+    TRACE_VLOG(1) << "Method Entry:  Journal::compact";
+    TRACE_VLOG(2) << "Called with arguments\tformat = ->" << format << "<-";
+
+    if (!is_open()) {
+        LOG(ERROR) << "Journal::compact - journal is not open";
+        TRACE_VLOG(1) << "Method Exit :  Journal::compact";
+        return ERROR;
+    }
+
+    std::stringstream file;
+    if (Snapshot::OK != snapshot.save(&file, format)) {
+        LOG(ERROR) << "Journal::compact - cannot save snapshot";
+        TRACE_VLOG(1) << "Method Exit :  Journal::compact";
+        return ERROR;
+    }
+    const std::string contents = file.str();
+
+    // the new snapshot goes first: until the journal is replaced as well,
+    // the old journal no longer follows it and is ignored, which is right,
+    // since every entry in it has been applied
+    if (!replaceFile(mySnapshotPath, contents.data(), contents.size())) {
+        TRACE_VLOG(1) << "Method Exit :  Journal::compact";
+        return ERROR;
+    }
+    setSnapshot(contents.data(), contents.size());
+    const Status status = writeHeader();
+
+    TRACE_VLOG(1) << "Method Exit :  Journal::compact";
+    return status;
+}
+
+// parseEntry
+Journal::Status Journal::parseEntry(char* const line, Entry* const entry) {
+    const size_t length = strlen(line);
+    char* position = line;
+    const char* const operation = nextWord(&position);
+    if (2 != strlen(operation)) {
+        return ERROR;
+    }
+    entry->ID = 0;
+    entry->rating = 0;
+    entry->medium = "";
+    entry->name = "";
+
+    bool valid;
+    if (0 == strcmp("ar", operation)) {
+        entry->operation = ADD_RECORD;
+        valid = parseID(&position, &entry->ID) &&
+                parseName(&position, &entry->medium) &&
+                parseRating(&position, &entry->rating);
+        // the title is the rest of the line
+        entry->name = position;
+        position += strlen(position);
+        valid = valid && ('\0' != *entry->name);
+    } else if (0 == strcmp("dr", operation)) {
+        entry->operation = DELETE_RECORD;
+        valid = parseID(&position, &entry->ID);
+    } else if (0 == strcmp("mr", operation)) {
+        entry->operation = MODIFY_RATING;
+        valid = parseID(&position, &entry->ID) &&
+                parseRating(&position, &entry->rating);
+    } else if (0 == strcmp("ac", operation)) {
+        entry->operation = ADD_COLLECTION;
+        valid = parseName(&position, &entry->name);
+    } else if (0 == strcmp("dc", operation)) {
+        entry->operation = DELETE_COLLECTION;
+        valid = parseName(&position, &entry->name);
+    } else if (0 == strcmp("am", operation)) {
+        entry->operation = ADD_MEMBER;
+        valid = parseName(&position, &entry->name) &&
+                parseID(&position, &entry->ID);
+    } else if (0 == strcmp("dm", operation)) {
+        entry->operation = DELETE_MEMBER;
+        valid = parseName(&position, &entry->name) &&
+                parseID(&position, &entry->ID);
+    } else {
+        valid = false;
+    }
+
+    // nothing may follow the last field, not even a blank, which nextWord()
+    // will have replaced; only a title can end in one
+    return (valid && ('\0' == *position) &&
+            ((ADD_RECORD == entry->operation) ||
+             ('\0' != line[length - 1]))) ? OK : ERROR;
+}
+
+// setSnapshot
+void Journal::setSnapshot(const char* const data, const size_t size) {
+    mySnapshotSize = size;
+    mySnapshotHash = hash(data, size);
+}
+
+// checkHeader
+void Journal::checkHeader() {
+    const char* const data = myMappedJournal.data();
+    const size_t size = myMappedJournal.size();
+
+    Line_buffer header;
+    const size_t length = static_cast<size_t>(
+        formatHeader(mySnapshotSize, mySnapshotHash, &header));
+    if ((size < length) || (0 != memcmp(header, data, length))) {
+        if (0 != size) {
+            LOG(WARNING) << "Journal - " << myJournalPath.c_str()
+                         << " does not follow " << mySnapshotPath.c_str()
+                         << " and is ignored";
+        }
+        return;
+    }
+
+    // a crash while appending can leave the last entry without its newline
+    size_t end = size;
+    while ((end > length) && ('\n' != data[end - 1])) {
+        end--;
+    }
+    if (end != size) {
+        LOG(WARNING) << "Journal - dropping the incomplete last entry of "
+                     << myJournalPath.c_str();
+    }
+
+    myHeaderValid = true;
+    myEntriesBegin = length;
+    myEntriesEnd = end;
+}
+
+// readEntry
+Journal::Status Journal::readEntry(const size_t offset,
+                                   const size_t length,
+                                   Entry* const entry) {
+    if (length >= myLineCapacity) {
+        const size_t capacity = std::max(2 * myLineCapacity, length + 1);
+        char* const line = new(nothrow) char[capacity];
+        if (0 == line) {
+            LOG(FATAL) << "Journal::readEntry - call to new[] failed!";
+            return ERROR;  // unreachable
+        }
+        delete [] myLine;
+        myLine = line;
+        myLineCapacity = capacity;
+    }
+
+    memcpy(myLine, myMappedJournal.data() + offset, length);
+    myLine[length] = '\0';
+    return parseEntry(myLine, entry);
+}
+
+// openForAppend
+Journal::Status Journal::openForAppend() {
+    const bool valid = myHeaderValid;
+    const size_t end = myEntriesEnd;
+    myMappedJournal.close();
+    myHeaderValid = false;
+
+    if (!valid) {
+        return writeHeader();
+    }
+
+    myFd = ::open(myJournalPath.c_str(), O_WRONLY | O_APPEND);
+    if (-1 == myFd) {
+        PLOG(ERROR) << "Journal - cannot open " << myJournalPath.c_str();
+        return ERROR;
+    }
+    if (0 != ftruncate(myFd, static_cast<off_t>(end))) {
+        PLOG(ERROR) << "Journal - cannot truncate " << myJournalPath.c_str();
+        close();
+        return ERROR;
+    }
+    myJournalSize = end;
+    return OK;
+}
+
+// append
+Journal::Status Journal::append(const char* const* const pieces,
+                                const int count) {
+    if (!is_open()) {
+        LOG(ERROR) << "Journal::append - journal is not open";
+        return ERROR;
+    }
+
+    struct iovec vector[maxPieces];
+    size_t length = 0;
+    for (int i = 0; i < count; i++) {
+        vector[i].iov_base = const_cast<char*>(pieces[i]);
+        vector[i].iov_len = strlen(pieces[i]);
+        length += vector[i].iov_len;
+    }
+
+    // a short write would leave part of an entry for the next one to be
+    // appended to, so it is cut off again
+    const ssize_t written = writev(myFd, vector, count);
+    if ((written < 0) || (length != static_cast<size_t>(written)) ||
+        (mySync && (0 != fdatasync(myFd)))) {
+        PLOG(ERROR) << "Journal - cannot append to " << myJournalPath.c_str();
+        if (0 != ftruncate(myFd, static_cast<off_t>(myJournalSize))) {
+            PLOG(ERROR) << "Journal - cannot truncate "
+                        << myJournalPath.c_str();
+        }
+        return ERROR;
+    }
+
+    myJournalSize += length;
+    myEntryCount++;
+    return OK;
+}
+
+// writeHeader
+Journal::Status Journal::writeHeader() {
+    close();
+
+    Line_buffer header;
+    const size_t length = static_cast<size_t>(
+        formatHeader(mySnapshotSize, mySnapshotHash, &header));
+    if (!replaceFile(myJournalPath, header, length)) {
+        return ERROR;
+    }
+
+    myFd = ::open(myJournalPath.c_str(), O_WRONLY | O_APPEND);
+    if (-1 == myFd) {
+        PLOG(ERROR) << "Journal - cannot open " << myJournalPath.c_str();
+        return ERROR;
+    }
+    myJournalSize = length;
+    myEntryCount = 0;
+    return OK;
+}
@@ -0,0 +1,403 @@
+#ifndef MEDIAMANAGER_MANAGER_JOURNAL_H_
+#define MEDIAMANAGER_MANAGER_JOURNAL_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstddef>
+#include <cstdint>  // NOLINT(build/include_order)
+#include <cstring>
+
+#include "glog/logging.h"
+#include "manager/Mapped_file.h"
+#include "manager/Snapshot.h"
+#include "manager/String.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Journal.h
+ * @brief Declaration of Journal class.
+ */
+
+
+/**
+ * @class Journal Journal.h manager/Journal.h
+ *
+ * @brief The durable state of the Library and Catalog, kept as a snapshot
+ * file plus an append-only journal of the changes made since it was written.
+ *
+ * @details Saving everything after every command costs I/O in proportion to
+ * the size of the data.  Instead, each command that changes the data appends
+ * one line to the journal, costing I/O in proportion to the change.  When
+ * the journal has grown as large as the snapshot, needs_compaction() says
+ * so, and compact() writes the current data as a new snapshot and starts an
+ * empty journal; since that takes at least as many commands as the snapshot
+ * has bytes, it adds only a constant amount of I/O per command.  Restoring
+ * reads the snapshot and replays the journal on top of it:
+ * @verbatim
+   Journal journal("library.mms", "library.mmj");
+   journal.open(&snapshot)          restore the snapshot
+   ... build the Library and Catalog from the snapshot ...
+   journal.replay(apply)            apply each change since, in order
+   ... then, as commands run ...
+   journal.modify_rating(ID, r)     etc.
+   if (journal.needs_compaction())
+       journal.compact(snapshot of the current data, format)
+   @endverbatim
+ *
+ * Each entry is one line, named for the command that makes the change:
+ * @verbatim
+   ar <ID> <medium> <rating> <title>     add Record
+   dr <ID>                               delete Record
+   mr <ID> <rating>                      modify rating
+   ac <name>                             add Collection
+   dc <name>                             delete Collection
+   am <name> <ID>                        add member
+   dm <name> <ID>                        delete member
+   @endverbatim
+ * The journal starts with a header line identifying the snapshot it follows by
+ * size and a 64-bit FNV-1a hash of its contents.  compact() replaces the
+ * snapshot and then the journal, each by writing a temporary file and renaming
+ * it over the old one, so a crash at any point leaves either the old pair or
+ * the new snapshot with a journal that no longer matches it, which open()
+ * ignores.  Each rename is flushed to the disk with its directory before the
+ * next begins; this ordering is what makes compaction crash-safe, since
+ * otherwise a system crash could keep the new journal and lose the new
+ * snapshot, discarding every entry since the old one.  An entry is appended
+ * with a single write, so it survives the program crashing as soon as the call
+ * returns; with set_sync(true) it is also flushed to the disk, surviving a
+ * system crash at the cost of a disk write per command.  A last entry left
+ * incomplete by a crash is dropped on replay.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Journal {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * The changes recorded, one per kind of entry.
+     */
+    enum Operation {ADD_RECORD,
+                    DELETE_RECORD,
+                    MODIFY_RATING,
+                    ADD_COLLECTION,
+                    DELETE_COLLECTION,
+                    ADD_MEMBER,
+                    DELETE_MEMBER};
+
+    /**
+     * A change read back by replay().  The strings are null-terminated and
+     * valid only during the call they are passed to.
+     */
+    struct Entry {
+        /** The change. */
+        Operation operation;
+
+        /** ID of the Record added, deleted, modified, or made a member. */
+        int ID;
+
+        /** Rating of the Record added or the new rating. */
+        int rating;
+
+        /** Medium of the Record added. */
+        const char* medium;
+
+        /** Title of the Record added, or name of the Collection. */
+        const char* name;
+    };
+
+    /**
+     * Smallest journal, in bytes, that needs_compaction() reports, so that a
+     * small Library is not rewritten every few commands.
+     */
+    static const size_t ourMinCompactionSize = 64 * 1024;
+
+    /**
+     * Constructor for a journal kept in the given files.  Nothing is read or
+     * written until open().
+     *
+     * @pre  None.
+     * @post is_open() is false.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param snapshot_path Name of the snapshot file
+     * @param journal_path  Name of the journal file
+     */
+    Journal(const char* const snapshot_path,
+            const char* const journal_path);
+
+    /**
+     * Closes the journal.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Journal();
+
+    /**
+     * Restore the snapshot file and check that the journal follows it.  A
+     * missing snapshot is an empty one, and a missing journal, or one left
+     * behind by an interrupted compact(), has no entries.
+     *
+     * @pre  None.
+     * @post snapshot holds the data of the snapshot file, or is empty on
+     *       ERROR.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param snapshot Snapshot to restore into
+     *
+     * @return ERROR if either file cannot be read or the snapshot is
+     *         invalid, otherwise OK
+     */
+    Status open(Snapshot* const snapshot);
+
+    /**
+     * Call apply with each entry of the journal, oldest first, then open the
+     * journal for appending.
+     *
+     * @pre  open() has returned OK.
+     * @post is_open() is true, unless ERROR is returned.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param apply Function taking a const Entry&, which makes the change
+     *              and returns false if it cannot be made
+     *
+     * @return ERROR if an entry is invalid, apply returns false, or the
+     *         journal cannot be opened, otherwise OK
+     */
+    template<typename Apply>
+    Status replay(Apply apply);
+
+    /**
+     * Close the journal.  Entries already appended are kept.
+     *
+     * @pre  None.
+     * @post is_open() is false.
+     */
+    void close();
+
+    /**
+     * @return true if entries can be appended
+     */
+    bool is_open() const {
+        return -1 != myFd;
+    }
+
+    /**
+     * Flush each entry to the disk before returning, or only hand it to the
+     * operating system (the default).
+     *
+     * @pre  None.
+     * @post Entries are appended as requested.
+     *
+     * @param sync true to flush every entry
+     */
+    void set_sync(const bool sync) {
+        mySync = sync;
+    }
+
+    /**
+     * Append an entry.  The medium and names must be single words, and the
+     * title a single line.
+     *
+     * @pre  is_open() is true.
+     * @post The entry is the last in the journal, unless ERROR is returned.
+     *
+     * @return ERROR if an argument cannot be written as part of an entry or
+     *         the write fails, otherwise OK
+     */
+    Status add_record(const int ID,
+                      const int rating,
+                      const char* const medium,
+                      const char* const title);
+    Status delete_record(const int ID);
+    Status modify_rating(const int ID, const int rating);
+    Status add_collection(const char* const name);
+    Status delete_collection(const char* const name);
+    Status add_member(const char* const name, const int ID);
+    Status delete_member(const char* const name, const int ID);
+
+    /**
+     * @return the number of entries since the snapshot
+     */
+    int get_entry_count() const {
+        return myEntryCount;
+    }
+
+    /**
+     * @return true if the journal has grown as large as the snapshot, and
+     *         at least ourMinCompactionSize, so should be compacted
+     */
+    bool needs_compaction() const;
+
+    /**
+     * Replace the snapshot file with snapshot, and the journal with an empty
+     * one following it.
+     *
+     * @pre  is_open() is true.
+     * @post The files hold snapshot and no entries.
+     *
+     * @param snapshot The current data, every entry applied
+     * @param format   Format to write the snapshot in
+     *
+     * @return ERROR if snapshot cannot be saved or either file cannot be
+     *         written, otherwise OK.  On ERROR the files are as they were,
+     *         or hold the new snapshot and an empty journal.
+     */
+    Status compact(const Snapshot& snapshot, const Snapshot::Format format);
+
+  private:
+    /**
+     * Split an entry line (without its newline) into entry, in place.
+     *
+     * @return ERROR if the line is not a valid entry, otherwise OK
+     */
+    static Status parseEntry(char* const line, Entry* const entry);
+
+    /**
+     * Note the size and hash of the snapshot contents.
+     */
+    void setSnapshot(const char* const data, const size_t size);
+
+    /**
+     * Check the header of the mapped journal against the snapshot and find
+     * the entries after it.
+     */
+    void checkHeader();
+
+    /**
+     * Copy the entry line at offset into myLine and split it.
+     *
+     * @return ERROR if the line is not a valid entry, otherwise OK
+     */
+    Status readEntry(const size_t offset,
+                     const size_t length,
+                     Entry* const entry);
+
+    /**
+     * Open the journal for appending after its last complete entry, or
+     * start a new one if it does not follow the snapshot.
+     */
+    Status openForAppend();
+
+    /**
+     * Append one complete entry of count pieces with a single write.
+     */
+    Status append(const char* const* const pieces, const int count);
+
+    /**
+     * Write an empty journal following the snapshot into myFd's file, in
+     * place of the old one.
+     */
+    Status writeHeader();
+
+    /**
+     * File names.
+     */
+    String mySnapshotPath;
+    String myJournalPath;
+
+    /**
+     * The journal, mapped by open() until replay() is done with it.
+     */
+    Mapped_file myMappedJournal;
+
+    /**
+     * Size and hash of the snapshot the journal follows.
+     */
+    size_t   mySnapshotSize;
+    uint64_t mySnapshotHash;
+
+    /**
+     * Whether the mapped journal follows the snapshot, and where its entries
+     * start and its complete entries end.
+     */
+    bool   myHeaderValid;
+    size_t myEntriesBegin;
+    size_t myEntriesEnd;
+
+    /**
+     * Descriptor of the journal open for appending, or -1.
+     */
+    int  myFd;
+    bool mySync;
+
+    /**
+     * Size of the journal, and the number of entries in it.
+     */
+    size_t myJournalSize;
+    int    myEntryCount;
+
+    /**
+     * Copy of the entry being replayed, split into fields.
+     */
+    char*  myLine;
+    size_t myLineCapacity;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Journal);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// replay
+template<typename Apply>
+Journal::Status Journal::replay(Apply apply) {
+    TRACE_VLOG(1) << "Method Entry:  Journal::replay";
+
+    const char* const data = myMappedJournal.data();
+    myEntryCount = 0;
+    for (size_t offset = myEntriesBegin; offset < myEntriesEnd; ) {
+        const char* const line = data + offset;
+        const size_t length = static_cast<size_t>(
+            static_cast<const char*>(
+                memchr(line, '\n', myEntriesEnd - offset)) - line);
+
+        Entry entry;
+        if (OK != readEntry(offset, length, &entry)) {
+            LOG(ERROR) << "Journal::replay - invalid entry "
+                       << myEntryCount + 1 << " in " << myJournalPath.c_str();
+            TRACE_VLOG(1) << "Method Exit :  Journal::replay";
+            return ERROR;
+        }
+        if (!apply(entry)) {
+            LOG(ERROR) << "Journal::replay - entry " << myEntryCount + 1
+                       << " in " << myJournalPath.c_str()
+                       << " cannot be applied";
+            TRACE_VLOG(1) << "Method Exit :  Journal::replay";
+            return ERROR;
+        }
+        myEntryCount++;
+        offset += length + 1;
+    }
+
+    const Status status = openForAppend();
+
+    TRACE_VLOG(1) << "Method Exit :  Journal::replay";
+    return status;
+}
+
+#endif  // MEDIAMANAGER_MANAGER_JOURNAL_H_
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/Mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+#include "glog/logging.h"
+
+#include "manager/Utility.h"
+
+
+// constructor
+Mapped_file::Mapped_file()
+          : myData(0),
+            mySize(0),
+            myIsOpen(false) {
+    TRACE_VLOG(1) << "Method Entry:  Mapped_file::Mapped_file";
+    TRACE_VLOG(1) << "Method Exit :  Mapped_file::Mapped_file";
+}
+
+// destructor
+Mapped_file::~Mapped_file() {
+    TRACE_VLOG(1) << "Method Entry:  Mapped_file::~Mapped_file";
+
+    close();
+
+    TRACE_VLOG(1) << "Method Exit :  Mapped_file::~Mapped_file";
+}
+
+// open
+Mapped_file::Status Mapped_file::open(const char* const path) {
+    TRACE_VLOG(1) << "Method Entry:  Mapped_file::open";
+    TRACE_VLOG(2) << "Called with arguments\tpath = ->" << path << "<-";
+
+    close();
+
+    const int fd = ::open(path, O_RDONLY);
+    if (-1 == fd) {
+        PLOG(ERROR) << "Mapped_file::open - cannot open " << path;
+        TRACE_VLOG(1) << "Method Exit :  Mapped_file::open";
+        return ERROR;
+    }
+
+    struct stat status;
+    if (-1 == fstat(fd, &status)) {
+        PLOG(ERROR) << "Mapped_file::open - cannot stat " << path;
+        ::close(fd);
+        TRACE_VLOG(1) << "Method Exit :  Mapped_file::open";
+        return ERROR;
+    }
+
+    // there is nothing to map in an empty file
+    const size_t size = static_cast<size_t>(status.st_size);
+    if (0 != size) {
+        void* const data = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (MAP_FAILED == data) {
+            PLOG(ERROR) << "Mapped_file::open - cannot map " << path;
+            ::close(fd);
+            TRACE_VLOG(1) << "Method Exit :  Mapped_file::open";
+            return ERROR;
+        }
+        myData = static_cast<const char*>(data);
+    }
+
+    // the mapping does not need the descriptor
+    ::close(fd);
+    mySize = size;
+    myIsOpen = true;
+
+    TRACE_VLOG(1) << "Method Exit :  Mapped_file::open";
+    return OK;
+}
+
+// close
+void Mapped_file::close() {
+    TRACE_VLOG(1) << "Method Entry:  Mapped_file::close";
+
+    if (0 != myData) {
+        munmap(const_cast<char*>(myData), mySize);
+    }
+    myData = 0;
+    mySize = 0;
+    myIsOpen = false;
+
+    TRACE_VLOG(1) << "Method Exit :  Mapped_file::close";
+}
@@ -0,0 +1,127 @@
+#ifndef MEDIAMANAGER_MANAGER_MAPPED_FILE_H_
+#define MEDIAMANAGER_MANAGER_MAPPED_FILE_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstddef>
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Mapped_file.h
+ * @brief Declaration of Mapped_file class.
+ */
+
+
+/**
+ * @class Mapped_file Mapped_file.h manager/Mapped_file.h
+ *
+ * @brief A file mapped read-only into memory.
+ *
+ * @details The contents of the file are available through data() without
+ * being read or copied: pages are brought in by the operating system as they
+ * are touched, and since the mapping is shared and read-only, every process
+ * mapping the same file uses the same pages of the page cache.  The mapping
+ * stays valid until close() or destruction.  The file should not be modified
+ * while it is mapped.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Mapped_file {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * Constructor for an object with no file mapped.
+     *
+     * @pre  None.
+     * @post is_open() is false.
+     */
+    Mapped_file();
+
+    /**
+     * Unmaps the file, if one is mapped.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Mapped_file();
+
+    /**
+     * Map a file, unmapping any file mapped before.
+     *
+     * @pre  None.
+     * @post The contents of the file are at data(), or is_open() is false on
+     *       ERROR.
+     *
+     * @param path Name of the file
+     *
+     * @return ERROR if the file cannot be opened or mapped, otherwise OK
+     */
+    Status open(const char* const path);
+
+    /**
+     * Unmap the file.
+     *
+     * @pre  None.
+     * @post is_open() is false.
+     */
+    void close();
+
+    /**
+     * @return true if a file is mapped
+     */
+    bool is_open() const {
+        return myIsOpen;
+    }
+
+    /**
+     * @return the contents of the file, or NULL if the file is empty or none
+     *         is mapped
+     */
+    const char* data() const {
+        return myData;
+    }
+
+    /**
+     * @return the size of the file in bytes
+     */
+    size_t size() const {
+        return mySize;
+    }
+
+  private:
+    /**
+     * Start of the mapping.
+     */
+    const char* myData;
+
+    /**
+     * Length of the mapping.
+     */
+    size_t mySize;
+
+    /**
+     * Whether a file is mapped (an empty file has no mapping, but is open).
+     */
+    bool myIsOpen;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Mapped_file);
+};
+
+#endif  // MEDIAMANAGER_MANAGER_MAPPED_FILE_H_
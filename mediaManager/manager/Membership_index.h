@@ -0,0 +1,399 @@
+#ifndef MEDIAMANAGER_MANAGER_MEMBERSHIP_INDEX_H_
+#define MEDIAMANAGER_MANAGER_MEMBERSHIP_INDEX_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+#include "glog/logging.h"
+#include "manager/Id_index.h"
+#include "manager/Node_pool.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Membership_index.h
+ * @brief Declaration and definition of Membership_index class template.
+ */
+
+
+/**
+ * @class Membership_index Membership_index.h manager/Membership_index.h
+ *
+ * @brief Reverse index from a Record's ID to the Collections it is a member
+ * of.
+ *
+ * @details Without it, deleting a Record means asking every Collection in
+ * the Catalog whether the Record is a member, each a scan of its member
+ * list, which takes time proportional to the total number of members.
+ * Collection::add_member and Collection::remove_member are to keep this
+ * index up to date, add() and remove() each costing O(memberships of the
+ * Record), so that deleting a Record, through remove_record(), and listing the
+ * Collections that hold it, through apply_to_collections(), take time in
+ * proportion to the Record's own memberships.
+ *
+ * The entry for each Record with at least one membership is found through
+ * an Id_index and allocated from a Node_pool.  It holds the Collections in
+ * the order the Record was added to them, the first ourInlineCount in the
+ * entry itself, since most Records belong to only a few Collections; a
+ * Record with more gets an array that doubles as needed.  The index does not
+ * own the Collections.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename C>
+class Membership_index {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * Number of Collections an entry holds without allocating an array.
+     */
+    static const int ourInlineCount = 3;
+
+    /**
+     * Constructor that initializes an empty index.
+     *
+     * @pre  None.
+     * @post Index is empty.
+     */
+    Membership_index();
+
+    /**
+     * Deallocates the index.  The Collections are not affected.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Membership_index();
+
+    /**
+     * Note that a Record has become a member of a Collection.
+     *
+     * @pre  None.
+     * @post The Record is listed as a member of collection.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param record_ID  ID of the Record
+     * @param collection The Collection
+     *
+     * @return ERROR if the Record is already listed as a member of
+     *         collection, otherwise OK
+     */
+    Status add(const int record_ID, C* const collection);
+
+    /**
+     * Note that a Record is no longer a member of a Collection.
+     *
+     * @pre  None.
+     * @post The Record is not listed as a member of collection.
+     *
+     * @param record_ID  ID of the Record
+     * @param collection The Collection
+     *
+     * @return ERROR if the Record is not listed as a member of collection,
+     *         otherwise OK
+     */
+    Status remove(const int record_ID, C* const collection);
+
+    /**
+     * @param record_ID  ID of a Record
+     * @param collection A Collection
+     *
+     * @return true if the Record is listed as a member of collection
+     */
+    bool contains(const int record_ID, const C* const collection) const;
+
+    /**
+     * @param record_ID ID of a Record
+     *
+     * @return the number of Collections the Record is a member of
+     */
+    int get_count(const int record_ID) const;
+
+    /**
+     * Call function with each Collection a Record is a member of, in the
+     * order the Record was added to them.
+     *
+     * @pre  function does not change the index.
+     * @post Index remains unchanged.
+     *
+     * @param record_ID ID of the Record
+     * @param function  Function taking a C*
+     */
+    template<typename Function>
+    void apply_to_collections(const int record_ID, Function function) const;
+
+    /**
+     * Forget every membership of a Record, which is being deleted, calling
+     * function with each Collection it was a member of so that the Record
+     * can be removed from it.
+     *
+     * @pre  function does not change the index.
+     * @post The Record is listed as a member of no Collection.
+     *
+     * @param record_ID ID of the Record
+     * @param function  Function taking a C*
+     *
+     * @return the number of Collections the Record was a member of
+     */
+    template<typename Function>
+    int remove_record(const int record_ID, Function function);
+
+    /**
+     * Forget every membership.
+     *
+     * @pre  None.
+     * @post Index is empty.
+     */
+    void clear();
+
+    /**
+     * @return the number of Records that are members of any Collection
+     */
+    int size() const {
+        return myEntries.size();
+    }
+
+  private:
+    /**
+     * The Collections a Record is a member of.
+     */
+    struct Entry {
+        /** ID of the Record. */
+        int ID;
+
+        /** Number of Collections. */
+        int count;
+
+        /** Room in collections. */
+        int capacity;
+
+        /** The Collections; inlineCollections until it fills. */
+        C** collections;
+
+        C* inlineCollections[ourInlineCount];
+
+        int get_ID() const {
+            return ID;
+        }
+    };
+
+    /**
+     * Remove an entry from the index and give back its storage.
+     */
+    void destroyEntry(Entry* const entry);
+
+    /**
+     * Entries by Record ID.
+     */
+    Id_index<Entry> myEntries;
+
+    /**
+     * Storage for the entries.
+     */
+    Node_pool<Entry> myPool;
+
+    /**
+     * Number of entries with an array of their own.
+     */
+    int myArrayCount;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Membership_index);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename C>
+const int Membership_index<C>::ourInlineCount;
+
+// constructor
+template<typename C>
+Membership_index<C>::Membership_index()
+          : myArrayCount(0) {
+    TRACE_VLOG(1) << "Method Entry:  Membership_index::Membership_index";
+    TRACE_VLOG(1) << "Method Exit :  Membership_index::Membership_index";
+}
+
+// destructor
+template<typename C>
+Membership_index<C>::~Membership_index() {
+    TRACE_VLOG(1) << "Method Entry:  Membership_index::~Membership_index";
+
+    clear();
+
+    TRACE_VLOG(1) << "Method Exit :  Membership_index::~Membership_index";
+}
+
+// add
+template<typename C>
+typename Membership_index<C>::Status
+Membership_index<C>::add(const int record_ID, C* const collection) {
+    Entry* entry = myEntries.find(record_ID);
+    if (0 == entry) {
+        entry = new(myPool.allocate()) Entry;
+        entry->ID = record_ID;
+        entry->count = 0;
+        entry->capacity = ourInlineCount;
+        entry->collections = entry->inlineCollections;
+        myEntries.insert(entry);
+    } else if (std::find(entry->collections,
+                         entry->collections + entry->count,
+                         collection) != entry->collections + entry->count) {
+        return ERROR;
+    }
+
+    if (entry->count == entry->capacity) {
+        const int capacity = 2 * entry->capacity;
+        C** const collections =
+            new(std::nothrow) C*[static_cast<size_t>(capacity)];
+        if (0 == collections) {
+            LOG(FATAL) << "Membership_index::add - call to new[] failed!";
+            return ERROR;  // unreachable
+        }
+        std::copy(entry->collections, entry->collections + entry->count,
+                  collections);
+        if (entry->inlineCollections != entry->collections) {
+            delete [] entry->collections;
+        } else {
+            myArrayCount++;
+        }
+        entry->collections = collections;
+        entry->capacity = capacity;
+    }
+
+    entry->collections[entry->count++] = collection;
+    return OK;
+}
+
+// remove
+template<typename C>
+typename Membership_index<C>::Status
+Membership_index<C>::remove(const int record_ID, C* const collection) {
+    Entry* const entry = myEntries.find(record_ID);
+    if (0 == entry) {
+        return ERROR;
+    }
+
+    C** const end = entry->collections + entry->count;
+    C** const found = std::find(entry->collections, end, collection);
+    if (end == found) {
+        return ERROR;
+    }
+
+    // keep the rest in the order they were added
+    std::copy(found + 1, end, found);
+    entry->count--;
+    if (0 == entry->count) {
+        destroyEntry(entry);
+    }
+    return OK;
+}
+
+// contains
+template<typename C>
+bool Membership_index<C>::contains(const int record_ID,
+                                   const C* const collection) const {
+    const Entry* const entry = myEntries.find(record_ID);
+    return (0 != entry) &&
+           (std::find(entry->collections, entry->collections + entry->count,
+                      collection) != entry->collections + entry->count);
+}
+
+// get_count
+template<typename C>
+int Membership_index<C>::get_count(const int record_ID) const {
+    const Entry* const entry = myEntries.find(record_ID);
+    return (0 != entry) ? entry->count : 0;
+}
+
+// apply_to_collections
+template<typename C>
+template<typename Function>
+void Membership_index<C>::apply_to_collections(const int record_ID,
+                                               Function function) const {
+    const Entry* const entry = myEntries.find(record_ID);
+    if (0 != entry) {
+        std::for_each(entry->collections, entry->collections + entry->count,
+                      function);
+    }
+}
+
+// remove_record
+template<typename C>
+template<typename Function>
+int Membership_index<C>::remove_record(const int record_ID,
+                                       Function function) {
+    TRACE_VLOG(1) << "Method Entry:  Membership_index::remove_record";
+    TRACE_VLOG(2) << "Called with arguments\trecord_ID = ->" << record_ID
+                  << "<-";
+
+    Entry* const entry = myEntries.find(record_ID);
+    if (0 == entry) {
+        TRACE_VLOG(1) << "Method Exit :  Membership_index::remove_record";
+        return 0;
+    }
+
+    const int count = entry->count;
+    std::for_each(entry->collections, entry->collections + count, function);
+    destroyEntry(entry);
+
+    TRACE_VLOG(1) << "Method Exit :  Membership_index::remove_record";
+    return count;
+}
+
+// clear
+template<typename C>
+void Membership_index<C>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Membership_index::clear";
+
+    // only the entries with an array of their own need visiting; the rest
+    // go back to the pool all at once
+    if (0 != myArrayCount) {
+        myEntries.apply_in_id_order([](Entry* entry) {
+            if (entry->inlineCollections != entry->collections) {
+                delete [] entry->collections;
+            }
+        });
+        myArrayCount = 0;
+    }
+    myEntries.clear();
+    myPool.release_all();
+
+    TRACE_VLOG(1) << "Method Exit :  Membership_index::clear";
+}
+
+// destroyEntry
+template<typename C>
+void Membership_index<C>::destroyEntry(Entry* const entry) {
+    myEntries.erase(entry->ID);
+    if (entry->inlineCollections != entry->collections) {
+        delete [] entry->collections;
+        myArrayCount--;
+    }
+    entry->~Entry();
+    myPool.deallocate(entry);
+}
+
+#endif  // MEDIAMANAGER_MANAGER_MEMBERSHIP_INDEX_H_
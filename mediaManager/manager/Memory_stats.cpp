@@ -0,0 +1,306 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/Memory_stats.h"
+
+#include <atomic>  // NOLINT(build/include_order)
+#include <cstdint>  // NOLINT(build/include_order)
+#include <iomanip>
+#include <ostream>  // NOLINT(readability/streams)
+
+#include "glog/logging.h"
+
+#include "manager/Utility.h"
+
+
+// initialize static members
+const int Memory_stats::ourNumBuckets;
+
+
+namespace {
+
+// Number of shards; shard 0 is shared by the threads that find no other free.
+const int numShards = 16;
+
+// The counters of one kind in one shard.
+struct Kind_counters {
+    std::atomic<int64_t> count;
+    std::atomic<int64_t> bytes;
+    std::atomic<int64_t> peak_count;
+    std::atomic<int64_t> peak_bytes;
+    std::atomic<int64_t> allocations;
+    std::atomic<int64_t> histogram[Memory_stats::ourNumBuckets];  // NOLINT
+};
+
+// A shard starts on a cache line of its own, and is a whole number of cache
+// lines long, so that threads writing different shards do not contend.
+struct alignas(64) Shard {
+    Kind_counters kinds[Memory_stats::NUMBER_OF_KINDS];
+    std::atomic<bool> taken;
+};
+
+// zero-initialized before any constructor runs, so that objects made during
+// static initialization are counted
+Shard ourShards[numShards];  // NOLINT(runtime/arrays)
+
+// the shard of this thread, or 0 until it takes one
+thread_local Shard* tl_shard = 0;
+// whether this thread is the only one that writes its shard
+thread_local bool tl_exclusive = false;
+
+// Gives up the shard of a thread when the thread ends; changes reported
+// after that, by objects destroyed late in the thread's exit, go to shard 0.
+struct Shard_releaser {
+    ~Shard_releaser() {
+        if (tl_exclusive) {
+            tl_shard->taken.store(false, std::memory_order_release);
+        }
+        tl_shard = &ourShards[0];
+        tl_exclusive = false;
+    }
+
+    Shard* shard;
+};
+
+thread_local Shard_releaser tl_releaser;
+
+// take a free shard for this thread, or share shard 0 if none is free
+Shard* claimShard() {
+    tl_shard = &ourShards[0];
+    for (int i = 1; i < numShards; i++) {
+        bool taken = false;
+        if (ourShards[i].taken.compare_exchange_strong(taken, true)) {
+            tl_shard = &ourShards[i];
+            tl_exclusive = true;
+            break;
+        }
+    }
+
+    // touching the releaser has it destroyed when the thread ends
+    tl_releaser.shard = tl_shard;
+    return tl_shard;
+}
+
+// the counters of kind in this thread's shard
+inline Kind_counters& countersFor(const Memory_stats::Kind kind) {
+    Shard* const shard = (0 == tl_shard) ? claimShard() : tl_shard;
+    return shard->kinds[kind];
+}
+
+// add delta to a counter and return its new value; only the shard's owner
+// writes an exclusive shard, so a plain load and store will do
+inline int64_t addTo(std::atomic<int64_t>* const counter,
+                     const int64_t delta) {
+    if (tl_exclusive) {
+        const int64_t value = counter->load(std::memory_order_relaxed) +
+                              delta;
+        counter->store(value, std::memory_order_relaxed);
+        return value;
+    }
+    return counter->fetch_add(delta, std::memory_order_relaxed) + delta;
+}
+
+// raise a high-water mark to value if value is higher
+inline void raiseTo(std::atomic<int64_t>* const peak, const int64_t value) {
+    if (value <= peak->load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (tl_exclusive) {
+        peak->store(value, std::memory_order_relaxed);
+    } else {
+        atomic_max(peak, value);
+    }
+}
+
+// the histogram bucket for an allocation of bytes
+int bucketFor(const int64_t bytes) {
+    int bucket = 0;
+    while ((bucket < Memory_stats::ourNumBuckets - 1) &&
+           (0 != (bytes >> (bucket + 1)))) {
+        bucket++;
+    }
+    return bucket;
+}
+
+// sum of one counter over the shards
+int64_t sumOver(const Memory_stats::Kind kind,
+                std::atomic<int64_t> Kind_counters::* const counter) {
+    int64_t sum = 0;
+    for (int i = 0; i < numShards; i++) {
+        sum += (ourShards[i].kinds[kind].*counter).load(
+                   std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+}  // namespace
+
+
+// add
+void Memory_stats::add(const Kind kind, const int count, const int64_t bytes) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::add";
+    TRACE_VLOG(2) << "Called with arguments\tkind = ->" << kind
+                  << "<-\tcount = ->" << count
+                  << "<-\tbytes = ->" << bytes << "<-";
+
+    Kind_counters& counters = countersFor(kind);
+    if (0 != count) {
+        raiseTo(&counters.peak_count, addTo(&counters.count, count));
+    }
+    if (0 != bytes) {
+        raiseTo(&counters.peak_bytes, addTo(&counters.bytes, bytes));
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::add";
+}
+
+// note_allocation
+void Memory_stats::note_allocation(const Kind kind, const int64_t bytes) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::note_allocation";
+    TRACE_VLOG(2) << "Called with arguments\tkind = ->" << kind
+                  << "<-\tbytes = ->" << bytes << "<-";
+
+    Kind_counters& counters = countersFor(kind);
+    addTo(&counters.allocations, 1);
+    addTo(&counters.histogram[bucketFor(bytes)], 1);
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::note_allocation";
+}
+
+// allocated
+void Memory_stats::allocated(const Kind kind, const int64_t bytes) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::allocated";
+    TRACE_VLOG(2) << "Called with arguments\tkind = ->" << kind
+                  << "<-\tbytes = ->" << bytes << "<-";
+
+    Kind_counters& counters = countersFor(kind);
+    raiseTo(&counters.peak_count, addTo(&counters.count, 1));
+    raiseTo(&counters.peak_bytes, addTo(&counters.bytes, bytes));
+    addTo(&counters.allocations, 1);
+    addTo(&counters.histogram[bucketFor(bytes)], 1);
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::allocated";
+}
+
+// deallocated
+void Memory_stats::deallocated(const Kind kind, const int64_t bytes) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::deallocated";
+    TRACE_VLOG(2) << "Called with arguments\tkind = ->" << kind
+                  << "<-\tbytes = ->" << bytes << "<-";
+
+    Kind_counters& counters = countersFor(kind);
+    addTo(&counters.count, -1);
+    addTo(&counters.bytes, -bytes);
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::deallocated";
+}
+
+// get_count
+int64_t Memory_stats::get_count(const Kind kind) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::get_count";
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::get_count";
+    return sumOver(kind, &Kind_counters::count);
+}
+
+// get_bytes
+int64_t Memory_stats::get_bytes(const Kind kind) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::get_bytes";
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::get_bytes";
+    return sumOver(kind, &Kind_counters::bytes);
+}
+
+// get_totals
+void Memory_stats::get_totals(const Kind kind, Totals* totals) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::get_totals";
+
+    totals->count       = sumOver(kind, &Kind_counters::count);
+    totals->bytes       = sumOver(kind, &Kind_counters::bytes);
+    totals->peak_count  = sumOver(kind, &Kind_counters::peak_count);
+    totals->peak_bytes  = sumOver(kind, &Kind_counters::peak_bytes);
+    totals->allocations = sumOver(kind, &Kind_counters::allocations);
+    for (int bucket = 0; bucket < ourNumBuckets; bucket++) {
+        totals->histogram[bucket] = 0;
+        for (int i = 0; i < numShards; i++) {
+            totals->histogram[bucket] +=
+                ourShards[i].kinds[kind].histogram[bucket].load(
+                    std::memory_order_relaxed);
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::get_totals";
+}
+
+// reset_peaks
+void Memory_stats::reset_peaks() {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::reset_peaks";
+
+    for (int i = 0; i < numShards; i++) {
+        for (int kind = 0; kind < NUMBER_OF_KINDS; kind++) {
+            Kind_counters& counters = ourShards[i].kinds[kind];
+            counters.peak_count.store(counters.count.load());
+            counters.peak_bytes.store(counters.bytes.load());
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::reset_peaks";
+}
+
+// get_name
+const char* Memory_stats::get_name(const Kind kind) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::get_name";
+
+    static const char* const names[NUMBER_OF_KINDS] = {
+        "Strings", "Ordered_lists", "List nodes", "Records"
+    };
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::get_name";
+    return names[kind];
+}
+
+// print
+void Memory_stats::print(std::ostream* const os) {
+    TRACE_VLOG(1) << "Method Entry:  Memory_stats::print";
+
+    *os << "Memory allocations:\n";
+    *os << std::left << std::setw(14) << "" << std::right
+        << std::setw(10) << "count" << std::setw(14) << "bytes"
+        << std::setw(12) << "peak count" << std::setw(14) << "peak bytes"
+        << std::setw(13) << "allocations" << "\n";
+
+    Totals totals[NUMBER_OF_KINDS];
+    for (int kind = 0; kind < NUMBER_OF_KINDS; kind++) {
+        get_totals(static_cast<Kind>(kind), &totals[kind]);
+        *os << std::left << std::setw(14) << get_name(static_cast<Kind>(kind))
+            << std::right
+            << std::setw(10) << totals[kind].count
+            << std::setw(14) << totals[kind].bytes
+            << std::setw(12) << totals[kind].peak_count
+            << std::setw(14) << totals[kind].peak_bytes
+            << std::setw(13) << totals[kind].allocations << "\n";
+    }
+
+    // the sizes of the allocations, one line per bucket in use
+    for (int kind = 0; kind < NUMBER_OF_KINDS; kind++) {
+        if (0 == totals[kind].allocations) {
+            continue;
+        }
+        *os << get_name(static_cast<Kind>(kind)) << " allocation sizes:\n";
+        for (int bucket = 0; bucket < ourNumBuckets; bucket++) {
+            if (0 == totals[kind].histogram[bucket]) {
+                continue;
+            }
+            *os << std::setw(8) << (int64_t(1) << bucket);
+            if (ourNumBuckets - 1 == bucket) {
+                *os << " bytes and up";
+            } else {
+                *os << " - " << std::left << std::setw(8)
+                   << (int64_t(2) << bucket) - 1 << std::right << " bytes";
+            }
+            *os << std::setw(12) << totals[kind].histogram[bucket] << "\n";
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Memory_stats::print";
+}
@@ -0,0 +1,235 @@
+#ifndef MEDIAMANAGER_MANAGER_MEMORY_STATS_H_
+#define MEDIAMANAGER_MANAGER_MEMORY_STATS_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdint>  // NOLINT(build/include_order)
+#include <ostream>  // NOLINT(readability/streams)
+
+#include "manager/Utility.h"
+
+
+/**
+ * @file Memory_stats.h
+ * @brief Declaration of Memory_stats and Memory_count classes.
+ */
+
+
+/**
+ * @class Memory_stats Memory_stats.h manager/Memory_stats.h
+ *
+ * @brief Counts of the objects and bytes in use, by kind of object, kept
+ * without a shared counter that every thread writes.
+ *
+ * @details Each thread that reports a change is given a shard of its own, a
+ * set of counters alone in its cache lines, which only that thread writes;
+ * a read adds up the shards.  A thread's shard is given up when the thread
+ * ends, keeping its counts, and may then be taken by a new thread.  Should
+ * there be more threads than shards, the extra threads share one shard,
+ * which they update with atomic adds.
+ *
+ * For each kind of object there are kept:
+ * - the number in existence and the bytes they hold;
+ * - their high-water marks, since the start or the last reset_peaks();
+ * - the number of allocations made, with a histogram of their sizes in
+ *   powers of two.
+ *
+ * The high-water mark is kept per shard, and the one reported is the sum of
+ * those of the shards.  This is exact when the objects of a kind are made
+ * and destroyed on one thread, as they are in this program (see
+ * Concurrent_library), and an upper bound otherwise.
+ *
+ * print() writes the report of the pa (print allocations) command.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Memory_stats {
+  public:
+    /**
+     * The kinds of object counted.
+     */
+    enum Kind {
+        STRING,             // Strings; bytes are their C-String allocations
+        ORDERED_LIST,       // Ordered_lists; bytes are Sorted_array storage
+        LIST_NODE,          // Ordered_list nodes, Skip_list nodes included
+        RECORD,             // Records
+        NUMBER_OF_KINDS
+    };
+
+    /**
+     * Number of histogram buckets; bucket i counts allocations of 2^i to
+     * 2^(i+1) - 1 bytes, and the last bucket all larger ones.
+     */
+    static const int ourNumBuckets = 16;
+
+    /**
+     * The statistics of one kind, added up over the shards.
+     */
+    struct Totals {
+        int64_t count;        // objects in existence
+        int64_t bytes;        // bytes they hold
+        int64_t peak_count;   // high-water mark of count
+        int64_t peak_bytes;   // high-water mark of bytes
+        int64_t allocations;  // allocations made
+        // allocations by size
+        int64_t histogram[ourNumBuckets];  // NOLINT(runtime/arrays)
+    };
+
+    /**
+     * Record a change in the objects of a kind, e.g. one object made, or
+     * several destroyed at once.
+     *
+     * @pre  None.
+     * @post The count and bytes of kind are changed, and their high-water
+     *       marks raised if they are exceeded.
+     *
+     * @param kind  Kind of the objects
+     * @param count Number of objects made, or minus the number destroyed
+     * @param bytes Bytes they hold, or minus the bytes released
+     */
+    static void add(const Kind kind, const int count, const int64_t bytes);
+
+    /**
+     * Record an allocation, in the histogram of its kind.  The bytes it
+     * holds are reported with add().
+     *
+     * @pre  bytes > 0.
+     * @post The allocation is counted.
+     *
+     * @param kind  Kind of object the allocation is for
+     * @param bytes Size of the allocation
+     */
+    static void note_allocation(const Kind kind, const int64_t bytes);
+
+    /**
+     * Record an object made with an allocation of its own, e.g. a list
+     * node: add() and note_allocation() in one.
+     *
+     * @pre  bytes > 0.
+     * @post The object and its allocation are counted.
+     *
+     * @param kind  Kind of the object
+     * @param bytes Size of its allocation
+     */
+    static void allocated(const Kind kind, const int64_t bytes);
+
+    /**
+     * Record the destruction of an object counted with allocated().
+     *
+     * @pre  None.
+     * @post The count and bytes of kind are lowered.
+     *
+     * @param kind  Kind of the object
+     * @param bytes Size of its allocation
+     */
+    static void deallocated(const Kind kind, const int64_t bytes);
+
+    /**
+     * @return the number of objects of kind in existence
+     */
+    static int64_t get_count(const Kind kind);
+
+    /**
+     * @return the bytes held by the objects of kind
+     */
+    static int64_t get_bytes(const Kind kind);
+
+    /**
+     * Add up the statistics of a kind.  While other threads are changing
+     * them, the totals may mix values from before and after a change.
+     *
+     * @pre  None.
+     * @post totals holds the statistics of kind.
+     *
+     * @param kind   Kind to report on
+     * @param totals The statistics
+     */
+    static void get_totals(const Kind kind, Totals* totals);
+
+    /**
+     * Lower every high-water mark to the present value.
+     *
+     * @pre  No other thread is changing the statistics.
+     * @post The high-water marks count from now.
+     */
+    static void reset_peaks();
+
+    /**
+     * @return the name of kind, e.g. "Strings"
+     */
+    static const char* get_name(const Kind kind);
+
+    /**
+     * Write the statistics of every kind, with the histograms of those that
+     * have made allocations, for the pa command.
+     *
+     * @pre  None.
+     * @post The report has been written to os.
+     *
+     * @param os Stream to write to
+     */
+    static void print(std::ostream* const os);
+
+  private:
+    /**
+     * Only static members; not to be constructed.
+     */
+    Memory_stats();
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Memory_stats);
+};
+
+
+/**
+ * @class Memory_count Memory_stats.h manager/Memory_stats.h
+ *
+ * @brief A read-only view of the count of one kind in Memory_stats, which
+ * reads as an int, e.g. g_Ordered_list_count.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Memory_count {
+  public:
+    /**
+     * Constructor that selects the kind to view.
+     *
+     * @pre  None.
+     * @post Object reads as the count of kind.
+     *
+     * @param kind Kind to view
+     */
+    explicit constexpr Memory_count(const Memory_stats::Kind kind)
+          : myKind(kind) {
+    }
+
+    /**
+     * @return the number of objects of the kind in existence
+     */
+    operator int() const {
+        return static_cast<int>(Memory_stats::get_count(myKind));
+    }
+
+  private:
+    const Memory_stats::Kind myKind;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Memory_count);
+};
+
+
+#endif  // MEDIAMANAGER_MANAGER_MEMORY_STATS_H_
@@ -0,0 +1,337 @@
+#ifndef MEDIAMANAGER_MANAGER_NODE_POOL_H_
+#define MEDIAMANAGER_MANAGER_NODE_POOL_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>  // NOLINT(build/include_order)
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Node_pool.h
+ * @brief Node allocation policies for Ordered_list.
+ */
+
+
+/**
+ * @class Node_pool Node_pool.h manager/Node_pool.h
+ *
+ * @brief Slab allocator for list nodes of a single type.
+ *
+ * @details Storage for nodes is carved out of contiguous chunks instead of
+ * being allocated one node at a time.  Each chunk holds twice as many nodes as
+ * the previous one, up to ourMaxChunkNodes, so a short list costs one small
+ * allocation and a long list a handful of large ones.  Nodes given back with
+ * deallocate() go on a free list and are reused before a chunk is extended.
+ *
+ * The pool hands out uninitialized storage; constructing and destroying the
+ * nodes is the caller's job.  release_all() returns every chunk at once,
+ * which is how a list discards all of its nodes in time proportional to the
+ * number of chunks rather than the number of nodes.
+ *
+ * This is the interface Ordered_list expects from its node allocator
+ * template parameter; Heap_node_allocator is the plain new/delete version.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename Node>
+class Node_pool {
+  public:
+    /**
+     * Number of nodes in the first chunk.
+     */
+    static const int ourMinChunkNodes = 8;
+
+    /**
+     * Largest number of nodes in a chunk.
+     */
+    static const int ourMaxChunkNodes = 4096;
+
+    /**
+     * Constructor that initializes all member variables; no chunk is
+     * allocated until the first node is requested.
+     *
+     * @pre  None.
+     * @post Pool is empty.
+     */
+    Node_pool();
+
+    /**
+     * Returns all chunks.  Nodes still handed out become invalid.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Node_pool();
+
+    /**
+     * @pre  None.
+     * @post Storage for one Node is handed out.
+     *
+     * @warning If a new chunk cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @return uninitialized storage for one Node
+     */
+    Node* allocate();
+
+    /**
+     * Give back the storage for one Node for reuse.
+     *
+     * @pre  node came from allocate() on this pool and has been destroyed.
+     * @post Storage is on the free list.
+     *
+     * @param node Storage to give back
+     */
+    void deallocate(Node* node);
+
+    /**
+     * Return the storage for every Node handed out, all at once.
+     *
+     * @pre  Every Node handed out has been destroyed or needs no destruction.
+     * @post Pool is empty.
+     *
+     * @return true - this allocator supports releasing all nodes at once
+     */
+    bool release_all();
+
+    /**
+     * Interchange the chunks of this pool with another one.  Nodes stay where
+     * they are and now belong to the other pool.
+     *
+     * @pre  None.
+     * @post Member variables of two pools are swapped.
+     *
+     * @param other Pool to swap with
+     */
+    void swap(Node_pool& other);  // NOLINT(build/include_what_you_use)
+
+  private:
+    /**
+     * One node's worth of storage, or a link while unused.  The first slot of
+     * each chunk links the chunks together.
+     */
+    union Slot {
+        /** Next free slot, or next chunk for a chunk's first slot. */
+        Slot* next;
+
+        /** Storage for a Node. */
+        typename std::aligned_storage<sizeof(Node),
+                                      alignof(Node)>::type storage;
+    };
+
+    /**
+     * Most recently allocated chunk; the chunks are linked through their
+     * first slot.
+     */
+    Slot* myChunks;
+
+    /**
+     * Slots given back by deallocate().
+     */
+    Slot* myFreeSlots;
+
+    /**
+     * Next never-used slot in the newest chunk.
+     */
+    Slot* myNextSlot;
+
+    /**
+     * Number of never-used slots left in the newest chunk.
+     */
+    int mySlotsLeft;
+
+    /**
+     * Number of nodes the next chunk will hold.
+     */
+    int myNextChunkNodes;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Node_pool);
+};
+
+
+/**
+ * @class Heap_node_allocator Node_pool.h manager/Node_pool.h
+ *
+ * @brief Node allocation policy that uses new and delete for every node.
+ *
+ * @details Has the same interface as Node_pool, but cannot release all nodes
+ * at once, so a list using it destroys its nodes one by one.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename Node>
+class Heap_node_allocator {
+  public:
+    Heap_node_allocator() {}
+
+    /**
+     * @return uninitialized storage for one Node from the heap
+     */
+    Node* allocate() {
+        return static_cast<Node*>(::operator new(sizeof(Node)));
+    }
+
+    /**
+     * @param node Storage to give back to the heap
+     */
+    void deallocate(Node* node) {
+        ::operator delete(node);
+    }
+
+    /**
+     * @return false - every node must be deallocated individually
+     */
+    bool release_all() {
+        return false;
+    }
+
+    /**
+     * Nothing to interchange; nodes belong to the heap.
+     */
+    void swap(Heap_node_allocator&) {}  // NOLINT(build/include_what_you_use)
+
+  private:
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Heap_node_allocator);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename Node>
+const int Node_pool<Node>::ourMinChunkNodes;
+
+template<typename Node>
+const int Node_pool<Node>::ourMaxChunkNodes;
+
+// constructor
+template<typename Node>
+Node_pool<Node>::Node_pool()
+          : myChunks(0),
+            myFreeSlots(0),
+            myNextSlot(0),
+            mySlotsLeft(0),
+            myNextChunkNodes(ourMinChunkNodes) {
+    TRACE_VLOG(1) << "Method Entry:  Node_pool::Node_pool";
+    TRACE_VLOG(1) << "Method Exit :  Node_pool::Node_pool";
+}
+
+// destructor
+template<typename Node>
+Node_pool<Node>::~Node_pool() {
+    TRACE_VLOG(1) << "Method Entry:  Node_pool::~Node_pool";
+
+    release_all();
+
+    TRACE_VLOG(1) << "Method Exit :  Node_pool::~Node_pool";
+}
+
+// allocate
+template<typename Node>
+Node* Node_pool<Node>::allocate() {
+    TRACE_VLOG(1) << "Method Entry:  Node_pool::allocate";
+
+    Slot* slot = myFreeSlots;
+
+    if (0 != slot) {
+        // reuse a slot that was given back
+        myFreeSlots = slot->next;
+    } else {
+        if (0 == mySlotsLeft) {
+            // one extra slot at the front links the chunks together
+            const size_t count = static_cast<size_t>(myNextChunkNodes + 1);
+            Slot* const chunk = new(std::nothrow) Slot[count];
+            if (0 == chunk) {
+                LOG(FATAL) << "Node_pool::allocate - call to new[] failed!";
+                return 0;  // unreachable
+            }
+
+            chunk->next = myChunks;
+            myChunks = chunk;
+            myNextSlot = chunk + 1;
+            mySlotsLeft = myNextChunkNodes;
+            myNextChunkNodes = std::min(2 * myNextChunkNodes,
+                                        static_cast<int>(ourMaxChunkNodes));
+        }
+
+        slot = myNextSlot;
+        myNextSlot++;
+        mySlotsLeft--;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Node_pool::allocate";
+    return reinterpret_cast<Node*>(&slot->storage);
+}
+
+// deallocate
+template<typename Node>
+void Node_pool<Node>::deallocate(Node* node) {
+    TRACE_VLOG(1) << "Method Entry:  Node_pool::deallocate";
+
+    Slot* const slot = reinterpret_cast<Slot*>(node);
+    slot->next = myFreeSlots;
+    myFreeSlots = slot;
+
+    TRACE_VLOG(1) << "Method Exit :  Node_pool::deallocate";
+}
+
+// release_all
+template<typename Node>
+bool Node_pool<Node>::release_all() {
+    TRACE_VLOG(1) << "Method Entry:  Node_pool::release_all";
+
+    while (0 != myChunks) {
+        Slot* const next = myChunks->next;
+        delete [] myChunks;
+        myChunks = next;
+    }
+
+    myFreeSlots = 0;
+    myNextSlot = 0;
+    mySlotsLeft = 0;
+    myNextChunkNodes = ourMinChunkNodes;
+
+    TRACE_VLOG(1) << "Method Exit :  Node_pool::release_all";
+    return true;
+}
+
+// swap
+template<typename Node>
+void Node_pool<Node>::swap(Node_pool& other) {
+    TRACE_VLOG(1) << "Method Entry:  Node_pool::swap";
+
+    std::swap(myChunks,         other.myChunks);
+    std::swap(myFreeSlots,      other.myFreeSlots);
+    std::swap(myNextSlot,       other.myNextSlot);
+    std::swap(mySlotsLeft,      other.mySlotsLeft);
+    std::swap(myNextChunkNodes, other.myNextChunkNodes);
+
+    TRACE_VLOG(1) << "Method Exit :  Node_pool::swap";
+}
+
+
+#endif  // MEDIAMANAGER_MANAGER_NODE_POOL_H_
@@ -7,6 +7,18 @@
  */
 
 
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <type_traits>  // NOLINT(build/include_order)
+#include <utility>
+
+#include "glog/logging.h"
+#include "manager/Memory_stats.h"
+#include "manager/Node_pool.h"
+#include "manager/Utility.h"
+
+
 /*
  * Ordered_list is a linked-list class template  with iterators similar to the
  * Standard Library std::list class.  The iterators encapsulate a pointer to
@@ -22,9 +34,9 @@
  * order, and false otherwise.  The ordering function is an optional
  * constructor parameter; if none is supplied, the default is to use the
  * defined less_than function template which uses the < operator for the type,
- * which orders the list from smallest to largest. The only way to add to the
- * list is with the insert function, which automatically puts the new item in
- * the proper place in the list.
+ * which orders the list from smallest to largest. The only ways to add to the
+ * list are the insert and insert_range functions and the range constructor,
+ * which automatically put the new items in the proper place in the list.
  *
  * The ordering function arguments are of type reference-to-const, meaning that
  * the ordering function neither copies nor modifies the objects in the list.
@@ -72,41 +84,112 @@
  *
  * If any operations are attempted that are erroneous (e.g. erasing a
  * non-existent node), the results are undefined.
- */
-
-
-/* *** NOTE: If after a function header is a comment "fill this in" remove the
- * comment and replace it with the proper code here in the class declaration.
- * All other functions should be defined after the class declaration in this
- * header file.
  *
- * Comments starting with "***" are instructions to you - remove them from your
- * finished code.  Remove this comment too.
+ * Storage for the list nodes comes from the node allocator template
+ * parameter.  The default, Node_pool, carves nodes out of contiguous chunks
+ * owned by the list, so nodes of one list sit close together in memory and
+ * clear() can give them all back in time proportional to the number of
+ * chunks when the items need no destruction (e.g. a list of pointers).
+ * Heap_node_allocator allocates every node separately with new.  Either way
+ * each node is counted in Memory_stats as a LIST_NODE, and each list as an
+ * ORDERED_LIST; g_Ordered_list_Node_count reads the number of nodes.
+ *
+ * The type of the ordering function is the Ordering template parameter, so a
+ * function object or lambda can be used and its comparisons inlined, e.g.
+ *   Ordered_list<Record *, Node_pool, Order_by_title> library;
+ * The default, Default_ordering, inlines the < operator for the type but also
+ * accepts a pointer to an ordering function, so existing code that passes one
+ * to the constructor is unchanged.  The Ordering is copied along with the
+ * list; swap and assignment also need it to be assignable, which a lambda is
+ * not.
  */
 
 // This function template defines a default ordering function
 // based on the less-than operator for the type T.
-/* *** Complete this definition */
 template<typename T>
-bool less_than(const T& t1, const T& t2)
+bool less_than(const T& t1, const T& t2) {
+    return t1 < t2;
+}
+
+
+// Has_less_than<T>::value is true if two objects of type T can be compared
+// with the < operator.
+template<typename T>
+class Has_less_than {
+  private:
+    template<typename U>
+    static std::true_type test(
+        decltype(std::declval<const U&>() < std::declval<const U&>()) *);
+    template<typename U>
+    static std::false_type test(...);
+
+  public:
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+
+// Default_ordering is the ordering used unless another is given as the
+// Ordering template argument.  Default constructed, it applies the < operator
+// for the type directly, so the comparisons in insert and find are inlined.
+// Constructed from an ordering function (which Ordered_list's constructors
+// do implicitly), it calls that function instead.
+template<typename T>
+class Default_ordering {
+  public:
+    Default_ordering()
+      : function(0) {
+        static_assert(Has_less_than<T>::value,
+                      "no < operator; supply an ordering function");
+    }
+
+    // not explicit, so an ordering function can be given where a
+    // Default_ordering is expected
+    Default_ordering(bool (*in_function) (const T&, const T&))  // NOLINT
+      : function(in_function) {
+    }
+
+    bool operator() (const T& t1, const T& t2) const {
+        return (0 == function) ?
+            compare(t1, t2, std::integral_constant<bool,
+                                Has_less_than<T>::value>()) :
+            function(t1, t2);
+    }
 
+  private:
+    static bool compare(const T& t1, const T& t2, std::true_type) {
+        return t1 < t2;
+    }
+
+    // only reachable through a default constructed object, which can't be
+    // made for such a type
+    static bool compare(const T&, const T&, std::false_type) {
+        assert(false);
+        return false;
+    }
+
+    // ordering function to call, or 0 to use the < operator
+    bool (*function) (const T&, const T&);  // NOLINT
+};
 
+
+template<typename T,
+         template<typename> class Node_allocator = Node_pool,
+         typename Ordering = Default_ordering<T> >
 class Ordered_list {
   private:
     // Node is a nested class that is private to the Ordered_list<T> class;
     // declared first to simplify later declarations.
-    // *** you may add another Node * member, and constructor parameter,
-    // *** if you want to use a two-way linked list
     struct Node {
         Node(const T& in_datum, Node * in_next) :
             datum(in_datum), next(in_next)
-            {g_Ordered_list_Node_count++;}
+            {Memory_stats::allocated(Memory_stats::LIST_NODE, sizeof(Node));}
         // copy ctor and dtor defined only to support allocation counting
         Node(const Node& other) :
             datum(other.datum), next(other.next)
-            {g_Ordered_list_Node_count++;}
+            {Memory_stats::allocated(Memory_stats::LIST_NODE, sizeof(Node));}
         ~Node()
-            {g_Ordered_list_Node_count--;}
+            {Memory_stats::deallocated(Memory_stats::LIST_NODE,
+                                       sizeof(Node));}
         T datum;
         Node * next;
         };
@@ -116,27 +199,36 @@ class Ordered_list {
     // The constructor takes a ordering function that returns true if the first
     // argument should come before the second; the arguments are passed in by
     // reference-to-const to avoid data copying.  The default constructor
-    // parameter is the less_than function for the type.
-    Ordered_list(bool (*ordering_function_)(const T&, const T&) = less_than<T>);
-
-    /* *** Defined the constructor, and declare and define the destructor,
-     * copy constructor, and assignment operator.  The destructor must
-     * deallocate all nodes. Copy and assignment must produce a list that
-     * contains nodes that have a copy of the data in the other ordered list.
-     * Assignment must use the "copy-swap" idiom.
-     *
-     * The constructors and destructor must increment/decrement
-     * g_Ordered_list_count.
-     */
+    // parameter uses the < operator for the type.  With the default Ordering
+    // the argument may be a pointer to an ordering function such as
+    // less_than<T>; otherwise it is an object of the Ordering type.
+    Ordered_list(const Ordering& ordering_function_ = Ordering());
+
+    // The range constructor builds the list from the items in
+    // [first_datum, last_datum), in any order; see insert_range.
+    template <typename Input_iterator>
+    Ordered_list(Input_iterator first_datum,
+                 Input_iterator last_datum,
+                 const Ordering& ordering_function_ = Ordering());
+
+    // The copy constructor produces a list whose nodes hold copies of the data
+    // in the other list, allocated from this list's own node storage.
+    Ordered_list(const Ordered_list& other);
+
+    // Assignment uses the copy-swap idiom.
+    Ordered_list& operator= (const Ordered_list& rhs);
+
+    // The destructor deallocates all nodes.
+    ~Ordered_list();
 
     // Delete the nodes in the list, if any, and initialize it.
     void clear();
     // Return the number of nodes in the list
     int size() const
-        {/* fill this in */}
+        {return length;}
     // Return true if the list is empty
     bool empty() const
-        {/* fill this in */}
+        {return 0 == first;}
 
     // An Iterator object designates a Node by encapsulating a pointer to the
     // Node, and provides Standard Library-style operators for using,
@@ -153,16 +245,13 @@ class Ordered_list {
         // Overloaded dereferencing operators
         // * returns a reference to the datum in the pointed-to node
         T& operator* () const {
-            /* fill this in */
+            assert(node_ptr);
+            return node_ptr->datum;
         }
 
         // operator-> simply returns the address of the data in the pointed-to
         // node.  For this operator, the compiler reapplies the -> operator
         // with the returned pointer.
-
-        /* *** definition supplied here because it is a special-case of
-         * operator overloading.
-         */
         T* operator-> () const {
             assert(node_ptr);
             return &(node_ptr->datum);
@@ -170,42 +259,42 @@ class Ordered_list {
 
         // ++ operator moves the iterator forward to point to the next node
         Iterator operator++ () {
-            /* fill this in */
+            assert(node_ptr);
+            node_ptr = node_ptr->next;
+            return *this;
         }
 
         Iterator operator++ (int) {  // NOLINT(readability/function)
-            /* fill this in */
+            assert(node_ptr);
+            Iterator previous(*this);
+            node_ptr = node_ptr->next;
+            return previous;
         }
 
         // Iterators ar equal if they point to the same node
         bool operator== (Iterator rhs) const {
-            /* fill this in */
+            return node_ptr == rhs.node_ptr;
         }
 
         bool operator!= (Iterator rhs) const {
-            /* fill this in */
+            return node_ptr != rhs.node_ptr;
         }
 
-        // *** here, declare the outer Ordered_list class is a friend
+        friend class Ordered_list;
 
       private:
-        /* *** define here a private constructor for Iterator that takes a
-         * Node* parameter.  Ordered_list<T> can use this to create Iterators
-         * conveniently initialized to point to a Node.  It is private because
-         * the client code can't and shouldn't be using it - it isn't even
-         * supposed to know about the Node objects.
-         */
-
-        /* *** you may have other private member functions, but not member
-         * variables
-         */
+        // Ordered_list uses this to create Iterators pointing to a Node
+        explicit Iterator(Node * in_node_ptr)
+          : node_ptr(in_node_ptr) {
+        }
+
         Node * node_ptr;
     };
     // end of nested Iterator class declaration
 
     // return an iterator pointing to the first node
     Iterator begin() const
-        {/* fill this in */}
+        {return Iterator(first);}
     // return an iterator pointing to "past the end"
     Iterator end() const
         {return Iterator(0);}   // same as next pointer of last node
@@ -216,6 +305,13 @@ class Ordered_list {
     // already there.
     void insert(const T& new_datum);
 
+    // Add the items in [first_datum, last_datum) to the list, in any order.
+    // The result is the same as inserting them one at a time, but takes
+    // O(n log n) comparisons instead of O(n^2): the new nodes are merge sorted
+    // on their own, then merged into the list in one pass.
+    template <typename Input_iterator>
+    void insert_range(Input_iterator first_datum, Input_iterator last_datum);
+
     // Delete the specified node.
     // Caller is responsible for any required deletion of any pointed-to data
     // beforehand.  Do not attempt to dereference the iterator after calling
@@ -231,56 +327,434 @@ class Ordered_list {
     // where the matching item would be.
     Iterator find(const T& probe_datum) const;
 
+    // The lower_bound function returns an iterator designating the first node
+    // whose datum does not come before probe_datum, or end() if there is none.
+    // Unlike find, the node need not be equal to the probe, so this is where
+    // a scan over a range of items (such as all titles with a given prefix)
+    // starts.
+    Iterator lower_bound(const T& probe_datum) const;
+
     // None of the following "apply" functions is allowed to
     // modify the list or items in the list
 
-    // The apply function takes a pointer to a function that takes a type T
-    // argument, and iterates through the list calling this function or each
-    // datum in the list. The function is not allowed to modify items in the
-    // list or th.
-    void apply(void (*apply_function) (const T&)) const; // NOLINT
+    // The apply functions are templated on the type of the function, so they
+    // accept a pointer to a function, a function object or a lambda; the
+    // latter two can be inlined into the loop.
+
+    // The apply function takes a function that takes a type T argument, and
+    // iterates through the list calling this function or each datum in the
+    // list. The function is not allowed to modify items in the list or th.
+    template <typename Function>
+    void apply(Function apply_function) const;
 
     // The apply_if functions are like the apply functions in that they call
     // the supplied function for each item in the list, but stop the iteration
     // and return true if the function returns true.
     // The function is not allowed to modify items in the list.
-    bool apply_if(bool (*apply_function) (const T&)) const; // NOLINT
-
-    // The following are templated member functions - they have an additional
-    // template argument fo the type of the additional function parameter.
-
-    /* *** if you define these outside the class declaration, declare the
-     * second template parameter as follows:
-     *  template<typename T> template <typename Arg>
-     *  void Ordered_list<T>::apply_arg(void (*apply_function) (const T&, Arg),
-     *                                  Arg apply_arg) const
-     *  {
-     *  }
-     */
-
-    // The apply_arg functions take a pointer to a function that takes a type T
-    // argument and a second argument of type Arg, and iterates through the
-    // list calling this function for each datum in the list.  Note that you
-    // can tell the compiler how to interpret Arg if it cannot deduce the
-    // function prototype correctly from the call, for example, to pass in a
-    // stream by reference:
+    template <typename Function>
+    bool apply_if(Function apply_function) const;
+
+    // The following have an additional template argument for the type of the
+    // additional function parameter.
+
+    // The apply_arg functions take a function that takes a type T argument
+    // and a second argument of type Arg, and iterates through the list
+    // calling this function for each datum in the list.  Note that you can
+    // tell the compiler how to interpret Arg if it cannot deduce it correctly
+    // from the call, for example, to pass in a stream by reference:
     //   my_OL.apply_arg<ofstream&>(output_item, outfile);
-    template <typename Arg>
-    void apply_arg(void (*apply_function) (const T&, Arg), // NOLINT
-                                           Arg apply_arg) const;
+    template <typename Arg, typename Function>
+    void apply_arg(Function apply_function, Arg apply_arg) const;
 
-    template <typename Arg>
-    bool apply_if_arg(bool (*apply_function) (const T&, Arg), // NOLINT
-                                              Arg apply_arg) const;
+    template <typename Arg, typename Function>
+    bool apply_if_arg(Function apply_function, Arg apply_arg) const;
 
     // interchange the member variable values of this list with the other list
     void swap(Ordered_list & other);  // NOLINT(build/include_what_you_use)
 
   private:
-    // *** this is the member variable declaration for the ordering function -
-    // name is your choice.
-    bool (*ordering_function) (const T&, const T&); // NOLINT
-    /* *** private member variables and functions are your choice. */
+    // destroy every node and give its storage back
+    void destroy_nodes();
+
+    // stable merge sort of a chain of count nodes; returns the new first node
+    Node * sort_nodes(Node * chain, const int count) const;
+    // merge two sorted chains, taking from chain1 first on ties
+    Node * merge_nodes(Node * chain1, Node * chain2) const;
+
+    Ordering ordering_function;
+    // first node in the list, 0 if the list is empty
+    Node * first;
+    // number of nodes in the list
+    int length;
+    // storage for the nodes
+    Node_allocator<Node> node_allocator;
 };
 
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// constructor
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+Ordered_list<T, Node_allocator, Ordering>::Ordered_list(
+        const Ordering& ordering_function_)
+          : ordering_function(ordering_function_),
+            first(0),
+            length(0) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list";
+
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list";
+}
+
+// copy constructor
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+Ordered_list<T, Node_allocator, Ordering>::Ordered_list(
+        const Ordered_list& other)
+          : ordering_function(other.ordering_function),
+            first(0),
+            length(0) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list(const "
+                  << "Ordered_list&)";
+
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+
+    // the other list is already in order, so just append at the tail
+    Node ** tail = &first;
+    for (Node * node = other.first; 0 != node; node = node->next) {
+        *tail = new(node_allocator.allocate()) Node(node->datum, 0);
+        tail = &(*tail)->next;
+        length++;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list(const "
+                  << "Ordered_list&)";
+}
+
+// range constructor
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+template <typename Input_iterator>
+Ordered_list<T, Node_allocator, Ordering>::Ordered_list(
+        Input_iterator first_datum,
+        Input_iterator last_datum,
+        const Ordering& ordering_function_)
+          : ordering_function(ordering_function_),
+            first(0),
+            length(0) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list("
+                  << "Input_iterator, Input_iterator)";
+
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+    insert_range(first_datum, last_datum);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list("
+                  << "Input_iterator, Input_iterator)";
+}
+
+// assignment
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+Ordered_list<T, Node_allocator, Ordering>&
+Ordered_list<T, Node_allocator, Ordering>::operator= (const Ordered_list& rhs) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::operator=";
+
+    Ordered_list temp(rhs);
+    swap(temp);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::operator=";
+    return *this;
+}
+
+// destructor
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+Ordered_list<T, Node_allocator, Ordering>::~Ordered_list() {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::~Ordered_list";
+
+    destroy_nodes();
+    Memory_stats::add(Memory_stats::ORDERED_LIST, -1, 0);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::~Ordered_list";
+}
+
+// clear
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+void Ordered_list<T, Node_allocator, Ordering>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::clear";
+
+    destroy_nodes();
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::clear";
+}
+
+// insert
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+void Ordered_list<T, Node_allocator, Ordering>::insert(const T& new_datum) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::insert";
+
+    // skip every node that comes before the new datum; the new node then
+    // goes in front of the first node that is not less than it
+    Node ** link = &first;
+    while ((0 != *link) && ordering_function((*link)->datum, new_datum)) {
+        link = &(*link)->next;
+    }
+
+    *link = new(node_allocator.allocate()) Node(new_datum, *link);
+    length++;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::insert";
+}
+
+// insert_range
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+template <typename Input_iterator>
+void Ordered_list<T, Node_allocator, Ordering>::insert_range(
+        Input_iterator first_datum,
+        Input_iterator last_datum) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::insert_range";
+
+    // Chain the new nodes in reverse.  Inserting one at a time puts each item
+    // before the equal ones added earlier, and a stable sort of the reversed
+    // chain keeps exactly that order; the merge then puts the new items
+    // before equal ones already in the list.
+    Node * batch = 0;
+    int count = 0;
+    for (; first_datum != last_datum; ++first_datum) {
+        batch = new(node_allocator.allocate()) Node(*first_datum, batch);
+        count++;
+    }
+
+    first = merge_nodes(sort_nodes(batch, count), first);
+    length += count;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::insert_range";
+}
+
+// erase
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+void Ordered_list<T, Node_allocator, Ordering>::erase(Iterator it) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::erase";
+
+    assert(it.node_ptr);
+
+    // find the link that points to the node
+    Node ** link = &first;
+    while (*link != it.node_ptr) {
+        assert(*link);
+        link = &(*link)->next;
+    }
+
+    *link = it.node_ptr->next;
+    it.node_ptr->~Node();
+    node_allocator.deallocate(it.node_ptr);
+    length--;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::erase";
+}
+
+// find
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+typename Ordered_list<T, Node_allocator, Ordering>::Iterator
+Ordered_list<T, Node_allocator, Ordering>::find(const T& probe_datum) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::find";
+
+    Node * node = lower_bound(probe_datum).node_ptr;
+
+    // the node found is equal unless the probe comes before it
+    if ((0 != node) && ordering_function(probe_datum, node->datum)) {
+        node = 0;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::find";
+    return Iterator(node);
+}
+
+// lower_bound
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+typename Ordered_list<T, Node_allocator, Ordering>::Iterator
+Ordered_list<T, Node_allocator, Ordering>::lower_bound(
+        const T& probe_datum) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::lower_bound";
+
+    // skip the nodes that come before the probe
+    Node * node = first;
+    while ((0 != node) && ordering_function(node->datum, probe_datum)) {
+        node = node->next;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::lower_bound";
+    return Iterator(node);
+}
+
+// apply
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+template <typename Function>
+void Ordered_list<T, Node_allocator, Ordering>::apply(
+        Function apply_function) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply";
+
+    for (Node * node = first; 0 != node; node = node->next) {
+        apply_function(node->datum);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply";
+}
+
+// apply_if
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+template <typename Function>
+bool Ordered_list<T, Node_allocator, Ordering>::apply_if(
+        Function apply_function) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_if";
+
+    for (Node * node = first; 0 != node; node = node->next) {
+        if (apply_function(node->datum)) {
+            TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if";
+            return true;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if";
+    return false;
+}
+
+// apply_arg
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+template <typename Arg, typename Function>
+void Ordered_list<T, Node_allocator, Ordering>::apply_arg(
+        Function apply_function,
+        Arg apply_arg) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_arg";
+
+    for (Node * node = first; 0 != node; node = node->next) {
+        apply_function(node->datum, apply_arg);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_arg";
+}
+
+// apply_if_arg
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+template <typename Arg, typename Function>
+bool Ordered_list<T, Node_allocator, Ordering>::apply_if_arg(
+        Function apply_function,
+        Arg apply_arg) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_if_arg";
+
+    for (Node * node = first; 0 != node; node = node->next) {
+        if (apply_function(node->datum, apply_arg)) {
+            TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if_arg";
+            return true;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if_arg";
+    return false;
+}
+
+// swap
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+void Ordered_list<T, Node_allocator, Ordering>::swap(Ordered_list & other) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::swap";
+
+    std::swap(ordering_function, other.ordering_function);
+    std::swap(first,             other.first);
+    std::swap(length,            other.length);
+    node_allocator.swap(other.node_allocator);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::swap";
+}
+
+// destroy_nodes
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+void Ordered_list<T, Node_allocator, Ordering>::destroy_nodes() {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::destroy_nodes";
+
+    // if there is nothing to destroy in the items, the allocator may be able
+    // to drop all the nodes at once - only the node count needs fixing
+    if (std::is_trivially_destructible<T>::value &&
+        node_allocator.release_all()) {
+        Memory_stats::add(Memory_stats::LIST_NODE, -length,
+                          -length * static_cast<int64_t>(sizeof(Node)));
+    } else {
+        while (0 != first) {
+            Node * const node = first;
+            first = first->next;
+            node->~Node();
+            node_allocator.deallocate(node);
+        }
+    }
+
+    first = 0;
+    length = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::destroy_nodes";
+}
+
+// sort_nodes
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+typename Ordered_list<T, Node_allocator, Ordering>::Node *
+Ordered_list<T, Node_allocator, Ordering>::sort_nodes(Node * chain,
+                                            const int count) const {
+    if (count < 2) {
+        return chain;
+    }
+
+    // split off the first half and sort each half
+    const int half = count / 2;
+    Node * last_of_first_half = chain;
+    for (int i = 1; i < half; i++) {
+        last_of_first_half = last_of_first_half->next;
+    }
+    Node * const second_half = last_of_first_half->next;
+    last_of_first_half->next = 0;
+
+    return merge_nodes(sort_nodes(chain, half),
+                       sort_nodes(second_half, count - half));
+}
+
+// merge_nodes
+template<typename T, template<typename> class Node_allocator,
+         typename Ordering>
+typename Ordered_list<T, Node_allocator, Ordering>::Node *
+Ordered_list<T, Node_allocator, Ordering>::merge_nodes(Node * chain1,
+                                             Node * chain2) const {
+    Node * merged = 0;
+    Node ** tail = &merged;
+
+    // chain2 goes first only if it strictly comes before chain1
+    while ((0 != chain1) && (0 != chain2)) {
+        if (ordering_function(chain2->datum, chain1->datum)) {
+            *tail = chain2;
+            chain2 = chain2->next;
+        } else {
+            *tail = chain1;
+            chain1 = chain1->next;
+        }
+        tail = &(*tail)->next;
+    }
+    *tail = (0 != chain1) ? chain1 : chain2;
+
+    return merged;
+}
+
 #endif  // MEDIAMANAGER_MANAGER_ORDERED_LIST_H_
@@ -7,6 +7,11 @@
  */
 
 
+#include <atomic>
+
+#include "manager/InternedString.h"
+
+
 /* A Record ontains a unique ID number, assigned when the record is created, a
  * rating, and a title and medium name as Strings. Once created, only the
  * rating be modified.
@@ -24,7 +29,8 @@ class Record {
   public:
     // Create a Record object, giving it a unique ID number by first
     // incrementing a static member variable then using its value as the
-    // ID number. The rating is set to 0.
+    // ID number. The rating is set to 0. The medium is interned, so Records
+    // with the same medium share one String.
     Record(const String& medium_, const String& title_);
 
     // Create a Record object suitable for use as a probe containing the
@@ -47,6 +53,12 @@ class Record {
     // variable value.
     explicit Record(const std::ifstream& is);
 
+    /* *** every constructor must call
+     * Memory_stats::allocated(Memory_stats::RECORD, sizeof(Record)), and the
+     * destructor Memory_stats::deallocated(Memory_stats::RECORD,
+     * sizeof(Record)), so that Records show in the pa command */
+    ~Record();
+
     // Accessors
     int get_ID() const
         {/*** fill this in */}
@@ -77,11 +89,19 @@ class Record {
     /* *** fill in a friend declaration for the output operator */
 
   private:
-    static int ID_counter;
+    // atomic so that Snapshot::restore_parallel can raise it to the largest
+    // ID restored from several threads at once, and so that Records can be
+    // created on several threads, each taking its ID with atomic_next
+    static std::atomic<int> ID_counter;
     /* *** another static member variable for the backup value of iD_counter;
      * name is your choice */
     /* *** other private members are your choice */
 
+    // There are only a handful of distinct media across all Records, so the
+    // medium is held as an InternedString; see InternedString::get_pool_size()
+    // for how many distinct media are in use.
+    InternedString medium;
+
     // These declarations help ensure that Record objects are unique
     Record(const Record&);  // disallow copy
     Record& operator= (const Record&);  // disallow assignment
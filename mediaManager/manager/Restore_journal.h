@@ -0,0 +1,221 @@
+#ifndef MEDIAMANAGER_MANAGER_RESTORE_JOURNAL_H_
+#define MEDIAMANAGER_MANAGER_RESTORE_JOURNAL_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Restore_journal.h
+ * @brief Declaration and definition of Restore_journal class template.
+ */
+
+
+/**
+ * @class Restore_journal Restore_journal.h manager/Restore_journal.h
+ *
+ * @brief The objects created so far by a restore, so that a restore that
+ * fails part way through can be undone.
+ *
+ * @details A restore that reads its file in chunks (see Snapshot_reader)
+ * adds each object to the containers as soon as it is read.  Rather than
+ * copying the containers beforehand, which doubles the memory needed, it
+ * notes each object it creates here.  If the file turns out to be bad,
+ * rollback() hands the objects back, newest first, to be removed from the
+ * containers and destroyed; the journal costs one pointer per object.
+ *
+ * Creating a T from a save file may advance the counter used for new ID
+ * numbers, so begin() calls T::save_ID_counter() and rollback() calls
+ * T::restore_ID_counter(), as Record provides.
+ * @verbatim
+   journal.begin();
+   while (reader.next_records(&count) is OK and count > 0)
+       for each Record read
+           create it, add it to the containers, and journal.add() it
+   ... read the Collections the same way ...
+   if anything failed
+       journal.rollback(remove from the containers and delete)
+   else
+       journal.commit()
+   @endverbatim
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename T>
+class Restore_journal {
+  public:
+    /**
+     * Constructor for an empty journal.
+     *
+     * @pre  None.
+     * @post Journal is empty.
+     */
+    Restore_journal();
+
+    /**
+     * Deallocates the journal.  The objects are not affected.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Restore_journal();
+
+    /**
+     * Start a restore: forget any objects noted before and save the ID
+     * counter.
+     *
+     * @pre  None.
+     * @post Journal is empty.
+     */
+    void begin();
+
+    /**
+     * Note an object created by the restore.
+     *
+     * @pre  begin() has been called.
+     * @post object will be handed back by rollback().
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param object The object created
+     */
+    void add(T* const object);
+
+    /**
+     * Keep everything the restore created.
+     *
+     * @pre  None.
+     * @post Journal is empty.
+     */
+    void commit();
+
+    /**
+     * Undo the restore: call undo with each object noted, newest first, and
+     * restore the ID counter saved by begin().
+     *
+     * @pre  begin() has been called.
+     * @post Journal is empty.
+     *
+     * @param undo Function taking a T*, which removes and deletes it
+     */
+    template<typename Undo>
+    void rollback(Undo undo);
+
+    /**
+     * @return the number of objects noted since begin()
+     */
+    int size() const {
+        return mySize;
+    }
+
+  private:
+    /**
+     * The objects noted, oldest first.
+     */
+    T** myObjects;
+    int mySize;
+    int myCapacity;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Restore_journal);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// constructor
+template<typename T>
+Restore_journal<T>::Restore_journal()
+          : myObjects(0),
+            mySize(0),
+            myCapacity(0) {
+    TRACE_VLOG(1) << "Method Entry:  Restore_journal::Restore_journal";
+    TRACE_VLOG(1) << "Method Exit :  Restore_journal::Restore_journal";
+}
+
+// destructor
+template<typename T>
+Restore_journal<T>::~Restore_journal() {
+    TRACE_VLOG(1) << "Method Entry:  Restore_journal::~Restore_journal";
+
+    delete [] myObjects;
+
+    TRACE_VLOG(1) << "Method Exit :  Restore_journal::~Restore_journal";
+}
+
+// begin
+template<typename T>
+void Restore_journal<T>::begin() {
+    TRACE_VLOG(1) << "Method Entry:  Restore_journal::begin";
+
+    mySize = 0;
+    T::save_ID_counter();
+
+    TRACE_VLOG(1) << "Method Exit :  Restore_journal::begin";
+}
+
+// add
+template<typename T>
+void Restore_journal<T>::add(T* const object) {
+    if (mySize == myCapacity) {
+        const int capacity = std::max(16, 2 * myCapacity);
+        T** const objects =
+            new(std::nothrow) T*[static_cast<size_t>(capacity)];
+        if (0 == objects) {
+            LOG(FATAL) << "Restore_journal::add - call to new[] failed!";
+            return;  // unreachable
+        }
+        std::copy(myObjects, myObjects + mySize, objects);
+        delete [] myObjects;
+        myObjects = objects;
+        myCapacity = capacity;
+    }
+
+    myObjects[mySize++] = object;
+}
+
+// commit
+template<typename T>
+void Restore_journal<T>::commit() {
+    TRACE_VLOG(1) << "Method Entry:  Restore_journal::commit";
+
+    mySize = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Restore_journal::commit";
+}
+
+// rollback
+template<typename T>
+template<typename Undo>
+void Restore_journal<T>::rollback(Undo undo) {
+    TRACE_VLOG(1) << "Method Entry:  Restore_journal::rollback";
+    TRACE_VLOG(2) << "Called with arguments\tsize = ->" << mySize << "<-";
+
+    while (mySize > 0) {
+        undo(myObjects[--mySize]);
+    }
+    T::restore_ID_counter();
+
+    TRACE_VLOG(1) << "Method Exit :  Restore_journal::rollback";
+}
+
+#endif  // MEDIAMANAGER_MANAGER_RESTORE_JOURNAL_H_
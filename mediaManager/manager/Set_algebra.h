@@ -0,0 +1,511 @@
+#ifndef MEDIAMANAGER_MANAGER_SET_ALGEBRA_H_
+#define MEDIAMANAGER_MANAGER_SET_ALGEBRA_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Set_algebra.h
+ * @brief Union, intersection and difference of Collections' member lists.
+ *
+ * @details Comparing two Collections by walking the members of one and
+ * calling is_member_present on the other takes O(n*m) time, since each
+ * lookup scans the other member list.  Both lists are already ordered, so
+ * the functions here merge them instead, stepping through each list once:
+ * O(n + m) for two lists.  The batch versions combine K lists at once,
+ * keeping a cursor into each in a Merge_heap ordered by the item it is at,
+ * so that each item costs O(log K) rather than a pass over all K lists, and
+ * "records in no Collection" is the Library merged against all of them.
+ *
+ * Each list L is anything with begin() and end() giving forward iterators,
+ * such as an Ordered_list, whose items are in ascending order according to
+ * ordering, with no two items equivalent; ordering must be the one the lists
+ * are ordered by.  The result is passed to function an item at a time, in
+ * ascending order; to collect it into a new member list, give the items to
+ * that list's insert_range (or insert, for a Sorted_array_storage list,
+ * where adding at the end is cheap).
+ */
+
+
+/**
+ * @class Merge_heap Set_algebra.h manager/Set_algebra.h
+ *
+ * @brief A cursor into each of several ordered lists, the one at the
+ * smallest item on top.
+ *
+ * @details A binary min-heap of (current, last) pairs.  advance() steps the
+ * top cursor and sifts it down, dropping it when its list runs out, so
+ * merging K lists of n items in all takes O(n log K) comparisons.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename Iterator, typename Ordering>
+class Merge_heap {
+  public:
+    /**
+     * Constructor that initializes an empty heap.
+     *
+     * @pre  None.
+     * @post Heap is empty, with room for capacity cursors.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param capacity Largest number of lists to be added
+     * @param ordering The ordering of the lists
+     */
+    Merge_heap(const int capacity, const Ordering& ordering);
+
+    /**
+     * Deallocates the heap.  The lists are not affected.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Merge_heap();
+
+    /**
+     * Add a cursor at the start of the list [first, last); an empty list is
+     * ignored.
+     *
+     * @pre  Fewer than capacity lists have been added.
+     * @post The cursor is in place in the heap.
+     *
+     * @param first Start of the list
+     * @param last  End of the list
+     */
+    void add(const Iterator first, const Iterator last);
+
+    /**
+     * Step the top cursor to the next item of its list, dropping it if there
+     * is none.
+     *
+     * @pre  Heap is not empty.
+     * @post The cursor at the smallest item is on top.
+     */
+    void advance();
+
+    /**
+     * @pre  Heap is not empty.
+     *
+     * @return the top cursor, which is at the smallest item of any list
+     */
+    const Iterator& top() const {
+        return myCursors[0].current;
+    }
+
+    /**
+     * @return the number of lists not yet run out
+     */
+    int size() const {
+        return mySize;
+    }
+
+    /**
+     * @return true if every list has run out
+     */
+    bool empty() const {
+        return 0 == mySize;
+    }
+
+  private:
+    /**
+     * Position in one list.
+     */
+    struct Cursor {
+        Iterator current;
+        Iterator last;
+    };
+
+    /**
+     * @return true if cursor1 is at an item that comes before cursor2's
+     */
+    bool comesBefore(const Cursor& cursor1, const Cursor& cursor2) const {
+        return myOrdering(*cursor1.current, *cursor2.current);
+    }
+
+    /**
+     * Move the cursor at index down until neither child comes before it.
+     */
+    void siftDown(int index);
+
+    /**
+     * The heap; mySize are in use.
+     */
+    Cursor* myCursors;
+
+    int mySize;
+
+    int myCapacity;
+
+    Ordering myOrdering;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Merge_heap);
+};
+
+
+/**
+ * Call function with each item that is in list1, list2 or both.
+ *
+ * @param list1    An ordered list
+ * @param list2    An ordered list
+ * @param ordering The ordering of both lists
+ * @param function Function taking an item
+ */
+template<typename L, typename Ordering, typename Function>
+void merge_union(const L& list1, const L& list2, Ordering ordering,
+                 Function function);
+
+/**
+ * Call function with each item that is in both list1 and list2.
+ *
+ * @param list1    An ordered list
+ * @param list2    An ordered list
+ * @param ordering The ordering of both lists
+ * @param function Function taking an item
+ */
+template<typename L, typename Ordering, typename Function>
+void merge_intersection(const L& list1, const L& list2,
+                        Ordering ordering, Function function);
+
+/**
+ * Call function with each item that is in list1 but not in list2.
+ *
+ * @param list1    An ordered list
+ * @param list2    An ordered list
+ * @param ordering The ordering of both lists
+ * @param function Function taking an item
+ */
+template<typename L, typename Ordering, typename Function>
+void merge_difference(const L& list1, const L& list2,
+                      Ordering ordering, Function function);
+
+/**
+ * Call function with each item that is in any of the lists.
+ *
+ * @warning If memory cannot be allocated, the program will LOG and
+ *          terminate.
+ *
+ * @param lists    Pointers to count ordered lists
+ * @param count    Number of lists
+ * @param ordering The ordering of all the lists
+ * @param function Function taking an item
+ */
+template<typename L, typename Ordering, typename Function>
+void merge_union_all(const L* const* const lists, const int count,
+                     Ordering ordering, Function function);
+
+/**
+ * Call function with each item that is in every one of the lists; with no
+ * lists, there are none.
+ *
+ * @warning If memory cannot be allocated, the program will LOG and
+ *          terminate.
+ *
+ * @param lists    Pointers to count ordered lists
+ * @param count    Number of lists
+ * @param ordering The ordering of all the lists
+ * @param function Function taking an item
+ */
+template<typename L, typename Ordering, typename Function>
+void merge_intersection_all(const L* const* const lists, const int count,
+                            Ordering ordering, Function function);
+
+/**
+ * Call function with each item of library that is in none of the lists,
+ * such as the Records in no Collection.
+ *
+ * @warning If memory cannot be allocated, the program will LOG and
+ *          terminate.
+ *
+ * @param library  An ordered list
+ * @param lists    Pointers to count ordered lists
+ * @param count    Number of lists
+ * @param ordering The ordering of library and all the lists
+ * @param function Function taking an item
+ */
+template<typename L, typename Ordering, typename Function>
+void merge_in_none(const L& library, const L* const* const lists,
+                   const int count, Ordering ordering,
+                   Function function);
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// constructor
+template<typename Iterator, typename Ordering>
+Merge_heap<Iterator, Ordering>::Merge_heap(const int capacity,
+                                           const Ordering& ordering)
+          : myCursors(0),
+            mySize(0),
+            myCapacity(capacity),
+            myOrdering(ordering) {
+    if (0 < capacity) {
+        myCursors = new(std::nothrow) Cursor[static_cast<size_t>(capacity)];
+        if (0 == myCursors) {
+            LOG(FATAL) << "Merge_heap::Merge_heap - call to new[] failed!";
+        }
+    }
+}
+
+// destructor
+template<typename Iterator, typename Ordering>
+Merge_heap<Iterator, Ordering>::~Merge_heap() {
+    delete [] myCursors;
+}
+
+// add
+template<typename Iterator, typename Ordering>
+void Merge_heap<Iterator, Ordering>::add(const Iterator first,
+                                         const Iterator last) {
+    if (first == last) {
+        return;
+    }
+    assert(mySize < myCapacity);
+
+    // sift up
+    int index = mySize++;
+    myCursors[index].current = first;
+    myCursors[index].last = last;
+    while (0 < index) {
+        const int parent = (index - 1) / 2;
+        if (!comesBefore(myCursors[index], myCursors[parent])) {
+            break;
+        }
+        std::swap(myCursors[index], myCursors[parent]);
+        index = parent;
+    }
+}
+
+// advance
+template<typename Iterator, typename Ordering>
+void Merge_heap<Iterator, Ordering>::advance() {
+    assert(0 < mySize);
+
+    ++myCursors[0].current;
+    if (myCursors[0].current == myCursors[0].last) {
+        mySize--;
+        if (0 == mySize) {
+            return;
+        }
+        myCursors[0] = myCursors[mySize];
+    }
+    siftDown(0);
+}
+
+// siftDown
+template<typename Iterator, typename Ordering>
+void Merge_heap<Iterator, Ordering>::siftDown(int index) {
+    for (;;) {
+        int smallest = index;
+        const int left = 2 * index + 1;
+        if ((left < mySize) &&
+            comesBefore(myCursors[left], myCursors[smallest])) {
+            smallest = left;
+        }
+        if ((left + 1 < mySize) &&
+            comesBefore(myCursors[left + 1], myCursors[smallest])) {
+            smallest = left + 1;
+        }
+        if (smallest == index) {
+            return;
+        }
+        std::swap(myCursors[index], myCursors[smallest]);
+        index = smallest;
+    }
+}
+
+
+////////////////////////
+//  SET OPERATIONS    //
+////////////////////////
+
+
+// merge_union
+template<typename L, typename Ordering, typename Function>
+void merge_union(const L& list1, const L& list2, Ordering ordering,
+                 Function function) {
+    TRACE_VLOG(1) << "Method Entry:  merge_union";
+
+    typedef decltype(list1.begin()) Iterator;
+    Iterator it1 = list1.begin();
+    Iterator it2 = list2.begin();
+    while ((list1.end() != it1) && (list2.end() != it2)) {
+        if (ordering(*it1, *it2)) {
+            function(*it1);
+            ++it1;
+        } else if (ordering(*it2, *it1)) {
+            function(*it2);
+            ++it2;
+        } else {
+            function(*it1);
+            ++it1;
+            ++it2;
+        }
+    }
+    for (; list1.end() != it1; ++it1) {
+        function(*it1);
+    }
+    for (; list2.end() != it2; ++it2) {
+        function(*it2);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  merge_union";
+}
+
+// merge_intersection
+template<typename L, typename Ordering, typename Function>
+void merge_intersection(const L& list1, const L& list2,
+                        Ordering ordering, Function function) {
+    TRACE_VLOG(1) << "Method Entry:  merge_intersection";
+
+    typedef decltype(list1.begin()) Iterator;
+    Iterator it1 = list1.begin();
+    Iterator it2 = list2.begin();
+    while ((list1.end() != it1) && (list2.end() != it2)) {
+        if (ordering(*it1, *it2)) {
+            ++it1;
+        } else if (ordering(*it2, *it1)) {
+            ++it2;
+        } else {
+            function(*it1);
+            ++it1;
+            ++it2;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  merge_intersection";
+}
+
+// merge_difference
+template<typename L, typename Ordering, typename Function>
+void merge_difference(const L& list1, const L& list2,
+                      Ordering ordering, Function function) {
+    TRACE_VLOG(1) << "Method Entry:  merge_difference";
+
+    typedef decltype(list1.begin()) Iterator;
+    Iterator it1 = list1.begin();
+    Iterator it2 = list2.begin();
+    while ((list1.end() != it1) && (list2.end() != it2)) {
+        if (ordering(*it1, *it2)) {
+            function(*it1);
+            ++it1;
+        } else {
+            if (!ordering(*it2, *it1)) {
+                ++it1;
+            }
+            ++it2;
+        }
+    }
+    for (; list1.end() != it1; ++it1) {
+        function(*it1);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  merge_difference";
+}
+
+// merge_union_all
+template<typename L, typename Ordering, typename Function>
+void merge_union_all(const L* const* const lists, const int count,
+                     Ordering ordering, Function function) {
+    TRACE_VLOG(1) << "Method Entry:  merge_union_all";
+    TRACE_VLOG(2) << "Called with arguments\tcount = ->" << count << "<-";
+
+    typedef decltype(lists[0]->begin()) Iterator;
+    Merge_heap<Iterator, Ordering> heap(count, ordering);
+    for (int i = 0; i < count; i++) {
+        heap.add(lists[i]->begin(), lists[i]->end());
+    }
+
+    // pass on the smallest item, then skip it in the other lists
+    while (!heap.empty()) {
+        const Iterator smallest = heap.top();
+        function(*smallest);
+        do {
+            heap.advance();
+        } while (!heap.empty() && !ordering(*smallest, *heap.top()));
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  merge_union_all";
+}
+
+// merge_intersection_all
+template<typename L, typename Ordering, typename Function>
+void merge_intersection_all(const L* const* const lists, const int count,
+                            Ordering ordering, Function function) {
+    TRACE_VLOG(1) << "Method Entry:  merge_intersection_all";
+    TRACE_VLOG(2) << "Called with arguments\tcount = ->" << count << "<-";
+
+    typedef decltype(lists[0]->begin()) Iterator;
+    Merge_heap<Iterator, Ordering> heap(count, ordering);
+    for (int i = 0; i < count; i++) {
+        heap.add(lists[i]->begin(), lists[i]->end());
+    }
+
+    // an item is in every list if as many cursors are at it as there are
+    // lists; once any list runs out, nothing further can be
+    while ((0 < count) && (count == heap.size())) {
+        const Iterator smallest = heap.top();
+        int found = 0;
+        do {
+            heap.advance();
+            found++;
+        } while (!heap.empty() && !ordering(*smallest, *heap.top()));
+        if (count == found) {
+            function(*smallest);
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  merge_intersection_all";
+}
+
+// merge_in_none
+template<typename L, typename Ordering, typename Function>
+void merge_in_none(const L& library, const L* const* const lists,
+                   const int count, Ordering ordering,
+                   Function function) {
+    TRACE_VLOG(1) << "Method Entry:  merge_in_none";
+    TRACE_VLOG(2) << "Called with arguments\tcount = ->" << count << "<-";
+
+    typedef decltype(library.begin()) Iterator;
+    Merge_heap<Iterator, Ordering> heap(count, ordering);
+    for (int i = 0; i < count; i++) {
+        heap.add(lists[i]->begin(), lists[i]->end());
+    }
+
+    for (Iterator it = library.begin(); library.end() != it; ++it) {
+        // bring the cursors up to the item; the one on top is then at it if
+        // any list holds it
+        while (!heap.empty() && ordering(*heap.top(), *it)) {
+            heap.advance();
+        }
+        if (heap.empty() || ordering(*it, *heap.top())) {
+            function(*it);
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  merge_in_none";
+}
+
+#endif  // MEDIAMANAGER_MANAGER_SET_ALGEBRA_H_
@@ -0,0 +1,680 @@
+#ifndef MEDIAMANAGER_MANAGER_SKIP_LIST_H_
+#define MEDIAMANAGER_MANAGER_SKIP_LIST_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+#include "glog/logging.h"
+#include "manager/Memory_stats.h"
+#include "manager/Ordered_list.h"
+#include "manager/Utility.h"
+
+
+/*
+ * Skip_list_nodes selects a form of Ordered_list whose nodes are linked into
+ * a skip list, e.g.
+ *   Ordered_list<Record*, Skip_list_nodes> library;
+ *
+ * Besides the ordinary link to the next node, each node has a random number
+ * of links that skip ahead over runs of nodes - about one node in four has a
+ * second link, one in sixteen a third, and so on.  insert, find and erase
+ * start on the highest links and drop down a level each time the next step
+ * would overshoot, so they take O(log n) comparisons instead of O(n).
+ *
+ * The interface and the behavior are the same as for the plain Ordered_list:
+ * iteration visits the items in order, and an item equal to ones already in
+ * the list is placed before them.  Nodes vary in size with their number of
+ * links, so they come straight from the heap rather than from a Node_pool.
+ */
+template<typename Node>
+class Skip_list_nodes;
+
+
+template<typename T, typename Ordering>
+class Ordered_list<T, Skip_list_nodes, Ordering> {
+  private:
+    // Node holds the datum followed by its links, lowest level first; the
+    // links live in the same allocation, just past the Node itself.
+    struct Node {
+        Node(const T& in_datum, const int in_height) :
+            datum(in_datum), height(in_height)
+            {Memory_stats::allocated(Memory_stats::LIST_NODE,
+                                     size_for(height));}
+        ~Node()
+            {Memory_stats::deallocated(Memory_stats::LIST_NODE,
+                                       size_for(height));}
+        // the array of links, one per level
+        Node ** links()
+            {return reinterpret_cast<Node **>(
+                reinterpret_cast<char *>(this) + links_offset());}
+        static size_t links_offset()
+            {return (sizeof(Node) + alignof(Link) - 1) /
+                    alignof(Link) * alignof(Link);}
+        // the size of the allocation for a node with node_height links
+        static size_t size_for(const int node_height)
+            {return links_offset() +
+                    static_cast<size_t>(node_height) * sizeof(Link);}
+        T datum;
+        int height;
+        };
+    // a link to the next node on some level
+    typedef Node * Link;
+
+
+  public:
+    // Enough levels for 4^16 items.
+    static const int max_height = 16;
+
+    // The constructor takes the ordering function, as for the plain
+    // Ordered_list.
+    Ordered_list(const Ordering& ordering_function_ = Ordering());
+
+    // The range constructor builds the list from the items in
+    // [first_datum, last_datum), in any order; see insert_range.
+    template <typename Input_iterator>
+    Ordered_list(Input_iterator first_datum,
+                 Input_iterator last_datum,
+                 const Ordering& ordering_function_ = Ordering());
+
+    // The copy constructor produces a list whose nodes hold copies of the data
+    // in the other list.
+    Ordered_list(const Ordered_list& other);
+
+    // Assignment uses the copy-swap idiom.
+    Ordered_list& operator= (const Ordered_list& rhs);
+
+    // The destructor deallocates all nodes.
+    ~Ordered_list();
+
+    // Delete the nodes in the list, if any, and initialize it.
+    void clear();
+    // Return the number of nodes in the list
+    int size() const
+        {return length;}
+    // Return true if the list is empty
+    bool empty() const
+        {return 0 == head[0];}
+
+    // An Iterator object designates a Node; it follows the lowest level links,
+    // which visit every node in order.
+    class Iterator {
+      public:
+        // default initialize to zero
+        Iterator()
+          : node_ptr(0) {
+        }
+
+        // * returns a reference to the datum in the pointed-to node
+        T& operator* () const {
+            assert(node_ptr);
+            return node_ptr->datum;
+        }
+
+        // -> returns the address of the data in the pointed-to node
+        T* operator-> () const {
+            assert(node_ptr);
+            return &(node_ptr->datum);
+        }
+
+        // ++ operator moves the iterator forward to point to the next node
+        Iterator operator++ () {
+            assert(node_ptr);
+            node_ptr = node_ptr->links()[0];
+            return *this;
+        }
+
+        Iterator operator++ (int) {  // NOLINT(readability/function)
+            assert(node_ptr);
+            Iterator previous(*this);
+            node_ptr = node_ptr->links()[0];
+            return previous;
+        }
+
+        // Iterators ar equal if they point to the same node
+        bool operator== (Iterator rhs) const {
+            return node_ptr == rhs.node_ptr;
+        }
+
+        bool operator!= (Iterator rhs) const {
+            return node_ptr != rhs.node_ptr;
+        }
+
+        friend class Ordered_list;
+
+      private:
+        // Ordered_list uses this to create Iterators pointing to a Node
+        explicit Iterator(Node * in_node_ptr)
+          : node_ptr(in_node_ptr) {
+        }
+
+        Node * node_ptr;
+    };
+    // end of nested Iterator class declaration
+
+    // return an iterator pointing to the first node
+    Iterator begin() const
+        {return Iterator(head[0]);}
+    // return an iterator pointing to "past the end"
+    Iterator end() const
+        {return Iterator(0);}
+
+    // Add the new datum to the list before any "equal" items already there.
+    void insert(const T& new_datum);
+
+    // Add the items in [first_datum, last_datum) to the list, in any order,
+    // with the same result as inserting them one at a time.  The new nodes
+    // are merge sorted on their own and merged into the lowest level, then
+    // the higher levels are relinked in one pass.
+    template <typename Input_iterator>
+    void insert_range(Input_iterator first_datum, Input_iterator last_datum);
+
+    // Delete the specified node.  The iterator is invalid afterwards.
+    void erase(Iterator it);
+
+    // Return an iterator to the first item equal to probe_datum, or end() if
+    // there is none.
+    Iterator find(const T& probe_datum) const;
+
+    // Return an iterator to the first item that does not come before
+    // probe_datum, or end() if there is none.
+    Iterator lower_bound(const T& probe_datum) const;
+
+    // The apply functions work as they do for the plain Ordered_list.
+    template <typename Function>
+    void apply(Function apply_function) const;
+
+    template <typename Function>
+    bool apply_if(Function apply_function) const;
+
+    template <typename Arg, typename Function>
+    void apply_arg(Function apply_function, Arg apply_arg) const;
+
+    template <typename Arg, typename Function>
+    bool apply_if_arg(Function apply_function, Arg apply_arg) const;
+
+    // interchange the member variable values of this list with the other list
+    void swap(Ordered_list & other);  // NOLINT(build/include_what_you_use)
+
+  private:
+    // allocate and construct a node with the given number of levels
+    static Node * new_node(const T& datum, const int node_height);
+    // destroy a node and give its storage back
+    static void delete_node(Node * node);
+
+    // pick the number of levels for a new node
+    int random_height();
+
+    // stable merge sort of a chain of count nodes linked on the lowest level;
+    // returns the new first node
+    Node * sort_nodes(Node * chain, const int count) const;
+    // merge two sorted chains, taking from chain1 first on ties
+    Node * merge_nodes(Node * chain1, Node * chain2) const;
+
+    Ordering ordering_function;
+    // first node on each level, 0 past the end of the level
+    Node * head[max_height];
+    // number of levels in use
+    int height;
+    // number of nodes in the list
+    int length;
+    // state of the generator behind random_height
+    unsigned int random_state;
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename T, typename Ordering>
+const int Ordered_list<T, Skip_list_nodes, Ordering>::max_height;
+
+// constructor
+template<typename T, typename Ordering>
+Ordered_list<T, Skip_list_nodes, Ordering>::Ordered_list(
+        const Ordering& ordering_function_)
+          : ordering_function(ordering_function_),
+            height(0),
+            length(0),
+            random_state(2463534242U) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list";
+
+    std::fill(head, head + max_height, static_cast<Node *>(0));
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list";
+}
+
+// copy constructor
+template<typename T, typename Ordering>
+Ordered_list<T, Skip_list_nodes, Ordering>::Ordered_list(
+        const Ordered_list& other)
+          : ordering_function(other.ordering_function),
+            height(0),
+            length(0),
+            random_state(other.random_state) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list(const "
+                  << "Ordered_list&)";
+
+    std::fill(head, head + max_height, static_cast<Node *>(0));
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+
+    // the other list is already in order, so append at the tail of each level
+    Node ** tails[max_height];
+    std::fill(tails, tails + max_height, static_cast<Node **>(head));
+
+    for (Node * node = other.head[0]; 0 != node; node = node->links()[0]) {
+        const int node_height = random_height();
+        Node * const copy = new_node(node->datum, node_height);
+
+        for (int level = 0; level < node_height; level++) {
+            tails[level][level] = copy;
+            tails[level] = copy->links();
+        }
+
+        height = std::max(height, node_height);
+        length++;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list(const "
+                  << "Ordered_list&)";
+}
+
+// range constructor
+template<typename T, typename Ordering>
+template <typename Input_iterator>
+Ordered_list<T, Skip_list_nodes, Ordering>::Ordered_list(
+        Input_iterator first_datum,
+        Input_iterator last_datum,
+        const Ordering& ordering_function_)
+          : ordering_function(ordering_function_),
+            height(0),
+            length(0),
+            random_state(2463534242U) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list("
+                  << "Input_iterator, Input_iterator)";
+
+    std::fill(head, head + max_height, static_cast<Node *>(0));
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+    insert_range(first_datum, last_datum);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list("
+                  << "Input_iterator, Input_iterator)";
+}
+
+// assignment
+template<typename T, typename Ordering>
+Ordered_list<T, Skip_list_nodes, Ordering>&
+Ordered_list<T, Skip_list_nodes, Ordering>::operator= (
+        const Ordered_list& rhs) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::operator=";
+
+    Ordered_list temp(rhs);
+    swap(temp);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::operator=";
+    return *this;
+}
+
+// destructor
+template<typename T, typename Ordering>
+Ordered_list<T, Skip_list_nodes, Ordering>::~Ordered_list() {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::~Ordered_list";
+
+    clear();
+    Memory_stats::add(Memory_stats::ORDERED_LIST, -1, 0);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::~Ordered_list";
+}
+
+// clear
+template<typename T, typename Ordering>
+void Ordered_list<T, Skip_list_nodes, Ordering>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::clear";
+
+    while (0 != head[0]) {
+        Node * const node = head[0];
+        head[0] = node->links()[0];
+        delete_node(node);
+    }
+
+    std::fill(head, head + max_height, static_cast<Node *>(0));
+    height = 0;
+    length = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::clear";
+}
+
+// insert
+template<typename T, typename Ordering>
+void Ordered_list<T, Skip_list_nodes, Ordering>::insert(const T& new_datum) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::insert";
+
+    // on each level, find the links that the new node goes after: the last
+    // one that comes before the new datum
+    Node ** before[max_height];
+    Node ** links = head;
+    for (int level = height - 1; level >= 0; level--) {
+        while ((0 != links[level]) &&
+               ordering_function(links[level]->datum, new_datum)) {
+            links = links[level]->links();
+        }
+        before[level] = links;
+    }
+
+    const int node_height = random_height();
+    for (int level = height; level < node_height; level++) {
+        before[level] = head;
+    }
+    height = std::max(height, node_height);
+
+    Node * const node = new_node(new_datum, node_height);
+    for (int level = 0; level < node_height; level++) {
+        node->links()[level] = before[level][level];
+        before[level][level] = node;
+    }
+    length++;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::insert";
+}
+
+// insert_range
+template<typename T, typename Ordering>
+template <typename Input_iterator>
+void Ordered_list<T, Skip_list_nodes, Ordering>::insert_range(
+        Input_iterator first_datum,
+        Input_iterator last_datum) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::insert_range";
+
+    // chain the new nodes in reverse on the lowest level, so the stable sort
+    // keeps later items before equal earlier ones, as insert would
+    Node * batch = 0;
+    int count = 0;
+    for (; first_datum != last_datum; ++first_datum) {
+        Node * const node = new_node(*first_datum, random_height());
+        node->links()[0] = batch;
+        batch = node;
+        height = std::max(height, node->height);
+        count++;
+    }
+
+    head[0] = merge_nodes(sort_nodes(batch, count), head[0]);
+    length += count;
+
+    // relink every higher level by walking the lowest one
+    Node ** tails[max_height];
+    std::fill(tails, tails + max_height, static_cast<Node **>(head));
+    for (Node * node = head[0]; 0 != node; node = node->links()[0]) {
+        for (int level = 1; level < node->height; level++) {
+            tails[level][level] = node;
+            tails[level] = node->links();
+        }
+    }
+    for (int level = 1; level < max_height; level++) {
+        tails[level][level] = 0;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::insert_range";
+}
+
+// erase
+template<typename T, typename Ordering>
+void Ordered_list<T, Skip_list_nodes, Ordering>::erase(Iterator it) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::erase";
+
+    Node * const target = it.node_ptr;
+    assert(target);
+
+    // descend as for insert; on the levels the node is on, carry on past any
+    // equal items in front of it and unlink it
+    Node ** links = head;
+    for (int level = height - 1; level >= 0; level--) {
+        while ((0 != links[level]) &&
+               ordering_function(links[level]->datum, target->datum)) {
+            links = links[level]->links();
+        }
+
+        if (level < target->height) {
+            while (links[level] != target) {
+                assert(links[level]);
+                links = links[level]->links();
+            }
+            links[level] = target->links()[level];
+        }
+    }
+
+    while ((height > 0) && (0 == head[height - 1])) {
+        height--;
+    }
+
+    delete_node(target);
+    length--;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::erase";
+}
+
+// find
+template<typename T, typename Ordering>
+typename Ordered_list<T, Skip_list_nodes, Ordering>::Iterator
+Ordered_list<T, Skip_list_nodes, Ordering>::find(const T& probe_datum) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::find";
+
+    Node * node = lower_bound(probe_datum).node_ptr;
+
+    // the node found is equal unless the probe comes before it
+    if ((0 != node) && ordering_function(probe_datum, node->datum)) {
+        node = 0;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::find";
+    return Iterator(node);
+}
+
+// lower_bound
+template<typename T, typename Ordering>
+typename Ordered_list<T, Skip_list_nodes, Ordering>::Iterator
+Ordered_list<T, Skip_list_nodes, Ordering>::lower_bound(
+        const T& probe_datum) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::lower_bound";
+
+    // skip the nodes that come before the probe, highest level first
+    Node * const * links = head;
+    for (int level = height - 1; level >= 0; level--) {
+        while ((0 != links[level]) &&
+               ordering_function(links[level]->datum, probe_datum)) {
+            links = links[level]->links();
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::lower_bound";
+    return Iterator(links[0]);
+}
+
+// apply
+template<typename T, typename Ordering>
+template <typename Function>
+void Ordered_list<T, Skip_list_nodes, Ordering>::apply(
+        Function apply_function) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply";
+
+    for (Node * node = head[0]; 0 != node; node = node->links()[0]) {
+        apply_function(node->datum);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply";
+}
+
+// apply_if
+template<typename T, typename Ordering>
+template <typename Function>
+bool Ordered_list<T, Skip_list_nodes, Ordering>::apply_if(
+        Function apply_function) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_if";
+
+    for (Node * node = head[0]; 0 != node; node = node->links()[0]) {
+        if (apply_function(node->datum)) {
+            TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if";
+            return true;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if";
+    return false;
+}
+
+// apply_arg
+template<typename T, typename Ordering>
+template <typename Arg, typename Function>
+void Ordered_list<T, Skip_list_nodes, Ordering>::apply_arg(
+        Function apply_function,
+        Arg apply_arg) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_arg";
+
+    for (Node * node = head[0]; 0 != node; node = node->links()[0]) {
+        apply_function(node->datum, apply_arg);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_arg";
+}
+
+// apply_if_arg
+template<typename T, typename Ordering>
+template <typename Arg, typename Function>
+bool Ordered_list<T, Skip_list_nodes, Ordering>::apply_if_arg(
+        Function apply_function,
+        Arg apply_arg) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_if_arg";
+
+    for (Node * node = head[0]; 0 != node; node = node->links()[0]) {
+        if (apply_function(node->datum, apply_arg)) {
+            TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if_arg";
+            return true;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if_arg";
+    return false;
+}
+
+// swap
+template<typename T, typename Ordering>
+void Ordered_list<T, Skip_list_nodes, Ordering>::swap(Ordered_list & other) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::swap";
+
+    std::swap(ordering_function, other.ordering_function);
+    std::swap_ranges(head, head + max_height, other.head);
+    std::swap(height,            other.height);
+    std::swap(length,            other.length);
+    std::swap(random_state,      other.random_state);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::swap";
+}
+
+// new_node
+template<typename T, typename Ordering>
+typename Ordered_list<T, Skip_list_nodes, Ordering>::Node *
+Ordered_list<T, Skip_list_nodes, Ordering>::new_node(const T& datum,
+                                           const int node_height) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::new_node";
+
+    const size_t bytes = Node::size_for(node_height);
+    void * const storage = ::operator new(bytes, std::nothrow);
+    if (0 == storage) {
+        LOG(FATAL) << "Ordered_list::new_node - call to new failed!";
+        return 0;  // unreachable
+    }
+
+    Node * const node = new(storage) Node(datum, node_height);
+    std::fill(node->links(), node->links() + node_height,
+              static_cast<Node *>(0));
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::new_node";
+    return node;
+}
+
+// delete_node
+template<typename T, typename Ordering>
+void Ordered_list<T, Skip_list_nodes, Ordering>::delete_node(Node * node) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::delete_node";
+
+    node->~Node();
+    ::operator delete(node);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::delete_node";
+}
+
+// random_height
+template<typename T, typename Ordering>
+int Ordered_list<T, Skip_list_nodes, Ordering>::random_height() {
+    // xorshift32; only needs to be cheap, not good
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    // each further level with probability 1/4
+    unsigned int bits = random_state;
+    int node_height = 1;
+    while ((node_height < max_height) && (0 == (bits & 3U))) {
+        node_height++;
+        bits >>= 2;
+    }
+
+    return node_height;
+}
+
+// sort_nodes
+template<typename T, typename Ordering>
+typename Ordered_list<T, Skip_list_nodes, Ordering>::Node *
+Ordered_list<T, Skip_list_nodes, Ordering>::sort_nodes(Node * chain,
+                                             const int count) const {
+    if (count < 2) {
+        return chain;
+    }
+
+    // split off the first half and sort each half
+    const int half = count / 2;
+    Node * last_of_first_half = chain;
+    for (int i = 1; i < half; i++) {
+        last_of_first_half = last_of_first_half->links()[0];
+    }
+    Node * const second_half = last_of_first_half->links()[0];
+    last_of_first_half->links()[0] = 0;
+
+    return merge_nodes(sort_nodes(chain, half),
+                       sort_nodes(second_half, count - half));
+}
+
+// merge_nodes
+template<typename T, typename Ordering>
+typename Ordered_list<T, Skip_list_nodes, Ordering>::Node *
+Ordered_list<T, Skip_list_nodes, Ordering>::merge_nodes(Node * chain1,
+                                              Node * chain2) const {
+    Node * merged = 0;
+    Node ** tail = &merged;
+
+    // chain2 goes first only if it strictly comes before chain1
+    while ((0 != chain1) && (0 != chain2)) {
+        if (ordering_function(chain2->datum, chain1->datum)) {
+            *tail = chain2;
+            chain2 = chain2->links()[0];
+        } else {
+            *tail = chain1;
+            chain1 = chain1->links()[0];
+        }
+        tail = &(*tail)->links()[0];
+    }
+    *tail = (0 != chain1) ? chain1 : chain2;
+
+    return merged;
+}
+
+#endif  // MEDIAMANAGER_MANAGER_SKIP_LIST_H_
@@ -0,0 +1,426 @@
+#ifndef MEDIAMANAGER_MANAGER_SLOT_MAP_H_
+#define MEDIAMANAGER_MANAGER_SLOT_MAP_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "glog/logging.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Slot_map.h
+ * @brief Declaration and definition of Slot_map class template.
+ */
+
+
+/**
+ * @class Slot_map Slot_map.h manager/Slot_map.h
+ *
+ * @brief Owning store of objects, e.g. Records, kept next to each other in
+ * one array and referred to by handles that detect when their object is
+ * gone.
+ *
+ * @details Objects allocated one at a time with new end up scattered over
+ * the heap, so visiting all of them touches a cache line or more per object,
+ * and a pointer to one that has been deleted cannot be told from a good one.
+ * A Slot_map keeps its objects in a single array with no gaps, so visiting
+ * them all, through data() and size(), is a linear scan.  Other containers,
+ * such as the member lists of Collections, hold a Handle instead of a
+ * pointer: an index into a table of slots, which say where each object
+ * currently is, and a generation number.  Erasing an object moves the last
+ * object into its place, updates that object's slot, and advances the
+ * generation of the erased object's slot, so every Handle to it becomes
+ * stale in O(1) without finding the containers that hold it; get() returns
+ * NULL for a stale Handle.
+ * @verbatim
+   slots     [0: at 2, gen 1] [1: free, gen 2] [2: at 0, gen 3] ...
+   objects   [slot 2's object] [slot 4's object] [slot 0's object] ...
+   @endverbatim
+ * A slot's generation is odd while it holds an object and even while it is
+ * free, and freed slots are reused, newest first, by later objects.  A
+ * Handle is only mistaken for a newer object's after its slot has been
+ * reused 2^31 times.
+ *
+ * Handles stay valid as objects are added and erased, but pointers and
+ * references to the objects do not: adding may move the whole array, and
+ * erasing moves the last object, which also changes the order data() visits
+ * them in.  T needs a move constructor.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename T>
+class Slot_map {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * Refers to an object in the map, or to none.
+     */
+    struct Handle {
+        /** Slot of the object, or -1 for no object. */
+        int slot;
+
+        /** Generation of the slot when the object was added. */
+        unsigned int generation;
+
+        bool operator== (const Handle other) const {
+            return (slot == other.slot) && (generation == other.generation);
+        }
+
+        bool operator!= (const Handle other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * Number of objects there is room for when the first one is added.
+     */
+    static const int ourMinCapacity = 16;
+
+    /**
+     * @return a Handle that refers to no object in any map
+     */
+    static Handle null_handle() {
+        const Handle handle = {-1, 0};
+        return handle;
+    }
+
+    /**
+     * Constructor that initializes an empty map; nothing is allocated until
+     * the first object is added.
+     *
+     * @pre  None.
+     * @post Map is empty.
+     */
+    Slot_map();
+
+    /**
+     * Destroys every object and deallocates the map.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Slot_map();
+
+    /**
+     * Add an object, constructed in place from args.
+     *
+     * @pre  None.
+     * @post The object is the last one in data().
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param args Arguments for the constructor of T
+     *
+     * @return the Handle of the new object
+     */
+    template<typename... Args>
+    Handle emplace(Args&&... args);
+
+    /**
+     * Destroy an object.  The last object in data() takes its place.
+     *
+     * @pre  None.
+     * @post Every Handle to the object is stale.
+     *
+     * @param handle Handle of the object
+     *
+     * @return ERROR if handle is stale or refers to no object, otherwise OK
+     */
+    Status erase(const Handle handle);
+
+    /**
+     * @param handle Handle of an object
+     *
+     * @return the object, or NULL if handle is stale or refers to no object
+     */
+    T* get(const Handle handle);
+    const T* get(const Handle handle) const;
+
+    /**
+     * @param handle Handle of an object
+     *
+     * @return true if handle refers to an object in the map
+     */
+    bool contains(const Handle handle) const;
+
+    /**
+     * Destroy every object.  The storage is kept for reuse.
+     *
+     * @pre  None.
+     * @post Map is empty, and every Handle to its objects is stale.
+     */
+    void clear();
+
+    /**
+     * Make room for at least count objects without moving them.
+     *
+     * @pre  None.
+     * @post Map holds the same objects.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param count Number of objects to make room for
+     */
+    void reserve(const int count);
+
+    /**
+     * @return the number of objects in the map
+     */
+    int size() const {
+        return mySize;
+    }
+
+    /**
+     * @return the objects, size() of them next to each other, in no
+     *         particular order
+     */
+    T* data() {
+        return myObjects;
+    }
+
+    const T* data() const {
+        return myObjects;
+    }
+
+    /**
+     * @param i Position of an object in data(), 0 through size() - 1
+     *
+     * @return the Handle of the object
+     */
+    Handle handle_at(const int i) const {
+        const Handle handle = {mySlotOf[i], mySlots[mySlotOf[i]].generation};
+        return handle;
+    }
+
+  private:
+    /**
+     * Where an object is, or the next free slot while the slot is free.
+     */
+    struct Slot {
+        /** Position of the object, or next free slot (-1 for none). */
+        int position;
+
+        /** Odd while the slot holds an object, even while it is free. */
+        unsigned int generation;
+    };
+
+    /**
+     * The objects; the first mySize are constructed.
+     */
+    T*   myObjects;
+    int* mySlotOf;
+    int  mySize;
+    int  myCapacity;
+
+    /**
+     * The slots, of which mySlotCount have been used.
+     */
+    Slot* mySlots;
+    int   mySlotCount;
+    int   mySlotCapacity;
+
+    /**
+     * Most recently freed slot, or -1.
+     */
+    int myFreeSlot;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Slot_map);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename T>
+const int Slot_map<T>::ourMinCapacity;
+
+// constructor
+template<typename T>
+Slot_map<T>::Slot_map()
+          : myObjects(0),
+            mySlotOf(0),
+            mySize(0),
+            myCapacity(0),
+            mySlots(0),
+            mySlotCount(0),
+            mySlotCapacity(0),
+            myFreeSlot(-1) {
+    TRACE_VLOG(1) << "Method Entry:  Slot_map::Slot_map";
+    TRACE_VLOG(1) << "Method Exit :  Slot_map::Slot_map";
+}
+
+// destructor
+template<typename T>
+Slot_map<T>::~Slot_map() {
+    TRACE_VLOG(1) << "Method Entry:  Slot_map::~Slot_map";
+
+    for (int i = 0; i < mySize; i++) {
+        myObjects[i].~T();
+    }
+    ::operator delete(myObjects);
+    delete [] mySlotOf;
+    delete [] mySlots;
+
+    TRACE_VLOG(1) << "Method Exit :  Slot_map::~Slot_map";
+}
+
+// emplace
+template<typename T>
+template<typename... Args>
+typename Slot_map<T>::Handle Slot_map<T>::emplace(Args&&... args) {
+    reserve(mySize + 1);
+
+    // a freed slot is reused before a new one is taken
+    int slot = myFreeSlot;
+    if (-1 != slot) {
+        myFreeSlot = mySlots[slot].position;
+    } else {
+        if (mySlotCount == mySlotCapacity) {
+            const int capacity = std::max(static_cast<int>(ourMinCapacity),
+                                          2 * mySlotCapacity);
+            Slot* const slots =
+                new(std::nothrow) Slot[static_cast<size_t>(capacity)];
+            if (0 == slots) {
+                LOG(FATAL) << "Slot_map::emplace - call to new[] failed!";
+                return null_handle();  // unreachable
+            }
+            std::copy(mySlots, mySlots + mySlotCount, slots);
+            delete [] mySlots;
+            mySlots = slots;
+            mySlotCapacity = capacity;
+        }
+        slot = mySlotCount++;
+        mySlots[slot].generation = 0;
+    }
+
+    new(myObjects + mySize) T(std::forward<Args>(args)...);
+    mySlotOf[mySize] = slot;
+    mySlots[slot].position = mySize;
+    mySlots[slot].generation++;
+    mySize++;
+
+    const Handle handle = {slot, mySlots[slot].generation};
+    return handle;
+}
+
+// erase
+template<typename T>
+typename Slot_map<T>::Status Slot_map<T>::erase(const Handle handle) {
+    if (!contains(handle)) {
+        return ERROR;
+    }
+
+    // the last object fills the hole
+    Slot& slot = mySlots[handle.slot];
+    const int hole = slot.position;
+    const int last = mySize - 1;
+    myObjects[hole].~T();
+    if (hole != last) {
+        new(myObjects + hole) T(std::move(myObjects[last]));
+        myObjects[last].~T();
+        mySlotOf[hole] = mySlotOf[last];
+        mySlots[mySlotOf[hole]].position = hole;
+    }
+    mySize--;
+
+    slot.generation++;
+    slot.position = myFreeSlot;
+    myFreeSlot = handle.slot;
+    return OK;
+}
+
+// get
+template<typename T>
+T* Slot_map<T>::get(const Handle handle) {
+    return contains(handle) ? myObjects + mySlots[handle.slot].position : 0;
+}
+
+template<typename T>
+const T* Slot_map<T>::get(const Handle handle) const {
+    return contains(handle) ? myObjects + mySlots[handle.slot].position : 0;
+}
+
+// contains
+template<typename T>
+bool Slot_map<T>::contains(const Handle handle) const {
+    // a free slot's generation is even, so matches no Handle
+    return (handle.slot >= 0) && (handle.slot < mySlotCount) &&
+           (handle.generation == mySlots[handle.slot].generation) &&
+           (0 != (handle.generation & 1U));
+}
+
+// clear
+template<typename T>
+void Slot_map<T>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Slot_map::clear";
+
+    for (int i = 0; i < mySize; i++) {
+        myObjects[i].~T();
+        const int slot = mySlotOf[i];
+        mySlots[slot].generation++;
+        mySlots[slot].position = myFreeSlot;
+        myFreeSlot = slot;
+    }
+    mySize = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Slot_map::clear";
+}
+
+// reserve
+template<typename T>
+void Slot_map<T>::reserve(const int count) {
+    if (count <= myCapacity) {
+        return;
+    }
+
+    TRACE_VLOG(1) << "Method Entry:  Slot_map::reserve";
+    TRACE_VLOG(2) << "Called with arguments\tcount = ->" << count << "<-";
+
+    const int capacity = std::max(std::max(count, 2 * myCapacity),
+                                  static_cast<int>(ourMinCapacity));
+    T* const objects = static_cast<T*>(::operator new(
+        sizeof(T) * static_cast<size_t>(capacity), std::nothrow));
+    int* const slotOf = new(std::nothrow) int[static_cast<size_t>(capacity)];
+    if ((0 == objects) || (0 == slotOf)) {
+        LOG(FATAL) << "Slot_map::reserve - call to new failed!";
+        return;  // unreachable
+    }
+
+    for (int i = 0; i < mySize; i++) {
+        new(objects + i) T(std::move(myObjects[i]));
+        myObjects[i].~T();
+    }
+    std::copy(mySlotOf, mySlotOf + mySize, slotOf);
+    ::operator delete(myObjects);
+    delete [] mySlotOf;
+    myObjects = objects;
+    mySlotOf = slotOf;
+    myCapacity = capacity;
+
+    TRACE_VLOG(1) << "Method Exit :  Slot_map::reserve";
+}
+
+#endif  // MEDIAMANAGER_MANAGER_SLOT_MAP_H_
@@ -0,0 +1,810 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/Snapshot.h"
+
+#include <algorithm>
+#include <atomic>  // NOLINT(build/include_order)
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <istream>  // NOLINT(readability/streams)
+#include <new>
+  using std::nothrow;
+#include <ostream>  // NOLINT(readability/streams)
+#include <streambuf>  // NOLINT(build/include_order)
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "glog/logging.h"
+
+#include "manager/Id_index.h"
+#include "manager/InternedString.h"
+#include "manager/Snapshot_reader.h"
+#include "manager/String.h"
+#include "manager/String_view.h"
+#include "manager/Utility.h"
+
+
+// initialize static members
+const char Snapshot::ourMagic[4] = {'\x89', 'M', 'M', 'S'};
+const int  Snapshot::ourVersion;
+const int  Snapshot::ourMaxRating;
+
+// counts read from a file are only trusted this far when allocating, so a
+// damaged file cannot ask for an absurd amount of memory up front - anything
+// bigger grows as the data actually arrives
+static const int reserveLimit = 1 << 16;
+
+// smallest part of a text file worth parsing on a thread of its own
+static const ptrdiff_t minPartSize = 4096;
+
+// number of distinct media a restore shares without interning each Record's
+// again; there are usually only a handful
+static const int mediaCacheSize = 16;
+
+// read-only stream buffer over characters already in memory, so a part of a
+// file can be parsed without copying it
+class Memory_buffer : public std::streambuf {
+  public:
+    Memory_buffer(const char* const begin, const char* const end) {
+        setg(const_cast<char*>(begin), const_cast<char*>(begin),
+             const_cast<char*>(end));
+    }
+
+    // the next character to be read
+    const char* position() const {
+        return gptr();
+    }
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(Memory_buffer);
+};
+
+
+// the lines of a text file that one thread parses into Records
+struct Part {
+    const char*      begin;
+    const char*      end;
+    int              lines;
+    int              records;
+    Snapshot_reader* reader;
+    bool             valid;
+};
+
+// call function(0) through function(count - 1), each on a thread of its own;
+// the calling thread takes 0
+template<typename Function>
+static void runOnThreads(const int count, Function function) {
+    std::thread* const threads =
+        new(nothrow) std::thread[static_cast<size_t>(count)];
+    if (0 == threads) {
+        LOG(FATAL) << "runOnThreads - call to new[] failed!";
+        return;  // unreachable
+    }
+
+    for (int i = 1; i < count; i++) {
+        threads[i] = std::thread(function, i);
+    }
+    function(0);
+    for (int i = 1; i < count; i++) {
+        threads[i].join();
+    }
+    delete [] threads;
+}
+
+// parse the Records of part, and raise maxID to the largest of their IDs
+static void parsePart(Part* const part, std::atomic<int>* const maxID) {
+    part->valid = true;
+    if (0 == part->records) {
+        return;
+    }
+
+    part->reader = new(nothrow) Snapshot_reader(part->records);
+    if (0 == part->reader) {
+        LOG(FATAL) << "parsePart - call to new failed!";
+        return;  // unreachable
+    }
+
+    Memory_buffer buffer(part->begin, part->end);
+    std::istream is(&buffer);
+    part->reader->open_text_part(&is, part->records);
+    int count;
+    part->valid = (Snapshot_reader::OK == part->reader->next_records(&count)) &&
+                  (part->records == count);
+
+    int largest = 0;
+    for (int i = 0; part->valid && (i < count); i++) {
+        largest = std::max(largest, part->reader->get_record(i).ID);
+    }
+    atomic_max(maxID, largest);
+}
+
+// the start of the line following the one that position is in
+static const char* nextLine(const char* const position,
+                            const char* const end) {
+    const void* const newline =
+        memchr(position, '\n', static_cast<size_t>(end - position));
+    return (0 == newline) ? end : static_cast<const char*>(newline) + 1;
+}
+
+// whether the line from position to lineEnd holds anything but white space
+static bool hasText(const char* position, const char* const lineEnd) {
+    for (; position != lineEnd; position++) {
+        if (!isspace(static_cast<unsigned char>(*position))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// the number of lines in [begin, end) that are not blank
+static int countTextLines(const char* position, const char* const end) {
+    int lines = 0;
+    while (position != end) {
+        const char* const next = nextLine(position, end);
+        if (hasText(position, next)) {
+            lines++;
+        }
+        position = next;
+    }
+    return lines;
+}
+
+// the start of the line following the count'th line from position that is
+// not blank
+static const char* skipTextLines(const char* position,
+                                 const char* const end,
+                                 int count) {
+    while ((0 != count) && (position != end)) {
+        const char* const next = nextLine(position, end);
+        if (hasText(position, next)) {
+            count--;
+        }
+        position = next;
+    }
+    return position;
+}
+
+
+// move the count items at items into new raw storage for capacity items, and
+// free the old storage; only the first count slots hold constructed items
+template<typename T>
+static T* growStorage(T* const items, const int count, const int capacity) {
+    T* const grown = static_cast<T*>(
+        ::operator new(sizeof(T) * static_cast<size_t>(capacity), nothrow));
+    if (0 == grown) {
+        LOG(FATAL) << "growStorage - call to operator new failed!";
+        return 0;  // unreachable
+    }
+
+    for (int i = 0; i < count; i++) {
+        new(grown + i) T(std::move(items[i]));
+        items[i].~T();
+    }
+    ::operator delete(items);
+    return grown;
+}
+
+// destroy the count items at items and free the storage
+template<typename T>
+static void destroyStorage(T* const items, const int count) {
+    for (int i = 0; i < count; i++) {
+        items[i].~T();
+    }
+    ::operator delete(items);
+}
+
+
+////////////////////////
+//  BINARY FORMAT     //
+////////////////////////
+
+
+// write a little-endian 32-bit field
+static void putU32(std::ostream* os, const unsigned int value) {
+    const char bytes[4] = {static_cast<char>(value & 0xFFU),
+                           static_cast<char>((value >> 8) & 0xFFU),
+                           static_cast<char>((value >> 16) & 0xFFU),
+                           static_cast<char>((value >> 24) & 0xFFU)};
+    os->write(bytes, sizeof(bytes));
+}
+
+// write a length-prefixed string
+static void putString(std::ostream* os, const char* const cstr) {
+    const size_t length = strlen(cstr);
+    putU32(os, static_cast<unsigned int>(length));
+    os->write(cstr, static_cast<std::streamsize>(length));
+}
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// constructor
+Snapshot::Snapshot()
+          : myRecords(0),
+            myRecordCount(0),
+            myRecordCapacity(0),
+            myCollections(0),
+            myCollectionCount(0),
+            myCollectionCapacity(0),
+            myMembers(0),
+            myMemberCount(0),
+            myMemberCapacity(0) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::Snapshot";
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::Snapshot";
+}
+
+// destructor
+Snapshot::~Snapshot() {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::~Snapshot";
+
+    clear();
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::~Snapshot";
+}
+
+// add_record
+void Snapshot::add_record(const int ID,
+                          const int rating,
+                          const char* const medium,
+                          const char* const title) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::add_record";
+    TRACE_VLOG(2) << "Called with arguments\tID = ->" << ID
+                  << "<-\ttitle = ->" << title << "<-";
+
+    newRecord(ID, rating, title).medium.init(medium);
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::add_record";
+}
+
+// add_collection
+void Snapshot::add_collection(const char* const name) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::add_collection";
+    TRACE_VLOG(2) << "Called with arguments\tname = ->" << name << "<-";
+
+    reserveCollections(myCollectionCount + 1);
+
+    Collection_data& collection =
+        *new(myCollections + myCollectionCount) Collection_data;
+    myCollectionCount++;
+    collection.name.init(name);
+    collection.first_member = myMemberCount;
+    collection.member_count = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::add_collection";
+}
+
+// add_member
+void Snapshot::add_member(const int ID) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::add_member";
+    TRACE_VLOG(2) << "Called with arguments\tID = ->" << ID << "<-";
+
+    reserveMembers(myMemberCount + 1);
+
+    myMembers[myMemberCount++] = ID;
+    myCollections[myCollectionCount - 1].member_count++;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::add_member";
+}
+
+// clear
+void Snapshot::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::clear";
+
+    destroyStorage(myRecords, myRecordCount);
+    myRecords = 0;
+    myRecordCount = 0;
+    myRecordCapacity = 0;
+
+    destroyStorage(myCollections, myCollectionCount);
+    myCollections = 0;
+    myCollectionCount = 0;
+    myCollectionCapacity = 0;
+
+    delete [] myMembers;
+    myMembers = 0;
+    myMemberCount = 0;
+    myMemberCapacity = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::clear";
+}
+
+// save
+Snapshot::Status Snapshot::save(std::ostream* const os,
+                                const Format format) const {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::save";
+    TRACE_VLOG(2) << "Called with arguments\tformat = ->" << format << "<-";
+
+    const Status status = (TEXT == format) ? saveText(os) : saveBinary(os);
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::save";
+    return status;
+}
+
+// restore
+Snapshot::Status Snapshot::restore(std::istream* const is) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::restore";
+
+    clear();
+
+    Snapshot_reader reader;
+    Status status = (Snapshot_reader::OK == reader.open(is)) ? OK : ERROR;
+    if (OK == status) {
+        status = restoreRecords(&reader);
+    }
+    if (OK == status) {
+        status = restoreCollections(&reader);
+    }
+    if (OK == status) {
+        Id_index<const Record_data> index;
+        status = validate(&index);
+    }
+
+    if (OK != status) {
+        clear();
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::restore";
+    return status;
+}
+
+// restore_parallel
+Snapshot::Status Snapshot::restore_parallel(
+        const char* const data, const size_t size, const int threads,
+        std::atomic<int>* const ID_counter) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::restore_parallel";
+    TRACE_VLOG(2) << "Called with arguments\tsize = ->" << size
+                  << "<-\tthreads = ->" << threads << "<-";
+
+    clear();
+
+    const char* const end = data + size;
+    Memory_buffer buffer(data, end);
+    std::istream is(&buffer);
+
+    // a binary file is already quick to read, and cannot be split without
+    // reading it
+    if ((0 != size) && (ourMagic[0] == data[0])) {
+        Status status = restore(&is);
+        if ((OK == status) && (0 != ID_counter)) {
+            for (int i = 0; i < myRecordCount; i++) {
+                atomic_max(ID_counter, myRecords[i].ID);
+            }
+        }
+        TRACE_VLOG(1) << "Method Exit :  Snapshot::restore_parallel";
+        return status;
+    }
+
+    Snapshot_reader header;
+    if (Snapshot_reader::OK != header.open(&is)) {
+        TRACE_VLOG(1) << "Method Exit :  Snapshot::restore_parallel";
+        return ERROR;
+    }
+    const int recordCount = header.get_record_count();
+    const char* const begin = buffer.position();
+
+    // split the rest of the file into parts of about the same size, each
+    // starting at a line, and count their lines that are not blank; a part
+    // too small to be worth a thread is not split further
+    const int partCount = static_cast<int>(std::max(ptrdiff_t(1), std::min(
+        static_cast<ptrdiff_t>(threads), (end - begin) / minPartSize)));
+    Part* const parts = new(nothrow) Part[static_cast<size_t>(partCount)];
+    if (0 == parts) {
+        LOG(FATAL) << "Snapshot::restore_parallel - call to new[] failed!";
+        return ERROR;  // unreachable
+    }
+    for (int k = 0; k < partCount; k++) {
+        const ptrdiff_t offset = (end - begin) * k / partCount;
+        parts[k].begin = (0 == k) ?
+            begin : std::max(nextLine(begin + offset - 1, end),
+                             parts[k - 1].begin);
+        parts[k].reader = 0;
+    }
+    for (int k = 0; k < partCount; k++) {
+        parts[k].end = (k + 1 < partCount) ? parts[k + 1].begin : end;
+    }
+    runOnThreads(partCount, [parts](const int k) {
+        parts[k].lines = countTextLines(parts[k].begin, parts[k].end);
+    });
+
+    // the first recordCount lines that are not blank are the Records - one
+    // per line, as save() writes them and restore() reads them - and the
+    // Collections follow
+    int lines = 0;
+    const char* recordsEnd = end;
+    for (int k = 0; k < partCount; k++) {
+        Part& part = parts[k];
+        part.records =
+            std::max(0, std::min(recordCount - lines, part.lines));
+        if ((part.records < part.lines) && (end == recordsEnd)) {
+            recordsEnd = skipTextLines(part.begin, part.end, part.records);
+        }
+        part.end = std::min(part.end, recordsEnd);
+        lines += part.lines;
+    }
+
+    std::atomic<int> maxID(0);
+    Status status = OK;
+    if (lines < recordCount) {
+        LOG(ERROR) << "Snapshot::restore_parallel - truncated file!";
+        status = ERROR;
+    } else {
+        runOnThreads(partCount, [parts, &maxID](const int k) {
+            parsePart(&parts[k], &maxID);
+        });
+    }
+
+    // build the Records on this thread, in file order
+    reserveRecords(std::min(recordCount, reserveLimit));
+    for (int k = 0; (OK == status) && (k < partCount); k++) {
+        const Part& part = parts[k];
+        status = part.valid ? OK : ERROR;
+        for (int i = 0; (OK == status) && (i < part.records); i++) {
+            const Snapshot_reader::Record_view& record =
+                part.reader->get_record(i);
+            newRecord(record.ID, record.rating, record.title.data())
+                .medium.init(record.medium.data());
+        }
+    }
+    for (int k = 0; k < partCount; k++) {
+        delete parts[k].reader;
+    }
+    delete [] parts;
+
+    if (OK == status) {
+        Memory_buffer rest(recordsEnd, end);
+        std::istream restStream(&rest);
+        Snapshot_reader reader;
+        reader.open_text_part(&restStream, 0);
+        status = restoreCollections(&reader);
+    }
+    if (OK == status) {
+        Id_index<const Record_data> index;
+        status = validate(&index);
+    }
+
+    if (OK != status) {
+        clear();
+    } else if (0 != ID_counter) {
+        atomic_max(ID_counter, maxID.load());
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::restore_parallel";
+    return status;
+}
+
+// convert
+Snapshot::Status Snapshot::convert(std::istream* const is,
+                                   std::ostream* const os,
+                                   const Format format) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::convert";
+
+    Snapshot snapshot;
+    Status status = snapshot.restore(is);
+    if (OK == status) {
+        status = snapshot.save(os, format);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::convert";
+    return status;
+}
+
+// saveText
+Snapshot::Status Snapshot::saveText(std::ostream* const os) const {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::saveText";
+
+    // members are saved by title
+    Id_index<const Record_data> index;
+    if (OK != validate(&index)) {
+        TRACE_VLOG(1) << "Method Exit :  Snapshot::saveText";
+        return ERROR;
+    }
+
+    *os << myRecordCount << '\n';
+    for (int i = 0; i < myRecordCount; i++) {
+        const Record_data& record = myRecords[i];
+        *os << record.ID << ' ' << record.medium.c_str() << ' '
+           << record.rating << ' ' << record.title.c_str() << '\n';
+    }
+
+    *os << myCollectionCount << '\n';
+    for (int i = 0; i < myCollectionCount; i++) {
+        const Collection_data& collection = myCollections[i];
+        *os << collection.name.c_str() << ' ' << collection.member_count
+           << '\n';
+        const int* const members = get_members(collection);
+        for (int j = 0; j < collection.member_count; j++) {
+            *os << index.find(members[j])->title.c_str() << '\n';
+        }
+    }
+
+    const Status status = os->good() ? OK : ERROR;
+    if (OK != status) {
+        LOG(ERROR) << "Snapshot::saveText - write failed!";
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::saveText";
+    return status;
+}
+
+// saveBinary
+Snapshot::Status Snapshot::saveBinary(std::ostream* const os) const {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::saveBinary";
+
+    if (OK != validate(0)) {
+        TRACE_VLOG(1) << "Method Exit :  Snapshot::saveBinary";
+        return ERROR;
+    }
+
+    // collect the distinct media, in order, for the string table
+    const char** const media =
+        new(nothrow) const char*[static_cast<size_t>(myRecordCount + 1)];
+    if (0 == media) {
+        LOG(FATAL) << "Snapshot::saveBinary - call to new[] failed!";
+        return ERROR;  // unreachable
+    }
+    const auto before = [](const char* const m1, const char* const m2) {
+        return strcmp(m1, m2) < 0;
+    };
+    int mediaCount = 0;
+    for (int i = 0; i < myRecordCount; i++) {
+        const char* const medium = myRecords[i].medium.c_str();
+        const char** const position =
+            std::lower_bound(media, media + mediaCount, medium, before);
+        if ((media + mediaCount == position) ||
+            (0 != strcmp(*position, medium))) {
+            std::copy_backward(position, media + mediaCount,
+                               media + mediaCount + 1);
+            *position = medium;
+            mediaCount++;
+        }
+    }
+
+    os->write(ourMagic, sizeof(ourMagic));
+    putU32(os, static_cast<unsigned int>(ourVersion));
+
+    putU32(os, static_cast<unsigned int>(mediaCount));
+    for (int i = 0; i < mediaCount; i++) {
+        putString(os, media[i]);
+    }
+
+    putU32(os, static_cast<unsigned int>(myRecordCount));
+    for (int i = 0; i < myRecordCount; i++) {
+        const Record_data& record = myRecords[i];
+        const char* const medium = record.medium.c_str();
+        const char** const position =
+            std::lower_bound(media, media + mediaCount, medium, before);
+
+        putU32(os, static_cast<unsigned int>(record.ID));
+        os->put(static_cast<char>(record.rating));
+        putU32(os, static_cast<unsigned int>(position - media));
+        putString(os, record.title.c_str());
+    }
+    delete [] media;
+
+    putU32(os, static_cast<unsigned int>(myCollectionCount));
+    for (int i = 0; i < myCollectionCount; i++) {
+        const Collection_data& collection = myCollections[i];
+        putString(os, collection.name.c_str());
+        putU32(os, static_cast<unsigned int>(collection.member_count));
+        const int* const members = get_members(collection);
+        for (int j = 0; j < collection.member_count; j++) {
+            putU32(os, static_cast<unsigned int>(members[j]));
+        }
+    }
+
+    const Status status = os->good() ? OK : ERROR;
+    if (OK != status) {
+        LOG(ERROR) << "Snapshot::saveBinary - write failed!";
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::saveBinary";
+    return status;
+}
+
+// restoreRecords
+Snapshot::Status Snapshot::restoreRecords(Snapshot_reader* const reader) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::restoreRecords";
+
+    reserveRecords(std::min(reader->get_record_count(), reserveLimit));
+
+    // the media of a binary file stay put in the reader, so each one is
+    // interned the first time it is seen and then recognized by its address
+    const bool byAddress = Snapshot::BINARY == reader->get_format();
+    const char*    addresses[mediaCacheSize];
+    InternedString media[mediaCacheSize];  // NOLINT(runtime/arrays)
+    int            mediaCount = 0;
+
+    int count = 0;
+    do {
+        if (Snapshot_reader::OK != reader->next_records(&count)) {
+            TRACE_VLOG(1) << "Method Exit :  Snapshot::restoreRecords";
+            return ERROR;
+        }
+        for (int i = 0; i < count; i++) {
+            const Snapshot_reader::Record_view& record = reader->get_record(i);
+            InternedString& medium =
+                newRecord(record.ID, record.rating, record.title.data()).medium;
+
+            const char* const address = record.medium.data();
+            int cached = 0;
+            while ((cached < mediaCount) && (addresses[cached] != address)) {
+                cached++;
+            }
+            if (cached < mediaCount) {
+                medium = media[cached];
+            } else {
+                medium.init(address);
+                if (byAddress && (mediaCount < mediaCacheSize)) {
+                    addresses[mediaCount] = address;
+                    media[mediaCount++] = medium;
+                }
+            }
+        }
+    } while (count > 0);
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::restoreRecords";
+    return OK;
+}
+
+// restoreCollections
+Snapshot::Status Snapshot::restoreCollections(
+        Snapshot_reader* const reader) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::restoreCollections";
+
+    // members of a text file are saved by title, so look them up in the
+    // Records sorted by title
+    const bool byID = Snapshot::BINARY == reader->get_format();
+    const int sortedCount = byID ? 0 : myRecordCount;
+    int* const byTitle =
+        new(nothrow) int[static_cast<size_t>(std::max(1, sortedCount))];
+    if (0 == byTitle) {
+        LOG(FATAL) << "Snapshot::restoreCollections - call to new[] failed!";
+        return ERROR;  // unreachable
+    }
+    for (int i = 0; i < sortedCount; i++) {
+        byTitle[i] = i;
+    }
+    const Record_data* const records = myRecords;
+    std::sort(byTitle, byTitle + sortedCount,
+              [records](const int r1, const int r2) {
+                  return strcmp(records[r1].title.c_str(),
+                                records[r2].title.c_str()) < 0;
+              });
+
+    Status status = OK;
+    bool found = true;
+    while (OK == status) {
+        if (Snapshot_reader::OK != reader->next_collection(&found)) {
+            status = ERROR;
+            break;
+        }
+        if (!found) {
+            break;
+        }
+
+        if (0 == myCollectionCount) {
+            reserveCollections(
+                std::min(reader->get_collection_count(), reserveLimit));
+        }
+        add_collection(reader->get_collection_name().data());
+
+        for (int j = 0; j < reader->get_member_count(); j++) {
+            if (byID) {
+                add_member(reader->get_member_ID(j));
+                continue;
+            }
+
+            const String_view memberTitle = reader->get_member_title(j);
+            const int* const position = std::lower_bound(
+                byTitle, byTitle + sortedCount, memberTitle,
+                [records](const int r, const String_view t) {
+                    return String_view(records[r].title) < t;
+                });
+            if ((byTitle + sortedCount == position) ||
+                (String_view(records[*position].title) != memberTitle)) {
+                LOG(ERROR) << "Snapshot::restoreCollections - no Record "
+                           << "titled ->" << memberTitle.data() << "<-!";
+                status = ERROR;
+                break;
+            }
+            add_member(records[*position].ID);
+        }
+    }
+
+    delete [] byTitle;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::restoreCollections";
+    return status;
+}
+
+// validate
+Snapshot::Status Snapshot::validate(
+        Id_index<const Record_data>* const index) const {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot::validate";
+
+    Id_index<const Record_data> localIndex;
+    Id_index<const Record_data>* const records =
+        (0 == index) ? &localIndex : index;
+    records->reserve(myRecordCount);
+
+    Status status = OK;
+    for (int i = 0; (OK == status) && (i < myRecordCount); i++) {
+        const Record_data& record = myRecords[i];
+        if ((record.ID <= 0) ||
+            (record.rating < 0) || (record.rating > ourMaxRating) ||
+            (Id_index<const Record_data>::OK != records->insert(&record))) {
+            LOG(ERROR) << "Snapshot::validate - invalid Record " << record.ID
+                       << "!";
+            status = ERROR;
+        }
+    }
+
+    for (int i = 0; (OK == status) && (i < myMemberCount); i++) {
+        if (0 == records->find(myMembers[i])) {
+            LOG(ERROR) << "Snapshot::validate - no Record " << myMembers[i]
+                       << " for member!";
+            status = ERROR;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot::validate";
+    return status;
+}
+
+// newRecord
+Snapshot::Record_data& Snapshot::newRecord(const int ID,
+                                           const int rating,
+                                           const char* const title) {
+    reserveRecords(myRecordCount + 1);
+
+    Record_data& record = *new(myRecords + myRecordCount) Record_data;
+    myRecordCount++;
+    record.ID = ID;
+    record.rating = rating;
+    record.title.init(title);
+    return record;
+}
+
+// reserveRecords
+void Snapshot::reserveRecords(const int count) {
+    if (count > myRecordCapacity) {
+        const int capacity = std::max(count, 2 * myRecordCapacity);
+        myRecords = growStorage(myRecords, myRecordCount, capacity);
+        myRecordCapacity = capacity;
+    }
+}
+
+// reserveCollections
+void Snapshot::reserveCollections(const int count) {
+    if (count > myCollectionCapacity) {
+        const int capacity = std::max(count, 2 * myCollectionCapacity);
+        myCollections = growStorage(myCollections, myCollectionCount, capacity);
+        myCollectionCapacity = capacity;
+    }
+}
+
+// reserveMembers
+void Snapshot::reserveMembers(const int count) {
+    if (count <= myMemberCapacity) {
+        return;
+    }
+
+    const int capacity = std::max(count, 2 * myMemberCapacity);
+    int* const members = new(nothrow) int[static_cast<size_t>(capacity)];
+    if (0 == members) {
+        LOG(FATAL) << "Snapshot::reserveMembers - call to new[] failed!";
+        return;  // unreachable
+    }
+
+    std::copy(myMembers, myMembers + myMemberCount, members);
+    delete [] myMembers;
+    myMembers = members;
+    myMemberCapacity = capacity;
+}
@@ -0,0 +1,410 @@
+#ifndef MEDIAMANAGER_MANAGER_SNAPSHOT_H_
+#define MEDIAMANAGER_MANAGER_SNAPSHOT_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <atomic>
+#include <cstddef>
+#include <istream>  // NOLINT(readability/streams)
+#include <ostream>  // NOLINT(readability/streams)
+
+#include "glog/logging.h"
+#include "manager/InternedString.h"
+#include "manager/String.h"
+#include "manager/Utility.h"
+
+
+template<typename T> class Id_index;
+class Snapshot_reader;
+
+
+/**
+ * @file Snapshot.h
+ * @brief Declaration of Snapshot class.
+ */
+
+
+/**
+ * @class Snapshot Snapshot.h manager/Snapshot.h
+ *
+ * @brief The saved state of the Library and Catalog, readable and writable in
+ * the line-oriented text format or a versioned binary format.
+ *
+ * @details A Snapshot holds the data the save commands write out: every
+ * Record (ID, rating, medium, title) and every Collection (name and the IDs
+ * of its members).  It is filled either by the add functions, when saving, or
+ * by restore(), and then written with save() or read back through the
+ * accessors.  Reading one format and saving the other converts a save file;
+ * see convert().
+ *
+ * The text format is the one Record::save and Collection::save write:
+ * @verbatim
+   <number of Records>
+   <ID> <medium> <rating> <title>            one line per Record
+   <number of Collections>
+   <name> <number of members>                for each Collection, followed
+   <title>                                   by one line per member
+   @endverbatim
+ *
+ * The binary format (version 1) stores every number as a little-endian
+ * fixed-width field and every string as a 32-bit length followed by its
+ * characters, so reading it involves no parsing.  The media, of which there
+ * are only a handful, are written once in a string table and Records refer to
+ * them by index, and Collections refer to their members by ID:
+ * @verbatim
+   magic        4 bytes: 0x89 'M' 'M' 'S'
+   version      u32
+   media        u32 count, then count strings
+   Records      u32 count, then per Record:
+                    i32 ID, u8 rating, u32 medium index, string title
+   Collections  u32 count, then per Collection:
+                    string name, u32 member count, member count i32 IDs
+   @endverbatim
+ * The first byte of a text file is a digit, so restore() tells the formats
+ * apart by it.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Snapshot {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * The save file formats.
+     */
+    enum Format {TEXT, BINARY};
+
+    /**
+     * First bytes of a binary snapshot.  A text snapshot starts with a digit.
+     */
+    static const char ourMagic[4];
+
+    /**
+     * Version of the binary format written by save().
+     */
+    static const int ourVersion = 1;
+
+    /**
+     * Largest valid rating; 0 means the Record is unrated.
+     */
+    static const int ourMaxRating = 5;
+
+    /**
+     * A saved Record.
+     */
+    struct Record_data {
+        /** ID number of the Record. */
+        int ID;
+
+        /** Rating, 0 if unrated. */
+        int rating;
+
+        /** Medium of the Record. */
+        InternedString medium;
+
+        /** Title of the Record. */
+        String title;
+
+        int get_ID() const {
+            return ID;
+        }
+    };
+
+    /**
+     * A saved Collection.  The IDs of its members are get_members().
+     */
+    struct Collection_data {
+        /** Name of the Collection. */
+        String name;
+
+        /** Index of the first member in the member array. */
+        int first_member;
+
+        /** Number of members. */
+        int member_count;
+    };
+
+    /**
+     * Constructor that initializes an empty snapshot.
+     *
+     * @pre  None.
+     * @post Snapshot has no Records and no Collections.
+     */
+    Snapshot();
+
+    /**
+     * Deallocates the snapshot.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Snapshot();
+
+    /**
+     * Add a Record.
+     *
+     * @pre  None.
+     * @post The Record is the last one in the snapshot.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param ID     ID number of the Record
+     * @param rating Rating of the Record, 0 if unrated
+     * @param medium Medium of the Record
+     * @param title  Title of the Record
+     */
+    void add_record(const int ID,
+                    const int rating,
+                    const char* const medium,
+                    const char* const title);
+
+    /**
+     * Add a Collection with no members.
+     *
+     * @pre  None.
+     * @post The Collection is the last one in the snapshot.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param name Name of the Collection
+     */
+    void add_collection(const char* const name);
+
+    /**
+     * Add a member to the last Collection added.
+     *
+     * @pre  At least one Collection has been added.
+     * @post The member is the last one of the last Collection.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param ID ID number of the member Record
+     */
+    void add_member(const int ID);
+
+    /**
+     * Remove every Record and Collection.
+     *
+     * @pre  None.
+     * @post Snapshot has no Records and no Collections.
+     */
+    void clear();
+
+    /**
+     * @return the number of Records
+     */
+    int get_record_count() const {
+        return myRecordCount;
+    }
+
+    /**
+     * @param i Index of the Record, 0 through get_record_count() - 1
+     *
+     * @return the Record in position i
+     */
+    const Record_data& get_record(const int i) const {
+        return myRecords[i];
+    }
+
+    /**
+     * @return the number of Collections
+     */
+    int get_collection_count() const {
+        return myCollectionCount;
+    }
+
+    /**
+     * @param i Index of the Collection, 0 through get_collection_count() - 1
+     *
+     * @return the Collection in position i
+     */
+    const Collection_data& get_collection(const int i) const {
+        return myCollections[i];
+    }
+
+    /**
+     * @param collection A Collection of this snapshot
+     *
+     * @return the IDs of the members of collection
+     */
+    const int* get_members(const Collection_data& collection) const {
+        return myMembers + collection.first_member;
+    }
+
+    /**
+     * Write the snapshot to a stream.
+     *
+     * @pre  None.
+     * @post Snapshot remains unchanged.
+     *
+     * @param os     Stream to write to, opened in binary mode for BINARY
+     * @param format Format to write
+     *
+     * @return ERROR if the snapshot is inconsistent (a duplicate Record ID,
+     *         a rating out of range, or a member that is not a Record) or the
+     *         stream fails, otherwise OK
+     */
+    Status save(std::ostream* const os, const Format format) const;
+
+    /**
+     * Replace the contents of the snapshot with the data read from a stream
+     * in either format.
+     *
+     * @pre  None.
+     * @post Snapshot holds the data read, or is empty on ERROR.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param is Stream to read, opened in binary mode
+     *
+     * @return ERROR if the data is invalid or incomplete, otherwise OK
+     */
+    Status restore(std::istream* const is);
+
+    /**
+     * Replace the contents of the snapshot with a save file in memory,
+     * parsing the Records of a text file on several threads.
+     *
+     * @details The Records of a text file are split into parts at line
+     * boundaries, one part per thread, and each thread parses its part with
+     * a Snapshot_reader.  The Records are then built on the calling thread in
+     * file order, since String and InternedString are not thread-safe, and
+     * the Collections are read as restore() reads them.  Both accept the
+     * same text: the count alone on its line, then one Record per line, as
+     * save() writes it, with any blank lines between.  A binary file is read by
+     * restore() on the calling thread; it is already several times faster
+     * than text, and cannot be split without reading it.
+     *
+     * ID_counter, the counter for new ID numbers (see Record), is raised to
+     * the largest ID restored, correctly even if other threads raise it at
+     * the same time.  It is left alone on ERROR.
+     *
+     * @pre  None.
+     * @post Snapshot holds the data read, or is empty on ERROR.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param data       Start of the save file
+     * @param size       Length of the save file in bytes
+     * @param threads    Number of threads to parse on, including this one
+     * @param ID_counter Counter to raise, or NULL
+     *
+     * @return ERROR if the data is invalid or incomplete, otherwise OK
+     */
+    Status restore_parallel(const char* const data,
+                            const size_t size,
+                            const int threads,
+                            std::atomic<int>* const ID_counter);
+
+    /**
+     * Convert a save file from one format to the other.
+     *
+     * @pre  None.
+     * @post The data read from is has been written to os.
+     *
+     * @param is     Stream to read, in either format
+     * @param os     Stream to write to
+     * @param format Format to write
+     *
+     * @return ERROR if the data is invalid or a stream fails, otherwise OK
+     */
+    static Status convert(std::istream* const is,
+                          std::ostream* const os,
+                          const Format format);
+
+  private:
+    /**
+     * Write the snapshot in the text format.
+     */
+    Status saveText(std::ostream* const os) const;
+
+    /**
+     * Write the snapshot in the binary format.
+     */
+    Status saveBinary(std::ostream* const os) const;
+
+    /**
+     * Read the Records of a file into this empty snapshot.
+     */
+    Status restoreRecords(Snapshot_reader* const reader);
+
+    /**
+     * Read the Collections of a file, after its Records.
+     */
+    Status restoreCollections(Snapshot_reader* const reader);
+
+    /**
+     * Check that the Record IDs are unique and positive, the ratings are in
+     * range, and every member is one of the Records.
+     *
+     * @param index Empty index to fill with the Records by ID
+     *
+     * @return ERROR if any check fails, otherwise OK
+     */
+    Status validate(Id_index<const Record_data>* const index) const;
+
+    /**
+     * Add a Record with an empty medium, for the caller to set.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @return the new last Record
+     */
+    Record_data& newRecord(const int ID,
+                           const int rating,
+                           const char* const title);
+
+    /**
+     * Make room for at least count Records, Collections, and members.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     */
+    void reserveRecords(const int count);
+    void reserveCollections(const int count);
+    void reserveMembers(const int count);
+
+    /**
+     * Records, in the order added.
+     */
+    Record_data* myRecords;
+    int          myRecordCount;
+    int          myRecordCapacity;
+
+    /**
+     * Collections, in the order added.
+     */
+    Collection_data* myCollections;
+    int              myCollectionCount;
+    int              myCollectionCapacity;
+
+    /**
+     * Member IDs of every Collection, one Collection after the other.
+     */
+    int* myMembers;
+    int  myMemberCount;
+    int  myMemberCapacity;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Snapshot);
+};
+
+#endif  // MEDIAMANAGER_MANAGER_SNAPSHOT_H_
@@ -0,0 +1,577 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/Snapshot_reader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <istream>  // NOLINT(readability/streams)
+#include <new>
+  using std::nothrow;
+#include <string>
+
+#include "glog/logging.h"
+
+#include "manager/Snapshot.h"
+#include "manager/String_view.h"
+#include "manager/Utility.h"
+
+
+// initialize static members
+const int Snapshot_reader::ourDefaultChunkSize;
+
+// counts read from a file are only trusted this far when allocating, so a
+// damaged file cannot ask for an absurd amount of memory up front - anything
+// bigger grows as the data actually arrives
+static const int reserveLimit = 1 << 16;
+
+// no title or name is anywhere near this long
+static const unsigned int maxStringLength = 1U << 20;
+
+
+////////////////////////
+//  STREAM HELPERS    //
+////////////////////////
+
+
+// read a little-endian 32-bit field
+static bool getU32(std::istream* is, unsigned int* value) {
+    unsigned char bytes[4];
+    if (!is->read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+        return false;
+    }
+    *value = static_cast<unsigned int>(bytes[0]) |
+             (static_cast<unsigned int>(bytes[1]) << 8) |
+             (static_cast<unsigned int>(bytes[2]) << 16) |
+             (static_cast<unsigned int>(bytes[3]) << 24);
+    return true;
+}
+
+// read a 32-bit count and check it fits in an int
+static bool getCount(std::istream* is, int* count) {
+    unsigned int value;
+    if (!getU32(is, &value) || (value > 0x7FFFFFFFU)) {
+        return false;
+    }
+    *count = static_cast<int>(value);
+    return true;
+}
+
+// skip the blanks between the fields of a line, but not the newline
+static void skipBlanks(std::istream* is) {
+    while ((' ' == is->peek()) || ('\t' == is->peek())) {
+        is->get();
+    }
+}
+
+// skip spaces and tabs, and return whether more of the line follows them
+static bool skipToField(std::istream* is) {
+    skipBlanks(is);
+    const int c = is->peek();
+    return (std::char_traits<char>::eof() != c) && ('\n' != c);
+}
+
+
+// growable array of characters; each string read is appended followed by a
+// null byte
+class Snapshot_reader::Buffer {
+  public:
+    Buffer()
+      : myChars(0),
+        mySize(0),
+        myCapacity(0) {
+        reserve(64);
+    }
+
+    ~Buffer() {
+        delete [] myChars;
+    }
+
+    const char* data() const {
+        return myChars;
+    }
+
+    int size() const {
+        return mySize;
+    }
+
+    void clear() {
+        mySize = 0;
+    }
+
+    // append the next whitespace-delimited word and return its length
+    int append_word(std::istream* is) {
+        *is >> std::ws;
+        int length = 0;
+        for (int c = is->peek();
+             (std::char_traits<char>::eof() != c) && !isspace(c);
+             c = is->peek()) {
+            push(static_cast<char>(is->get()));
+            length++;
+        }
+        push('\0');
+        return length;
+    }
+
+    // append the rest of the line, without the newline, and return its
+    // length, or -1 if the input ended before any newline or characters
+    int append_line(std::istream* is) {
+        int length = 0;
+        int c;
+        while ((std::char_traits<char>::eof() != (c = is->get())) &&
+               ('\n' != c)) {
+            push(static_cast<char>(c));
+            length++;
+        }
+        push('\0');
+        return ((0 == length) && ('\n' != c)) ? -1 : length;
+    }
+
+    // append a length-prefixed string and return its length, or -1 if it
+    // cannot be read
+    int append_string(std::istream* is) {
+        unsigned int length;
+        if (!getU32(is, &length) || (length > maxStringLength)) {
+            return -1;
+        }
+        const int size = static_cast<int>(length);
+        char* const chars = reserve(size + 1);
+        if (!is->read(chars, static_cast<std::streamsize>(size))) {
+            return -1;
+        }
+        chars[size] = '\0';
+        mySize += size + 1;
+        return size;
+    }
+
+  private:
+    // make room for count more characters and return where they go
+    char* reserve(const int count) {
+        const size_t wanted = static_cast<size_t>(mySize + count);
+        if (wanted > myCapacity) {
+            const size_t capacity = std::max(wanted, 2 * myCapacity);
+            char* const chars = new(nothrow) char[capacity];
+            if (0 == chars) {
+                LOG(FATAL) << "Snapshot_reader::Buffer::reserve - "
+                           << "call to new[] failed!";
+                return 0;  // unreachable
+            }
+            std::copy(myChars, myChars + mySize, chars);
+            delete [] myChars;
+            myChars = chars;
+            myCapacity = capacity;
+        }
+        return myChars + mySize;
+    }
+
+    void push(const char c) {
+        *reserve(1) = c;
+        mySize++;
+    }
+
+    char*  myChars;
+    int    mySize;
+    size_t myCapacity;
+
+    DISALLOW_COPY_AND_ASSIGN(Buffer);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+// constructor
+Snapshot_reader::Snapshot_reader(const int chunk_size)
+          : myStream(0),
+            myFormat(Snapshot::TEXT),
+            myRecordCount(0),
+            myRecordsRead(0),
+            myCollectionCount(-1),
+            myCollectionsRead(0),
+            myChars(new(nothrow) Buffer),
+            myMediaChars(new(nothrow) Buffer),
+            myMedia(0),
+            myMediaCount(0),
+            myRecords(new(nothrow) Record_view[
+                static_cast<size_t>(chunk_size)]),
+            myChunkSize(chunk_size),
+            myNameSize(0),
+            myMemberIDs(0),
+            myMemberCount(0),
+            myMemberCapacity(0) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_reader::Snapshot_reader";
+    TRACE_VLOG(2) << "Called with arguments\tchunk_size = ->" << chunk_size
+                  << "<-";
+
+    if ((0 == myChars) || (0 == myMediaChars) || (0 == myRecords)) {
+        LOG(FATAL) << "Snapshot_reader::Snapshot_reader - "
+                   << "call to new failed!";
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::Snapshot_reader";
+}
+
+// destructor
+Snapshot_reader::~Snapshot_reader() {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_reader::~Snapshot_reader";
+
+    delete myChars;
+    delete myMediaChars;
+    delete [] myMedia;
+    delete [] myRecords;
+    delete [] myMemberIDs;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::~Snapshot_reader";
+}
+
+// open
+Snapshot_reader::Status Snapshot_reader::open(std::istream* const is) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_reader::open";
+
+    reset(is);
+
+    const int first = is->peek();
+    Status status = OK;
+    if (std::char_traits<char>::eof() == first) {
+        LOG(ERROR) << "Snapshot_reader::open - empty file!";
+        status = ERROR;
+    } else if (Snapshot::ourMagic[0] == static_cast<char>(first)) {
+        myFormat = Snapshot::BINARY;
+        status = openBinary();
+    } else {
+        myFormat = Snapshot::TEXT;
+        // the count is alone on its line
+        bool valid = (*is >> myRecordCount) && (myRecordCount >= 0);
+        if (valid) {
+            skipBlanks(is);
+            valid = '\n' == is->get();
+        }
+        if (!valid) {
+            LOG(ERROR) << "Snapshot_reader::open - invalid Record count!";
+            myRecordCount = 0;
+            status = ERROR;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::open";
+    return status;
+}
+
+// open_text_part
+void Snapshot_reader::open_text_part(std::istream* const is, const int count) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_reader::open_text_part";
+    TRACE_VLOG(2) << "Called with arguments\tcount = ->" << count << "<-";
+
+    reset(is);
+    myFormat = Snapshot::TEXT;
+    myRecordCount = count;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::open_text_part";
+}
+
+// next_records
+Snapshot_reader::Status Snapshot_reader::next_records(int* const count) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_reader::next_records";
+
+    const int wanted = std::min(myChunkSize, myRecordCount - myRecordsRead);
+    myChars->clear();
+
+    bool valid = true;
+    int read = 0;
+    while (valid && (read < wanted)) {
+        valid = (Snapshot::TEXT == myFormat) ?
+            readRecordText(read) : readRecordBinary(read);
+        const Record_view& record = myRecords[read];
+        if (valid && ((record.ID <= 0) ||
+                      (record.rating < 0) ||
+                      (record.rating > Snapshot::ourMaxRating))) {
+            LOG(ERROR) << "Snapshot_reader::next_records - invalid Record "
+                       << record.ID << "!";
+            valid = false;
+        } else if (!valid) {
+            LOG(ERROR) << "Snapshot_reader::next_records - invalid Record "
+                       << myRecordsRead + read << "!";
+        }
+        read++;
+    }
+
+    // now that myChars is done growing, point the views at their strings,
+    // which were appended in order
+    const char* chars = myChars->data();
+    for (int i = 0; valid && (i < wanted); i++) {
+        Record_view& record = myRecords[i];
+        if (Snapshot::TEXT == myFormat) {
+            record.medium = String_view(chars, record.medium.size());
+            chars += record.medium.size() + 1;
+        }
+        record.title = String_view(chars, record.title.size());
+        chars += record.title.size() + 1;
+    }
+
+    if (valid) {
+        myRecordsRead += wanted;
+        *count = wanted;
+    } else {
+        *count = 0;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::next_records";
+    return valid ? OK : ERROR;
+}
+
+// next_collection
+Snapshot_reader::Status Snapshot_reader::next_collection(bool* const found) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_reader::next_collection";
+
+    *found = false;
+    if (myRecordsRead < myRecordCount) {
+        LOG(ERROR) << "Snapshot_reader::next_collection - "
+                   << "the Records have not all been read!";
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::next_collection";
+        return ERROR;
+    }
+
+    if ((myCollectionCount < 0) && !readCollectionCount()) {
+        LOG(ERROR) << "Snapshot_reader::next_collection - "
+                   << "invalid Collection count!";
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::next_collection";
+        return ERROR;
+    }
+
+    if (myCollectionsRead == myCollectionCount) {
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::next_collection";
+        return OK;
+    }
+
+    myChars->clear();
+    myMemberCount = 0;
+    const bool valid = (Snapshot::TEXT == myFormat) ?
+        readCollectionText() : readCollectionBinary();
+    if (!valid) {
+        LOG(ERROR) << "Snapshot_reader::next_collection - invalid Collection "
+                   << myCollectionsRead << "!";
+        myNameSize = 0;
+        myMemberCount = 0;
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::next_collection";
+        return ERROR;
+    }
+
+    myCollectionsRead++;
+    *found = true;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::next_collection";
+    return OK;
+}
+
+// get_collection_name
+String_view Snapshot_reader::get_collection_name() const {
+    return String_view(myChars->data(), myNameSize);
+}
+
+// get_member_title
+String_view Snapshot_reader::get_member_title(const int i) const {
+    // the titles follow one another, each with its null byte
+    const int end = (i + 1 < myMemberCount) ?
+        myMemberIDs[i + 1] : myChars->size();
+    return String_view(myChars->data() + myMemberIDs[i],
+                       end - myMemberIDs[i] - 1);
+}
+
+// reset
+void Snapshot_reader::reset(std::istream* const is) {
+    myStream = is;
+    myRecordCount = 0;
+    myRecordsRead = 0;
+    myCollectionCount = -1;
+    myCollectionsRead = 0;
+    myChars->clear();
+    myMediaChars->clear();
+    delete [] myMedia;
+    myMedia = 0;
+    myMediaCount = 0;
+    myNameSize = 0;
+    myMemberCount = 0;
+}
+
+// openBinary
+Snapshot_reader::Status Snapshot_reader::openBinary() {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_reader::openBinary";
+
+    char magic[sizeof(Snapshot::ourMagic)];
+    unsigned int version;
+    if (!myStream->read(magic, sizeof(magic)) ||
+        (0 != memcmp(magic, Snapshot::ourMagic, sizeof(magic)))) {
+        LOG(ERROR) << "Snapshot_reader::openBinary - not a snapshot file!";
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::openBinary";
+        return ERROR;
+    }
+    if (!getU32(myStream, &version) ||
+        (static_cast<unsigned int>(Snapshot::ourVersion) != version)) {
+        LOG(ERROR) << "Snapshot_reader::openBinary - unsupported version!";
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::openBinary";
+        return ERROR;
+    }
+
+    // the string table, which every chunk refers to
+    int mediaCount;
+    bool valid = getCount(myStream, &mediaCount) &&
+                 (mediaCount <= reserveLimit);
+    if (valid) {
+        myMedia = new(nothrow) String_view[
+            static_cast<size_t>(std::max(1, mediaCount))];
+        if (0 == myMedia) {
+            LOG(FATAL) << "Snapshot_reader::openBinary - call to new[] failed!";
+            return ERROR;  // unreachable
+        }
+    }
+    for (int i = 0; valid && (i < mediaCount); i++) {
+        const int length = myMediaChars->append_string(myStream);
+        myMedia[i] = String_view(0, length);
+        valid = length >= 0;
+    }
+    if (valid) {
+        const char* chars = myMediaChars->data();
+        for (int i = 0; i < mediaCount; i++) {
+            myMedia[i] = String_view(chars, myMedia[i].size());
+            chars += myMedia[i].size() + 1;
+        }
+        myMediaCount = mediaCount;
+        valid = getCount(myStream, &myRecordCount);
+    }
+
+    if (!valid) {
+        LOG(ERROR) << "Snapshot_reader::openBinary - invalid or truncated "
+                   << "header!";
+        myRecordCount = 0;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_reader::openBinary";
+    return valid ? OK : ERROR;
+}
+
+// readRecordText
+bool Snapshot_reader::readRecordText(const int i) {
+    Record_view& record = myRecords[i];
+
+    // a Record is one line, which blank lines may precede
+    int length;
+    if (!(*myStream >> record.ID) || !skipToField(myStream) ||
+        ((length = myChars->append_word(myStream)) <= 0)) {
+        return false;
+    }
+    record.medium = String_view(0, length);
+
+    if (!skipToField(myStream) || !(*myStream >> record.rating)) {
+        return false;
+    }
+    skipBlanks(myStream);
+    if ((length = myChars->append_line(myStream)) <= 0) {
+        return false;
+    }
+    record.title = String_view(0, length);
+    return true;
+}
+
+// readRecordBinary
+bool Snapshot_reader::readRecordBinary(const int i) {
+    Record_view& record = myRecords[i];
+
+    unsigned int ID;
+    unsigned char rating;
+    unsigned int medium;
+    if (!getU32(myStream, &ID) ||
+        !myStream->read(reinterpret_cast<char*>(&rating), 1) ||
+        !getU32(myStream, &medium) ||
+        (medium >= static_cast<unsigned int>(myMediaCount))) {
+        return false;
+    }
+
+    const int length = myChars->append_string(myStream);
+    if (length < 0) {
+        return false;
+    }
+
+    record.ID = static_cast<int>(ID);
+    record.rating = rating;
+    record.medium = myMedia[medium];
+    record.title = String_view(0, length);
+    return true;
+}
+
+// readCollectionCount
+bool Snapshot_reader::readCollectionCount() {
+    int count;
+    const bool valid = (Snapshot::TEXT == myFormat) ?
+        ((*myStream >> count) && (count >= 0)) :
+        getCount(myStream, &count);
+    if (valid) {
+        myCollectionCount = count;
+    }
+    return valid;
+}
+
+// readCollectionText
+bool Snapshot_reader::readCollectionText() {
+    int memberCount;
+    myNameSize = myChars->append_word(myStream);
+    bool valid = (myNameSize > 0) &&
+                 (*myStream >> memberCount) && (memberCount >= 0);
+    if (valid) {
+        skipBlanks(myStream);
+        valid = '\n' == myStream->get();
+    }
+
+    // members are saved by title; remember where each one starts
+    for (int j = 0; valid && (j < memberCount); j++) {
+        reserveMembers(myMemberCount + 1);
+        myMemberIDs[myMemberCount] = myChars->size();
+        valid = myChars->append_line(myStream) > 0;
+        myMemberCount++;
+    }
+    return valid;
+}
+
+// readCollectionBinary
+bool Snapshot_reader::readCollectionBinary() {
+    int memberCount;
+    myNameSize = myChars->append_string(myStream);
+    bool valid = (myNameSize >= 0) && getCount(myStream, &memberCount);
+    if (valid) {
+        reserveMembers(std::min(memberCount, reserveLimit));
+    }
+
+    for (int j = 0; valid && (j < memberCount); j++) {
+        unsigned int ID;
+        valid = getU32(myStream, &ID);
+        if (valid) {
+            reserveMembers(myMemberCount + 1);
+            myMemberIDs[myMemberCount++] = static_cast<int>(ID);
+        }
+    }
+    return valid;
+}
+
+// reserveMembers
+void Snapshot_reader::reserveMembers(const int count) {
+    if (count <= myMemberCapacity) {
+        return;
+    }
+
+    const int capacity = std::max(count, 2 * myMemberCapacity);
+    int* const members = new(nothrow) int[static_cast<size_t>(capacity)];
+    if (0 == members) {
+        LOG(FATAL) << "Snapshot_reader::reserveMembers - call to new[] failed!";
+        return;  // unreachable
+    }
+
+    std::copy(myMemberIDs, myMemberIDs + myMemberCount, members);
+    delete [] myMemberIDs;
+    myMemberIDs = members;
+    myMemberCapacity = capacity;
+}
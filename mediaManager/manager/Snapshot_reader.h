@@ -0,0 +1,324 @@
+#ifndef MEDIAMANAGER_MANAGER_SNAPSHOT_READER_H_
+#define MEDIAMANAGER_MANAGER_SNAPSHOT_READER_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <istream>  // NOLINT(readability/streams)
+
+#include "glog/logging.h"
+#include "manager/Snapshot.h"
+#include "manager/Snapshot_view.h"
+#include "manager/String_view.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Snapshot_reader.h
+ * @brief Declaration of Snapshot_reader class.
+ */
+
+
+/**
+ * @class Snapshot_reader Snapshot_reader.h manager/Snapshot_reader.h
+ *
+ * @brief Reads a save file in either format a chunk of Records or one
+ * Collection at a time, so a restore never holds more than one chunk of the
+ * file in memory.
+ *
+ * @details open() reads the header, then next_records() is called until it
+ * returns no Records, then next_collection() until it finds none.  Each
+ * chunk replaces the one before, so the memory used is bounded by the chunk
+ * size and the largest Collection rather than by the size of the file.  This
+ * lets the caller validate and build its objects as the file is read, and
+ * use a Restore_journal to undo them if a later part of the file is bad,
+ * instead of parsing the whole file into a copy first.
+ *
+ * The reader checks everything that can be checked one item at a time: the
+ * structure of the file, that IDs are positive, and that ratings are in
+ * range.  Checks that need all of the data - unique IDs and members that are
+ * Records - are left to the caller, who is building the containers that can
+ * answer them.
+ *
+ * The String_views returned refer to the reader's buffer and are valid only
+ * until the next call to next_records() or next_collection().  Their
+ * characters are followed by a null byte, so data() can be used as a
+ * C-string.  The exception is the medium in a binary file, which refers to
+ * the file's table of media: it stays valid until the next open(), and every
+ * Record of that medium refers to the same characters, so a medium can be
+ * recognized by its data() alone.
+ *
+ * Collections refer to their members by ID in the binary format, but by
+ * title in the text format; get_format() says which of get_member_ID() and
+ * get_member_title() to use.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Snapshot_reader {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * A Record read from the file.
+     */
+    typedef Snapshot_view::Record_view Record_view;
+
+    /**
+     * Number of Records in a chunk unless the constructor is told otherwise.
+     */
+    static const int ourDefaultChunkSize = 1024;
+
+    /**
+     * Constructor for a reader with no file open.
+     *
+     * @pre  chunk_size is positive.
+     * @post Reader has no file open.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param chunk_size Largest number of Records read by next_records()
+     */
+    explicit Snapshot_reader(const int chunk_size = ourDefaultChunkSize);
+
+    /**
+     * Deallocates the buffers.  The stream is not affected.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Snapshot_reader();
+
+    /**
+     * Start reading a save file, forgetting any file read before.
+     *
+     * @pre  is stays valid while the file is read.
+     * @post The Records can be read with next_records().
+     *
+     * @param is Stream to read, opened in binary mode
+     *
+     * @return ERROR if the file is empty or its header is invalid, otherwise
+     *         OK
+     */
+    Status open(std::istream* const is);
+
+    /**
+     * Start reading a part of a text file that was split at the start of a
+     * line: count Records, one per line, and then the Collections if the part
+     * goes on after them.  There is no header to read.
+     *
+     * @pre  is stays valid while the part is read; count is not negative.
+     * @post The Records can be read with next_records().
+     *
+     * @param is    Stream holding the part
+     * @param count Number of Records in the part
+     */
+    void open_text_part(std::istream* const is, const int count);
+
+    /**
+     * @return the format of the file
+     */
+    Snapshot::Format get_format() const {
+        return myFormat;
+    }
+
+    /**
+     * @return the number of Records in the file
+     */
+    int get_record_count() const {
+        return myRecordCount;
+    }
+
+    /**
+     * @return the largest number of Records in a chunk
+     */
+    int get_chunk_size() const {
+        return myChunkSize;
+    }
+
+    /**
+     * Read the next chunk of Records.
+     *
+     * @pre  open() has returned OK.
+     * @post The Records read are get_record(0) through get_record(count - 1).
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param count Set to the number of Records read, 0 once all have been
+     *
+     * @return ERROR if a Record is invalid or the file ends, otherwise OK
+     */
+    Status next_records(int* const count);
+
+    /**
+     * @param i Index of the Record in the chunk
+     *
+     * @return the Record in position i of the last chunk read
+     */
+    const Record_view& get_record(const int i) const {
+        return myRecords[i];
+    }
+
+    /**
+     * Read the next Collection.
+     *
+     * @pre  next_records() has read every Record.
+     * @post The Collection read is described by get_collection_name() and
+     *       the member accessors.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param found Set to false once every Collection has been read
+     *
+     * @return ERROR if the Collection is invalid or the file ends, otherwise
+     *         OK
+     */
+    Status next_collection(bool* const found);
+
+    /**
+     * @return the number of Collections in the file, once next_collection()
+     *         has been called
+     */
+    int get_collection_count() const {
+        return myCollectionCount;
+    }
+
+    /**
+     * @return the name of the last Collection read
+     */
+    String_view get_collection_name() const;
+
+    /**
+     * @return the number of members of the last Collection read
+     */
+    int get_member_count() const {
+        return myMemberCount;
+    }
+
+    /**
+     * @pre  The file is in the binary format.
+     *
+     * @param i Index of the member
+     *
+     * @return the ID of member i of the last Collection read
+     */
+    int get_member_ID(const int i) const {
+        return myMemberIDs[i];
+    }
+
+    /**
+     * @pre  The file is in the text format.
+     *
+     * @param i Index of the member
+     *
+     * @return the title of member i of the last Collection read
+     */
+    String_view get_member_title(const int i) const;
+
+  private:
+    /**
+     * Growable array of characters holding the strings of a chunk.
+     */
+    class Buffer;
+
+    /**
+     * Forget any file read before and start reading is.
+     */
+    void reset(std::istream* const is);
+
+    /**
+     * Read the header of a binary file, after the first byte is checked.
+     */
+    Status openBinary();
+
+    /**
+     * Read one Record of the chunk into myRecords[i], appending its strings
+     * to myChars; the views hold only the lengths until the chunk is
+     * complete, since myChars may move as it grows.
+     */
+    bool readRecordText(const int i);
+    bool readRecordBinary(const int i);
+
+    /**
+     * Read the Collection count on the first call to next_collection().
+     */
+    bool readCollectionCount();
+
+    /**
+     * Read one Collection into myChars and the member arrays.
+     */
+    bool readCollectionText();
+    bool readCollectionBinary();
+
+    /**
+     * Make room for at least count members.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     */
+    void reserveMembers(const int count);
+
+    /**
+     * The file being read.
+     */
+    std::istream*    myStream;
+    Snapshot::Format myFormat;
+
+    /**
+     * The Records of the file, and how many of them have been read.
+     */
+    int myRecordCount;
+    int myRecordsRead;
+
+    /**
+     * The Collections of the file, and how many of them have been read; the
+     * count is -1 until it is read.
+     */
+    int myCollectionCount;
+    int myCollectionsRead;
+
+    /**
+     * The strings of the current chunk or Collection.
+     */
+    Buffer* myChars;
+
+    /**
+     * The media of a binary file, read by open().
+     */
+    Buffer*      myMediaChars;
+    String_view* myMedia;
+    int          myMediaCount;
+
+    /**
+     * The current chunk of Records.
+     */
+    Record_view* myRecords;
+    int          myChunkSize;
+
+    /**
+     * The current Collection: the length of its name, which starts myChars,
+     * and its members, by ID or by offset of their title in myChars.
+     */
+    int  myNameSize;
+    int* myMemberIDs;
+    int  myMemberCount;
+    int  myMemberCapacity;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Snapshot_reader);
+};
+
+#endif  // MEDIAMANAGER_MANAGER_SNAPSHOT_READER_H_
@@ -0,0 +1,328 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "manager/Snapshot_view.h"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+  using std::nothrow;
+
+#include "glog/logging.h"
+
+#include "manager/Id_index.h"
+#include "manager/Mapped_file.h"
+#include "manager/Snapshot.h"
+#include "manager/String_view.h"
+#include "manager/Utility.h"
+
+
+// smallest number of bytes each item of the file can take, used to reject
+// counts that the rest of the file cannot possibly hold before allocating
+static const size_t minMediumSize = 4;
+static const size_t minRecordSize = 4 + 1 + 4 + 4;
+static const size_t minCollectionSize = 4 + 4;
+static const size_t memberSize = 4;
+
+
+// decode a little-endian 32-bit field
+static unsigned int decodeU32(const char* const bytes) {
+    const unsigned char* const b =
+        reinterpret_cast<const unsigned char*>(bytes);
+    return static_cast<unsigned int>(b[0]) |
+           (static_cast<unsigned int>(b[1]) << 8) |
+           (static_cast<unsigned int>(b[2]) << 16) |
+           (static_cast<unsigned int>(b[3]) << 24);
+}
+
+
+// walks the fields of the snapshot, failing on any read past its end
+class Reader {
+  public:
+    Reader(const char* const data, const size_t size)
+      : myPosition(data),
+        myRemaining(size) {
+    }
+
+    bool getU32(unsigned int* value) {
+        if (myRemaining < 4) {
+            return false;
+        }
+        *value = decodeU32(myPosition);
+        advance(4);
+        return true;
+    }
+
+    // a 32-bit count of items taking at least itemSize bytes each
+    bool getCount(const size_t itemSize, int* count) {
+        unsigned int value;
+        if (!getU32(&value) || (value > myRemaining / itemSize)) {
+            return false;
+        }
+        *count = static_cast<int>(value);
+        return true;
+    }
+
+    bool getByte(unsigned char* value) {
+        if (myRemaining < 1) {
+            return false;
+        }
+        *value = static_cast<unsigned char>(*myPosition);
+        advance(1);
+        return true;
+    }
+
+    bool getString(String_view* value) {
+        unsigned int length;
+        if (!getU32(&length) || (length > myRemaining)) {
+            return false;
+        }
+        *value = String_view(myPosition, static_cast<int>(length));
+        advance(length);
+        return true;
+    }
+
+    // the next size bytes, skipped over
+    bool getBytes(const size_t size, const char** bytes) {
+        if (size > myRemaining) {
+            return false;
+        }
+        *bytes = myPosition;
+        advance(size);
+        return true;
+    }
+
+  private:
+    void advance(const size_t size) {
+        myPosition += size;
+        myRemaining -= size;
+    }
+
+    const char* myPosition;
+    size_t      myRemaining;
+};
+
+
+// constructor
+Snapshot_view::Snapshot_view()
+          : myData(0),
+            mySize(0),
+            myMedia(0),
+            myMediaCount(0),
+            myRecords(0),
+            myRecordCount(0),
+            myCollections(0),
+            myCollectionCount(0) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_view::Snapshot_view";
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_view::Snapshot_view";
+}
+
+// destructor
+Snapshot_view::~Snapshot_view() {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_view::~Snapshot_view";
+
+    close();
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_view::~Snapshot_view";
+}
+
+// open
+Snapshot_view::Status Snapshot_view::open(const char* const path) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_view::open";
+    TRACE_VLOG(2) << "Called with arguments\tpath = ->" << path << "<-";
+
+    close();
+
+    Status status = ERROR;
+    if (Mapped_file::OK == myFile.open(path)) {
+        myData = myFile.data();
+        mySize = myFile.size();
+        status = parse();
+    }
+
+    if (OK != status) {
+        close();
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_view::open";
+    return status;
+}
+
+// attach
+Snapshot_view::Status Snapshot_view::attach(const char* const data,
+                                            const size_t size) {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_view::attach";
+    TRACE_VLOG(2) << "Called with arguments\tsize = ->" << size << "<-";
+
+    close();
+
+    myData = data;
+    mySize = size;
+    const Status status = parse();
+
+    if (OK != status) {
+        close();
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_view::attach";
+    return status;
+}
+
+// close
+void Snapshot_view::close() {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_view::close";
+
+    delete [] myMedia;
+    myMedia = 0;
+    myMediaCount = 0;
+
+    delete [] myRecords;
+    myRecords = 0;
+    myRecordCount = 0;
+
+    delete [] myCollections;
+    myCollections = 0;
+    myCollectionCount = 0;
+
+    myData = 0;
+    mySize = 0;
+    myFile.close();
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_view::close";
+}
+
+// get_member
+int Snapshot_view::get_member(const Collection_view& collection,
+                              const int i) {
+    return static_cast<int>(decodeU32(collection.members + 4 * i));
+}
+
+// parse
+Snapshot_view::Status Snapshot_view::parse() {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_view::parse";
+
+    Reader reader(myData, mySize);
+
+    const size_t magicSize = sizeof(Snapshot::ourMagic);
+    const char* magic;
+    unsigned int version;
+    if (!reader.getBytes(magicSize, &magic) ||
+        (0 != memcmp(magic, Snapshot::ourMagic, magicSize))) {
+        LOG(ERROR) << "Snapshot_view::parse - not a binary snapshot!";
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_view::parse";
+        return ERROR;
+    }
+    if (!reader.getU32(&version) ||
+        (static_cast<unsigned int>(Snapshot::ourVersion) != version)) {
+        LOG(ERROR) << "Snapshot_view::parse - unsupported version!";
+        TRACE_VLOG(1) << "Method Exit :  Snapshot_view::parse";
+        return ERROR;
+    }
+
+    // every count is checked against the bytes left before it is used to
+    // allocate, so a damaged count cannot ask for more than the file holds
+    bool valid = reader.getCount(minMediumSize, &myMediaCount);
+    if (valid) {
+        myMedia = new(nothrow) String_view[
+            static_cast<size_t>(myMediaCount) + 1];
+        if (0 == myMedia) {
+            LOG(FATAL) << "Snapshot_view::parse - call to new[] failed!";
+            return ERROR;  // unreachable
+        }
+    }
+    for (int i = 0; valid && (i < myMediaCount); i++) {
+        valid = reader.getString(&myMedia[i]);
+    }
+
+    int recordCount = 0;
+    valid = valid && reader.getCount(minRecordSize, &recordCount);
+    if (valid) {
+        myRecords = new(nothrow) Record_view[
+            static_cast<size_t>(recordCount) + 1];
+        if (0 == myRecords) {
+            LOG(FATAL) << "Snapshot_view::parse - call to new[] failed!";
+            return ERROR;  // unreachable
+        }
+    }
+    for (int i = 0; valid && (i < recordCount); i++) {
+        Record_view& record = myRecords[i];
+        unsigned int ID;
+        unsigned char rating;
+        unsigned int medium;
+        valid = reader.getU32(&ID) &&
+                reader.getByte(&rating) &&
+                reader.getU32(&medium) &&
+                (medium < static_cast<unsigned int>(myMediaCount)) &&
+                reader.getString(&record.title);
+        if (valid) {
+            record.ID = static_cast<int>(ID);
+            record.rating = rating;
+            record.medium = myMedia[medium];
+        }
+    }
+    myRecordCount = valid ? recordCount : 0;
+
+    int collectionCount = 0;
+    valid = valid && reader.getCount(minCollectionSize, &collectionCount);
+    if (valid) {
+        myCollections = new(nothrow) Collection_view[
+            static_cast<size_t>(collectionCount) + 1];
+        if (0 == myCollections) {
+            LOG(FATAL) << "Snapshot_view::parse - call to new[] failed!";
+            return ERROR;  // unreachable
+        }
+    }
+    for (int i = 0; valid && (i < collectionCount); i++) {
+        Collection_view& collection = myCollections[i];
+        valid = reader.getString(&collection.name) &&
+                reader.getCount(memberSize, &collection.member_count) &&
+                reader.getBytes(memberSize *
+                                static_cast<size_t>(collection.member_count),
+                                &collection.members);
+    }
+    myCollectionCount = valid ? collectionCount : 0;
+
+    if (!valid) {
+        LOG(ERROR) << "Snapshot_view::parse - invalid or truncated snapshot!";
+    }
+    const Status status = valid ? validate() : ERROR;
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_view::parse";
+    return status;
+}
+
+// validate
+Snapshot_view::Status Snapshot_view::validate() const {
+    TRACE_VLOG(1) << "Method Entry:  Snapshot_view::validate";
+
+    Id_index<const Record_view> records;
+    records.reserve(myRecordCount);
+
+    Status status = OK;
+    for (int i = 0; (OK == status) && (i < myRecordCount); i++) {
+        const Record_view& record = myRecords[i];
+        if ((record.ID <= 0) || (record.rating > Snapshot::ourMaxRating) ||
+            (Id_index<const Record_view>::OK != records.insert(&record))) {
+            LOG(ERROR) << "Snapshot_view::validate - invalid Record "
+                       << record.ID << "!";
+            status = ERROR;
+        }
+    }
+
+    for (int i = 0; (OK == status) && (i < myCollectionCount); i++) {
+        const Collection_view& collection = myCollections[i];
+        for (int j = 0; (OK == status) && (j < collection.member_count); j++) {
+            const int ID = get_member(collection, j);
+            if (0 == records.find(ID)) {
+                LOG(ERROR) << "Snapshot_view::validate - no Record " << ID
+                           << " for member!";
+                status = ERROR;
+            }
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Snapshot_view::validate";
+    return status;
+}
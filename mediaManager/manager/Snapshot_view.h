@@ -0,0 +1,244 @@
+#ifndef MEDIAMANAGER_MANAGER_SNAPSHOT_VIEW_H_
+#define MEDIAMANAGER_MANAGER_SNAPSHOT_VIEW_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstddef>
+
+#include "glog/logging.h"
+#include "manager/Mapped_file.h"
+#include "manager/String_view.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Snapshot_view.h
+ * @brief Declaration of Snapshot_view class.
+ */
+
+
+/**
+ * @class Snapshot_view Snapshot_view.h manager/Snapshot_view.h
+ *
+ * @brief Read-only access to a binary Snapshot file in place, without copying
+ * any strings.
+ *
+ * @details open() maps a save file written by Snapshot::save in the binary
+ * format (see Snapshot.h) and walks it once to locate every Record and
+ * Collection.  The titles, media, and names are String_views of the bytes in
+ * the mapping, so restoring allocates nothing per string: startup costs one
+ * pass over the file, and the pages are shared through the page cache with
+ * every other process mapping the same file.  attach() does the same for a
+ * snapshot that is already in memory.
+ *
+ * The file is checked as thoroughly as Snapshot::restore checks it: a
+ * truncated or damaged file, a duplicate Record ID, a rating out of range, or
+ * a member that is not a Record is an ERROR.
+ *
+ * Everything returned refers into the file, so it is valid only until the
+ * view is closed, reopened, or destroyed.  Text save files cannot be viewed;
+ * convert them with Snapshot::convert first.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class Snapshot_view {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * A Record in the file.
+     */
+    struct Record_view {
+        /** ID number of the Record. */
+        int ID;
+
+        /** Rating, 0 if unrated. */
+        int rating;
+
+        /** Medium of the Record. */
+        String_view medium;
+
+        /** Title of the Record. */
+        String_view title;
+
+        int get_ID() const {
+            return ID;
+        }
+    };
+
+    /**
+     * A Collection in the file.  The IDs of its members are read with
+     * get_member().
+     */
+    struct Collection_view {
+        /** Name of the Collection. */
+        String_view name;
+
+        /** Number of members. */
+        int member_count;
+
+        /** The member IDs as stored in the file. */
+        const char* members;
+    };
+
+    /**
+     * Constructor for an empty view.
+     *
+     * @pre  None.
+     * @post View has no Records and no Collections.
+     */
+    Snapshot_view();
+
+    /**
+     * Unmaps the file, if one is open.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Snapshot_view();
+
+    /**
+     * Map a binary save file and locate its contents, closing any file open
+     * before.
+     *
+     * @pre  None.
+     * @post The contents of the file can be read, or the view is empty on
+     *       ERROR.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param path Name of the file
+     *
+     * @return ERROR if the file cannot be mapped or is not a valid binary
+     *         snapshot, otherwise OK
+     */
+    Status open(const char* const path);
+
+    /**
+     * Locate the contents of a binary snapshot already in memory, closing any
+     * file open before.
+     *
+     * @pre  data stays valid and unchanged until the view is closed.
+     * @post The contents of the snapshot can be read, or the view is empty on
+     *       ERROR.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param data Start of the snapshot
+     * @param size Length of the snapshot in bytes
+     *
+     * @return ERROR if data is not a valid binary snapshot, otherwise OK
+     */
+    Status attach(const char* const data, const size_t size);
+
+    /**
+     * Forget the contents and unmap the file.
+     *
+     * @pre  None.
+     * @post View has no Records and no Collections.
+     */
+    void close();
+
+    /**
+     * @return the number of Records
+     */
+    int get_record_count() const {
+        return myRecordCount;
+    }
+
+    /**
+     * @param i Index of the Record, 0 through get_record_count() - 1
+     *
+     * @return the Record in position i
+     */
+    const Record_view& get_record(const int i) const {
+        return myRecords[i];
+    }
+
+    /**
+     * @return the number of Collections
+     */
+    int get_collection_count() const {
+        return myCollectionCount;
+    }
+
+    /**
+     * @param i Index of the Collection, 0 through get_collection_count() - 1
+     *
+     * @return the Collection in position i
+     */
+    const Collection_view& get_collection(const int i) const {
+        return myCollections[i];
+    }
+
+    /**
+     * @param collection A Collection of this view
+     * @param i          Index of the member, 0 through member_count - 1
+     *
+     * @return the ID of member i of collection
+     */
+    static int get_member(const Collection_view& collection, const int i);
+
+  private:
+    /**
+     * Locate the contents of the snapshot at myData.
+     *
+     * @return ERROR if it is not a valid binary snapshot, otherwise OK
+     */
+    Status parse();
+
+    /**
+     * Check that the Record IDs are unique and every member is a Record.
+     *
+     * @return ERROR if any check fails, otherwise OK
+     */
+    Status validate() const;
+
+    /**
+     * The mapped file, if the snapshot came from open().
+     */
+    Mapped_file myFile;
+
+    /**
+     * The snapshot.
+     */
+    const char* myData;
+    size_t      mySize;
+
+    /**
+     * Media of the string table.
+     */
+    String_view* myMedia;
+    int          myMediaCount;
+
+    /**
+     * Records, in file order.
+     */
+    Record_view* myRecords;
+    int          myRecordCount;
+
+    /**
+     * Collections, in file order.
+     */
+    Collection_view* myCollections;
+    int              myCollectionCount;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Snapshot_view);
+};
+
+#endif  // MEDIAMANAGER_MANAGER_SNAPSHOT_VIEW_H_
@@ -0,0 +1,518 @@
+#ifndef MEDIAMANAGER_MANAGER_SORTED_ARRAY_H_
+#define MEDIAMANAGER_MANAGER_SORTED_ARRAY_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "glog/logging.h"
+#include "manager/Memory_stats.h"
+#include "manager/Ordered_list.h"
+#include "manager/Utility.h"
+
+
+/*
+ * Sorted_array_storage selects a form of Ordered_list that keeps its items
+ * side by side in one sorted array instead of in linked nodes, e.g.
+ *   Ordered_list<Record*, Sorted_array_storage> library;
+ *
+ * This suits a list that is built once and then searched many times: find is
+ * a binary search, iteration walks memory in order, and insert_range adds a
+ * whole batch of items with one sort and one merge.  Single inserts and
+ * erases shift the items after them, so they are O(n) moves (but no
+ * allocation per item).
+ *
+ * The interface is the same as for the plain Ordered_list, with one
+ * difference: insert, insert_range and erase invalidate every Iterator into
+ * the list, not just the erased one.  There are no nodes, so
+ * g_Ordered_list_Node_count is not affected; the array is counted in
+ * Memory_stats as bytes of the ORDERED_LIST.
+ */
+template<typename Node>
+class Sorted_array_storage;
+
+
+template<typename T, typename Ordering>
+class Ordered_list<T, Sorted_array_storage, Ordering> {
+  public:
+    // Capacity of the array when the first item is added.
+    static const int min_allocation = 8;
+
+    // The constructor takes the ordering function, as for the plain
+    // Ordered_list.
+    Ordered_list(const Ordering& ordering_function_ = Ordering());
+
+    // The range constructor builds the list from the items in
+    // [first_datum, last_datum), in any order; see insert_range.
+    template <typename Input_iterator>
+    Ordered_list(Input_iterator first_datum,
+                 Input_iterator last_datum,
+                 const Ordering& ordering_function_ = Ordering());
+
+    // The copy constructor produces a list holding copies of the data in the
+    // other list.
+    Ordered_list(const Ordered_list& other);
+
+    // Assignment uses the copy-swap idiom.
+    Ordered_list& operator= (const Ordered_list& rhs);
+
+    // The destructor destroys the items and deallocates the array.
+    ~Ordered_list();
+
+    // Delete the items in the list, if any.  The array is kept for reuse.
+    void clear();
+    // Return the number of items in the list
+    int size() const
+        {return length;}
+    // Return true if the list is empty
+    bool empty() const
+        {return 0 == length;}
+
+    // An Iterator object designates an item by encapsulating a pointer into
+    // the array.
+    class Iterator {
+      public:
+        // default initialize to zero
+        Iterator()
+          : item_ptr(0) {
+        }
+
+        // * returns a reference to the pointed-to item
+        T& operator* () const {
+            assert(item_ptr);
+            return *item_ptr;
+        }
+
+        // -> returns the address of the pointed-to item
+        T* operator-> () const {
+            assert(item_ptr);
+            return item_ptr;
+        }
+
+        // ++ operator moves the iterator forward to point to the next item
+        Iterator operator++ () {
+            assert(item_ptr);
+            item_ptr++;
+            return *this;
+        }
+
+        Iterator operator++ (int) {  // NOLINT(readability/function)
+            assert(item_ptr);
+            Iterator previous(*this);
+            item_ptr++;
+            return previous;
+        }
+
+        // Iterators ar equal if they point to the same item
+        bool operator== (Iterator rhs) const {
+            return item_ptr == rhs.item_ptr;
+        }
+
+        bool operator!= (Iterator rhs) const {
+            return item_ptr != rhs.item_ptr;
+        }
+
+        friend class Ordered_list;
+
+      private:
+        // Ordered_list uses this to create Iterators pointing to an item
+        explicit Iterator(T * in_item_ptr)
+          : item_ptr(in_item_ptr) {
+        }
+
+        T * item_ptr;
+    };
+    // end of nested Iterator class declaration
+
+    // return an iterator pointing to the first item
+    Iterator begin() const
+        {return Iterator(items);}
+    // return an iterator pointing to "past the end"
+    Iterator end() const
+        {return Iterator(items + length);}
+
+    // Add the new datum to the list before any "equal" items already there.
+    void insert(const T& new_datum);
+
+    // Add the items in [first_datum, last_datum) to the list, in any order.
+    // The result is the same as inserting them one at a time, but the batch
+    // is sorted once and merged with the list in a single pass.  The range
+    // must not refer to items in this list.
+    template <typename Input_iterator>
+    void insert_range(Input_iterator first_datum, Input_iterator last_datum);
+
+    // Delete the specified item.  Every Iterator into the list is invalid
+    // afterwards.
+    void erase(Iterator it);
+
+    // Return an iterator to the first item equal to probe_datum, or end() if
+    // there is none.  This is a binary search.
+    Iterator find(const T& probe_datum) const;
+
+    // Return an iterator to the first item that does not come before
+    // probe_datum, or end() if there is none.  This is a binary search.
+    Iterator lower_bound(const T& probe_datum) const;
+
+    // The apply functions work as they do for the plain Ordered_list.
+    template <typename Function>
+    void apply(Function apply_function) const;
+
+    template <typename Function>
+    bool apply_if(Function apply_function) const;
+
+    template <typename Arg, typename Function>
+    void apply_arg(Function apply_function, Arg apply_arg) const;
+
+    template <typename Arg, typename Function>
+    bool apply_if_arg(Function apply_function, Arg apply_arg) const;
+
+    // interchange the member variable values of this list with the other list
+    void swap(Ordered_list & other);  // NOLINT(build/include_what_you_use)
+
+  private:
+    // make room for at least new_length items
+    void reserve(const int new_length);
+
+    Ordering ordering_function;
+    // the items, in order; 0 if nothing was ever added
+    T * items;
+    // number of items in the list
+    int length;
+    // number of items the array has room for
+    int allocation;
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename T, typename Ordering>
+const int Ordered_list<T, Sorted_array_storage, Ordering>::min_allocation;
+
+// constructor
+template<typename T, typename Ordering>
+Ordered_list<T, Sorted_array_storage, Ordering>::Ordered_list(
+        const Ordering& ordering_function_)
+          : ordering_function(ordering_function_),
+            items(0),
+            length(0),
+            allocation(0) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list";
+
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list";
+}
+
+// copy constructor
+template<typename T, typename Ordering>
+Ordered_list<T, Sorted_array_storage, Ordering>::Ordered_list(
+        const Ordered_list& other)
+          : ordering_function(other.ordering_function),
+            items(0),
+            length(0),
+            allocation(0) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list(const "
+                  << "Ordered_list&)";
+
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+
+    reserve(other.length);
+    for (; length < other.length; length++) {
+        new(items + length) T(other.items[length]);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list(const "
+                  << "Ordered_list&)";
+}
+
+// range constructor
+template<typename T, typename Ordering>
+template <typename Input_iterator>
+Ordered_list<T, Sorted_array_storage, Ordering>::Ordered_list(
+        Input_iterator first_datum,
+        Input_iterator last_datum,
+        const Ordering& ordering_function_)
+          : ordering_function(ordering_function_),
+            items(0),
+            length(0),
+            allocation(0) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::Ordered_list("
+                  << "Input_iterator, Input_iterator)";
+
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 1, 0);
+    insert_range(first_datum, last_datum);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::Ordered_list("
+                  << "Input_iterator, Input_iterator)";
+}
+
+// assignment
+template<typename T, typename Ordering>
+Ordered_list<T, Sorted_array_storage, Ordering>&
+Ordered_list<T, Sorted_array_storage, Ordering>::operator= (
+        const Ordered_list& rhs) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::operator=";
+
+    Ordered_list temp(rhs);
+    swap(temp);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::operator=";
+    return *this;
+}
+
+// destructor
+template<typename T, typename Ordering>
+Ordered_list<T, Sorted_array_storage, Ordering>::~Ordered_list() {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::~Ordered_list";
+
+    clear();
+    ::operator delete(items);
+    Memory_stats::add(Memory_stats::ORDERED_LIST, -1,
+                      -allocation * static_cast<int64_t>(sizeof(T)));
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::~Ordered_list";
+}
+
+// clear
+template<typename T, typename Ordering>
+void Ordered_list<T, Sorted_array_storage, Ordering>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::clear";
+
+    for (int i = 0; i < length; i++) {
+        items[i].~T();
+    }
+    length = 0;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::clear";
+}
+
+// insert
+template<typename T, typename Ordering>
+void Ordered_list<T, Sorted_array_storage, Ordering>::insert(
+        const T& new_datum) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::insert";
+
+    // the datum may live in this list; copy it before the items move
+    T datum(new_datum);
+
+    // the new item goes in front of the first item that is not less than it
+    const int position = static_cast<int>(lower_bound(datum).item_ptr - items);
+    reserve(length + 1);
+
+    if (position == length) {
+        new(items + length) T(std::move(datum));
+    } else {
+        // open a gap by moving the tail up one place
+        new(items + length) T(std::move(items[length - 1]));
+        std::move_backward(items + position, items + length - 1,
+                           items + length);
+        items[position] = std::move(datum);
+    }
+    length++;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::insert";
+}
+
+// insert_range
+template<typename T, typename Ordering>
+template <typename Input_iterator>
+void Ordered_list<T, Sorted_array_storage, Ordering>::insert_range(
+        Input_iterator first_datum,
+        Input_iterator last_datum) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::insert_range";
+
+    // copy the batch onto the end of the array
+    const int old_length = length;
+    for (; first_datum != last_datum; ++first_datum) {
+        reserve(length + 1);
+        new(items + length) T(*first_datum);
+        length++;
+    }
+
+    // Inserting one at a time puts each item before the equal ones added
+    // earlier, so reverse the batch and sort it stably.  Then put it in front
+    // of the old items so the merge also prefers it on ties.
+    std::reverse(items + old_length, items + length);
+    std::stable_sort(items + old_length, items + length, ordering_function);
+    std::rotate(items, items + old_length, items + length);
+    std::inplace_merge(items, items + (length - old_length), items + length,
+                       ordering_function);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::insert_range";
+}
+
+// erase
+template<typename T, typename Ordering>
+void Ordered_list<T, Sorted_array_storage, Ordering>::erase(Iterator it) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::erase";
+
+    assert((it.item_ptr >= items) && (it.item_ptr < items + length));
+
+    // close the gap by moving the tail down one place
+    std::move(it.item_ptr + 1, items + length, it.item_ptr);
+    length--;
+    items[length].~T();
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::erase";
+}
+
+// find
+template<typename T, typename Ordering>
+typename Ordered_list<T, Sorted_array_storage, Ordering>::Iterator
+Ordered_list<T, Sorted_array_storage, Ordering>::find(
+        const T& probe_datum) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::find";
+
+    T * item = lower_bound(probe_datum).item_ptr;
+
+    // the item found is equal unless the probe comes before it
+    if ((item == items + length) || ordering_function(probe_datum, *item)) {
+        item = items + length;
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::find";
+    return Iterator(item);
+}
+
+// apply
+template<typename T, typename Ordering>
+template <typename Function>
+void Ordered_list<T, Sorted_array_storage, Ordering>::apply(
+        Function apply_function) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply";
+
+    for (int i = 0; i < length; i++) {
+        apply_function(items[i]);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply";
+}
+
+// apply_if
+template<typename T, typename Ordering>
+template <typename Function>
+bool Ordered_list<T, Sorted_array_storage, Ordering>::apply_if(
+        Function apply_function) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_if";
+
+    for (int i = 0; i < length; i++) {
+        if (apply_function(items[i])) {
+            TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if";
+            return true;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if";
+    return false;
+}
+
+// apply_arg
+template<typename T, typename Ordering>
+template <typename Arg, typename Function>
+void Ordered_list<T, Sorted_array_storage, Ordering>::apply_arg(
+        Function apply_function,
+        Arg apply_arg) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_arg";
+
+    for (int i = 0; i < length; i++) {
+        apply_function(items[i], apply_arg);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_arg";
+}
+
+// apply_if_arg
+template<typename T, typename Ordering>
+template <typename Arg, typename Function>
+bool Ordered_list<T, Sorted_array_storage, Ordering>::apply_if_arg(
+        Function apply_function,
+        Arg apply_arg) const {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::apply_if_arg";
+
+    for (int i = 0; i < length; i++) {
+        if (apply_function(items[i], apply_arg)) {
+            TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if_arg";
+            return true;
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::apply_if_arg";
+    return false;
+}
+
+// swap
+template<typename T, typename Ordering>
+void Ordered_list<T, Sorted_array_storage, Ordering>::swap(
+        Ordered_list & other) {
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::swap";
+
+    std::swap(ordering_function, other.ordering_function);
+    std::swap(items,             other.items);
+    std::swap(length,            other.length);
+    std::swap(allocation,        other.allocation);
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::swap";
+}
+
+// lower_bound
+template<typename T, typename Ordering>
+typename Ordered_list<T, Sorted_array_storage, Ordering>::Iterator
+Ordered_list<T, Sorted_array_storage, Ordering>::lower_bound(
+        const T& probe_datum) const {
+    return Iterator(std::lower_bound(items, items + length, probe_datum,
+                                     ordering_function));
+}
+
+// reserve
+template<typename T, typename Ordering>
+void Ordered_list<T, Sorted_array_storage, Ordering>::reserve(
+        const int new_length) {
+    if (new_length <= allocation) {
+        return;
+    }
+
+    TRACE_VLOG(1) << "Method Entry:  Ordered_list::reserve";
+    TRACE_VLOG(2) << "Called with arguments\tnew_length = ->" << new_length
+                  << "<-";
+
+    const int new_allocation = std::max(new_length,
+                                        std::max(2 * allocation,
+                                                 static_cast<int>(
+                                                     min_allocation)));
+    const size_t bytes = static_cast<size_t>(new_allocation) * sizeof(T);
+    T * const new_items = static_cast<T *>(::operator new(bytes,
+                                                          std::nothrow));
+    if (0 == new_items) {
+        LOG(FATAL) << "Ordered_list::reserve - call to new failed!";
+        return;  // unreachable
+    }
+    Memory_stats::note_allocation(Memory_stats::ORDERED_LIST, bytes);
+    Memory_stats::add(Memory_stats::ORDERED_LIST, 0,
+                      (new_allocation - allocation) *
+                      static_cast<int64_t>(sizeof(T)));
+
+    // move the items across and destroy the originals
+    for (int i = 0; i < length; i++) {
+        new(new_items + i) T(std::move(items[i]));
+        items[i].~T();
+    }
+    ::operator delete(items);
+
+    items = new_items;
+    allocation = new_allocation;
+
+    TRACE_VLOG(1) << "Method Exit :  Ordered_list::reserve";
+}
+
+#endif  // MEDIAMANAGER_MANAGER_SORTED_ARRAY_H_
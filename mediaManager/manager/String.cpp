@@ -11,77 +11,116 @@
 #include <cstring>
 #include <new>
   using std::nothrow;
-
-#include "boost/shared_array.hpp"
-  using boost::shared_array;
+#include <utility>
 
 #include "glog/logging.h"
 
+#include "manager/Memory_stats.h"
 #include "manager/Utility.h"
 
 
 // initialize static members
-int  String::ourNumber          = 0;
-int  String::ourTotalAllocation = 0;
+const int String::ourInlineCapacity;
 
 
 // constructor
 String::String()
           : myCStrSize(0),
             myCStrAllocation(0) {
-    VLOG(1) << "Method Entry:  String::String";
-    VLOG(1) << "Method Exit :  String::String";
+    TRACE_VLOG(1) << "Method Entry:  String::String";
+
+    myCStr.inlineCStr[0] = '\0';
+
+    TRACE_VLOG(1) << "Method Exit :  String::String";
+}
+
+// move constructor
+String::String(String&& other)
+          : myCStr(other.myCStr),
+            myCStrSize(other.myCStrSize),
+            myCStrAllocation(other.myCStrAllocation) {
+    TRACE_VLOG(1) << "Method Entry:  String::String(String&&)";
+    TRACE_VLOG(2) << "Called with arguments\tother = ->" << c_str() << "<-";
+
+    // other no longer owns the buffer
+    other.myCStr.inlineCStr[0] = '\0';
+    other.myCStrSize = 0;
+    other.myCStrAllocation = 0;
+
+    // update the statistics - the allocation moved with the buffer
+    Memory_stats::add(Memory_stats::STRING, 1, 0);
+
+    TRACE_VLOG(1) << "Method Exit :  String::String(String&&)";
 }
 
+// move assignment
+String& String::operator=(String&& other) {
+    TRACE_VLOG(1) << "Method Entry:  String::operator=(String&&)";
+    TRACE_VLOG(2) << "Called with arguments\tother = ->" << other.c_str()
+                  << "<-";
+
+    // the temporary takes other's buffer and releases ours when it goes away
+    String temp(std::move(other));
+    swap(temp);
+
+    TRACE_VLOG(1) << "Method Exit :  String::operator=(String&&)";
+    return *this;
+}
 // init
 String::Status String::init(const char* const in_cstr) {
-    VLOG(1) << "Method Entry:  String::init";
-    VLOG(2) << "Called with arguments\tin_cstr = ->" << in_cstr << "<-";
+    TRACE_VLOG(1) << "Method Entry:  String::init";
+    TRACE_VLOG(2) << "Called with arguments\tin_cstr = ->" << in_cstr << "<-";
+
+    const int len = static_cast<int>(strlen(in_cstr));
 
-    // create the internal buffer
-    myCStrSize = static_cast<int>(strlen(in_cstr));
+    // the old contents are not kept, so resizing has nothing to copy
+    myCStrSize = 0;
 
-    if (OK != resizeCStrBuffer(myCStrSize + 1)) {
+    // create the internal buffer with minimum allocation
+    if ((len + 1 != myCStrAllocation) &&
+        (OK != resizeCStrBuffer(len + 1))) {
         LOG(FATAL) << "Call to String::resizeCStrBuffer failed!";
         return ERROR;
     }
 
-    // copy the data
-    strncpy(myCStr.get(), in_cstr,
-            static_cast<size_t>(myCStrAllocation));
+    // copy the data, NULL character included
+    memcpy(getCStrBuffer(), in_cstr, static_cast<size_t>(len + 1));
+    myCStrSize = len;
 
-    // update the static members
-    ourNumber++;
-    ourTotalAllocation += myCStrAllocation;
+    // update the statistics
+    Memory_stats::add(Memory_stats::STRING, 1, 0);
 
-    VLOG(1) << "Method Exit :  String::init";
+    TRACE_VLOG(1) << "Method Exit :  String::init";
     return OK;
 }
 
 // destructor
 String::~String() {
-    VLOG(1) << "Method Entry:  String::~String";
+    TRACE_VLOG(1) << "Method Entry:  String::~String";
+
+    if (myCStrAllocation > ourInlineCapacity) {
+        delete [] myCStr.heapCStr;
+    }
 
-    // update the static members
-    ourNumber--;
-    ourTotalAllocation -= myCStrAllocation;
+    // update the statistics
+    Memory_stats::add(Memory_stats::STRING, -1, -myCStrAllocation);
 
-    VLOG(1) << "Method Exit :  String::~String";
+    TRACE_VLOG(1) << "Method Exit :  String::~String";
 }
 
 // get
 String::Status String::get(const int i,
                            char* val) const {
-    VLOG(1) << "Method Entry:  String::get";
-    VLOG(2) << "Called with arguments\ti = ->" << i << "<-";
+    TRACE_VLOG(1) << "Method Entry:  String::get";
+    TRACE_VLOG(2) << "Called with arguments\ti = ->" << i << "<-";
 
     if ((i < 0) || (i >= myCStrSize)) {
         LOG(ERROR) << "Subscript out of range";
         return ERROR;
     }
 
-    *val = myCStr[i];
-    VLOG(1) << "Method Exit :  String::get";
+    *val = getCStrBuffer()[i];
+    TRACE_VLOG(1) << "Method Exit :  String::get";
     return OK;
 }
 
@@ -89,9 +128,9 @@ String::Status String::get(const int i,
 String::Status String::substring(const int i,
                                  const int len,
                                  String* str) const {
-    VLOG(1) << "Method Entry:  String::substring";
-    VLOG(2) << "Called with arguments\ti = ->" << i
-            << "<-\tlen = ->" << len << "<-";
+    TRACE_VLOG(1) << "Method Entry:  String::substring";
+    TRACE_VLOG(2) << "Called with arguments\ti = ->" << i
+                  << "<-\tlen = ->" << len << "<-";
 
     if ((i < 0) || (len < 0) || (i > myCStrSize) ||
        ((i + len) > myCStrSize)) {
@@ -99,37 +138,48 @@ String::Status String::substring(const int i,
         return ERROR;
     }
 
-    // copy the values to the new String object
-    str->clear();
-    str->resizeCStrBuffer(len + 1);
+    // the old contents of str are not kept; give it minimum allocation
+    str->myCStrSize = 0;
+    if (len + 1 != str->myCStrAllocation) {
+        str->resizeCStrBuffer(len + 1);
+    }
 
+    // copy the values to the new String object
+    char* const buffer = str->getCStrBuffer();
+    memcpy(buffer,
+           getCStrBuffer() + i,
+           static_cast<size_t>(len));
+    buffer[len] = '\0';
     str->myCStrSize = len;
-    strncpy(str->myCStr.get(),
-            myCStr.get() + i,
-            static_cast<size_t>(len));
-    str->myCStr[len] = '\0';
 
-    VLOG(1) << "Method Exit :  String::substring";
+    TRACE_VLOG(1) << "Method Exit :  String::substring";
     return OK;
 }
 
 // clear
 void String::clear() {
-    VLOG(1) << "Method Entry:  String::clear";
+    TRACE_VLOG(1) << "Method Entry:  String::clear";
 
-    String temp;
-    temp.init("");
-    swap(temp);
+    if (myCStrAllocation > ourInlineCapacity) {
+        delete [] myCStr.heapCStr;
+    }
 
-    VLOG(1) << "Method Exit :  String::clear";
+    // update the statistics for the new minimum allocation
+    Memory_stats::add(Memory_stats::STRING, 0, 1 - myCStrAllocation);
+
+    myCStrSize = 0;
+    myCStrAllocation = 1;
+    myCStr.inlineCStr[0] = '\0';
+
+    TRACE_VLOG(1) << "Method Exit :  String::clear";
 }
 
 // remove
 String::Status String::remove(const int i,
                               const int len) {
-    VLOG(1) << "Method Entry:  String::remove";
-    VLOG(2) << "Called with arguments\ti = ->" << i
-            << "<-\tlen = ->" << len << "<-";
+    TRACE_VLOG(1) << "Method Entry:  String::remove";
+    TRACE_VLOG(2) << "Called with arguments\ti = ->" << i
+                  << "<-\tlen = ->" << len << "<-";
 
     if ((i < 0) || (len < 0) || (i > myCStrSize) ||
        ((i + len) > myCStrSize)) {
@@ -137,79 +187,126 @@ String::Status String::remove(const int i,
         return ERROR;
     }
 
-    // move the characters down starting at i len times
-    for (int index = 0; index < myCStrSize - len - i; index++) {
-        myCStr[index + i] = myCStr[index + i + len];
-    }
+    // move the tail down in one block, NULL character included
+    char* const buffer = getCStrBuffer();
+    memmove(buffer + i,
+            buffer + i + len,
+            static_cast<size_t>(myCStrSize - i - len + 1));
 
-    // update the size and restore the NULL character
+    // update the size
     myCStrSize -= len;
-    myCStr[myCStrSize] = '\0';
 
-    VLOG(1) << "Method Exit :  String::remove";
+    TRACE_VLOG(1) << "Method Exit :  String::remove";
     return OK;
 }
 
 // insert_before
 String::Status String::insert_before(const int i,
                                      const String& src) {
-    VLOG(1) << "Method Entry:  String::insert_before";
-    VLOG(2) << "Called with arguments\ti = ->" << i
-            << "<-\tsrc = ->" << src.c_str() << "<-";
+    TRACE_VLOG(1) << "Method Entry:  String::insert_before";
+    TRACE_VLOG(2) << "Called with arguments\ti = ->" << i
+                  << "<-\tsrc = ->" << src.c_str() << "<-";
 
     if ((i < 0) || (i > myCStrSize)) {
         LOG(ERROR) << "Insertion point out of range";
         return ERROR;
     }
 
-    // create a new buffer if needed
-    const int alloc = myCStrSize + src.size() + 1;
-    if (alloc >= myCStrAllocation) {
-        resizeCStrBuffer(2 * alloc);
-    }
+    replaceCStr(i, 0, src.c_str(), src.size());
+
+    TRACE_VLOG(1) << "Method Exit :  String::insert_before";
+    return OK;
+}
+
+// replace
+String::Status String::replace(const int i,
+                               const int len,
+                               const String& src) {
+    TRACE_VLOG(1) << "Method Entry:  String::replace";
+    TRACE_VLOG(2) << "Called with arguments\ti = ->" << i
+                  << "<-\tlen = ->" << len
+                  << "<-\tsrc = ->" << src.c_str() << "<-";
 
-    // make space for the new chars
-    for (int index = 0; index < myCStrSize - i; index++) {
-        myCStr[index + i + src.myCStrSize] =
-          myCStr[index + i];
+    if ((i < 0) || (len < 0) || (i > myCStrSize) ||
+       ((i + len) > myCStrSize)) {
+        LOG(ERROR) << "Replace bounds invalid";
+        return ERROR;
     }
 
-    // need a little magic to suppress a compiler warning
-    const size_t sizetI = static_cast<size_t>(i);
+    replaceCStr(i, len, src.c_str(), src.size());
+
+    TRACE_VLOG(1) << "Method Exit :  String::replace";
+    return OK;
+}
+
+// append
+String::Status String::append(const char* const in_cstr,
+                              const int len) {
+    TRACE_VLOG(1) << "Method Entry:  String::append";
+    TRACE_VLOG(2) << "Called with arguments\tlen = ->" << len << "<-";
 
-    // then copy the src characters
-    strncpy(myCStr.get() + (sizeof(char) * sizetI),  // NOLINT
-            src.myCStr.get(),
-            static_cast<size_t>(src.myCStrSize));
+    if ((len < 0) || ((0 == in_cstr) && (len > 0))) {
+        LOG(ERROR) << "Append source invalid";
+        return ERROR;
+    }
 
-    // then change the instance variables
-    myCStrSize += src.myCStrSize;
-    myCStr[myCStrSize] = '\0';
+    replaceCStr(myCStrSize, 0, in_cstr, len);
 
-    VLOG(1) << "Method Exit :  String::insert_before";
+    TRACE_VLOG(1) << "Method Exit :  String::append";
     return OK;
 }
 
 // swap
 void String::swap(String& other) {
-    VLOG(1) << "Method Entry:  String::swap";
-    VLOG(2) << "Called with arguments\tother = ->" << other.c_str() << "<-";
+    TRACE_VLOG(1) << "Method Entry:  String::swap";
+    TRACE_VLOG(2) << "Called with arguments\tother = ->" << other.c_str()
+                  << "<-";
 
     std::swap(myCStr,           other.myCStr);
     std::swap(myCStrSize,       other.myCStrSize);
     std::swap(myCStrAllocation, other.myCStrAllocation);
 
-    VLOG(1) << "Method Exit :  String::swap";
+    TRACE_VLOG(1) << "Method Exit :  String::swap";
+}
+
+// reserve
+String::Status String::reserve(const int alloc) {
+    TRACE_VLOG(1) << "Method Entry:  String::reserve";
+    TRACE_VLOG(2) << "Called with arguments\talloc = ->" << alloc << "<-";
+
+    if (alloc < 0) {
+        LOG(ERROR) << "Requested allocation ->" << alloc << "<- is negative";
+        return ERROR;
+    }
+
+    // never give memory back here - that is what shrink_to_fit is for
+    if (alloc > myCStrAllocation) {
+        resizeCStrBuffer(alloc);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  String::reserve";
+    return OK;
+}
+
+// shrink_to_fit
+void String::shrink_to_fit() {
+    TRACE_VLOG(1) << "Method Entry:  String::shrink_to_fit";
+
+    if (myCStrAllocation > myCStrSize + 1) {
+        resizeCStrBuffer(myCStrSize + 1);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  String::shrink_to_fit";
 }
 
 // resizeCStrBuffer
 String::Status String::resizeCStrBuffer(const int alloc) {
-    VLOG(1) << "Method Entry:  String::resizeCStrBuffer";
-    VLOG(2) << "Called with arguments\talloc = ->" << alloc << "<-";
+    TRACE_VLOG(1) << "Method Entry:  String::resizeCStrBuffer";
+    TRACE_VLOG(2) << "Called with arguments\talloc = ->" << alloc << "<-";
 
-    if (alloc < myCStrAllocation) {
-        LOG(ERROR) << "Requested allocation ->" << alloc << "<- is less than"
-                   << " current allocation ->" << myCStrAllocation
+    if (alloc < myCStrSize + 1) {
+        LOG(ERROR) << "Requested allocation ->" << alloc << "<- cannot hold"
+                   << " current size ->" << myCStrSize
                    << "<-";
         return ERROR;
     }
@@ -220,26 +317,123 @@ String::Status String::resizeCStrBuffer(const int alloc) {
         return OK;
     }
 
-    // we have to break convention in order to use Boost and no exceptions
+    char* const current = getCStrBuffer();
+    const bool currentOnHeap = (myCStrAllocation > ourInlineCapacity);
+
+    // only the live chars and the NULL character need to be copied
+    const size_t liveBytes = static_cast<size_t>(myCStrSize + 1);
+
+    if (alloc > ourInlineCapacity) {
+        char* const buffer = newCStrBuffer(alloc);
+        memcpy(buffer, current, liveBytes);
+
+        if (currentOnHeap) {
+            delete [] current;
+        }
+
+        myCStr.heapCStr = buffer;
+    } else if (currentOnHeap) {
+        // shrinking back into the inline buffer, which shares its storage
+        // with the heap pointer
+        memcpy(myCStr.inlineCStr, current, liveBytes);
+        delete [] current;
+    }
+
+    // update the statistics
+    Memory_stats::add(Memory_stats::STRING, 0, alloc - myCStrAllocation);
     myCStrAllocation = alloc;
-    char* const buffer = new(nothrow) char[myCStrAllocation];
 
-    // if new fails then we fail
-    if (0 == buffer) {
-        LOG(FATAL) << "String::resizeCStrBuffer - call to new[] failed!";
-        return ERROR;  // unreachable
+    TRACE_VLOG(1) << "Method Exit :  String::resizeCStrBuffer";
+    return OK;
+}
+
+// replaceCStr
+void String::replaceCStr(const int i,
+                         const int len,
+                         const char* const src,
+                         const int srcLen) {
+    TRACE_VLOG(1) << "Method Entry:  String::replaceCStr";
+    TRACE_VLOG(2) << "Called with arguments\ti = ->" << i
+                  << "<-\tlen = ->" << len
+                  << "<-\tsrcLen = ->" << srcLen << "<-";
+
+    char* const buffer = getCStrBuffer();
+
+    // the source may be part of this String (e.g. inserting a String into
+    // itself) - take a private copy so shifting the tail can't clobber it
+    if ((srcLen > 0) && (src >= buffer) && (src < buffer + myCStrAllocation)) {
+        char* const copy = newCStrBuffer(srcLen);
+        memcpy(copy, src, static_cast<size_t>(srcLen));
+        replaceCStr(i, len, copy, srcLen);
+        delete [] copy;
+
+        TRACE_VLOG(1) << "Method Exit :  String::replaceCStr";
+        return;
     }
 
-    shared_array<char> temp(buffer);
+    const int newSize = myCStrSize - len + srcLen;
+    const size_t tailLen = static_cast<size_t>(myCStrSize - i - len + 1);
+
+    // apply the doubling rule if the result does not fit
+    if (newSize + 1 > myCStrAllocation) {
+        const int alloc = 2 * (newSize + 1);
+
+        if (alloc > ourInlineCapacity) {
+            char* const heapBuffer = newCStrBuffer(alloc);
+
+            // build the result in the new buffer in a single pass:
+            // head, source, then tail with its NULL character
+            memcpy(heapBuffer, buffer, static_cast<size_t>(i));
+            memcpy(heapBuffer + i, src, static_cast<size_t>(srcLen));
+            memcpy(heapBuffer + i + srcLen, buffer + i + len, tailLen);
+
+            if (myCStrAllocation > ourInlineCapacity) {
+                delete [] buffer;
+            }
+
+            // update the statistics
+            Memory_stats::add(Memory_stats::STRING, 0,
+                              alloc - myCStrAllocation);
+
+            myCStr.heapCStr = heapBuffer;
+            myCStrSize = newSize;
+            myCStrAllocation = alloc;
+
+            TRACE_VLOG(1) << "Method Exit :  String::replaceCStr";
+            return;
+        }
 
-    // copy the chars over
-    if (0 != myCStr) {
-        strncpy(temp.get(), myCStr.get(),
-                static_cast<size_t>(myCStrAllocation));
+        // still fits in the inline buffer; only the allocation changes
+        Memory_stats::add(Memory_stats::STRING, 0, alloc - myCStrAllocation);
+        myCStrAllocation = alloc;
     }
 
-    myCStr = temp;
-    VLOG(1) << "Method Exit :  String::resizeCStrBuffer";
-    return OK;
+    // shift the tail in one block, then drop in the source
+    memmove(buffer + i + srcLen, buffer + i + len, tailLen);
+    if (srcLen > 0) {
+        // an empty source may be a null pointer
+        memcpy(buffer + i, src, static_cast<size_t>(srcLen));
+    }
+    myCStrSize = newSize;
+
+    TRACE_VLOG(1) << "Method Exit :  String::replaceCStr";
 }
 
+// newCStrBuffer
+char* String::newCStrBuffer(const int alloc) {
+    TRACE_VLOG(1) << "Method Entry:  String::newCStrBuffer";
+    TRACE_VLOG(2) << "Called with arguments\talloc = ->" << alloc << "<-";
+
+    // nothrow new so that failure goes through LOG rather than an exception
+    const size_t bytes = static_cast<size_t>(alloc);
+    char* const buffer = new(nothrow) char[bytes];
+
+    // if new fails then we fail
+    if (0 == buffer) {
+        LOG(FATAL) << "String::newCStrBuffer - call to new[] failed!";
+    }
+    Memory_stats::note_allocation(Memory_stats::STRING, alloc);
+
+    TRACE_VLOG(1) << "Method Exit :  String::newCStrBuffer";
+    return buffer;
+}
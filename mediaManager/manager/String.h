@@ -7,8 +7,8 @@
  */
 
 
-#include "boost/shared_array.hpp"
 #include "glog/logging.h"
+#include "manager/Memory_stats.h"
 #include "manager/Utility.h"
 
 
@@ -23,10 +23,11 @@
  *
  * @brief A subset of the C++ Standard Library string class.
  *
- * @details String objects contain a C-string in a dynamically allocated piece
- * of memory and supports input/output, comparisons, copy, assignment, and
- * concatenation, access to individual characters and substrings, and insertion
- * and removal of parts of the string.
+ * @details String objects contain a C-string in memory owned by the String,
+ * either an inline buffer for short strings or a dynamically allocated piece
+ * of memory, and support input/output, comparisons, copy, assignment, and
+ * concatenation, access to individual characters and substrings, and
+ * insertion and removal of parts of the string.
  *
  * Individual characters in the string are indexed the same as an array, 0
  * through length - 1.  The "size" of the string is the length of the internal
@@ -34,6 +35,11 @@
  * the end of the C-string. The "allocation" does count the null byte. Thus
  * allocation must be >= size + 1.
  *
+ * Short C-strings are not put on the heap at all: if the allocation fits in
+ * String::ourInlineCapacity bytes, the characters are kept in a small buffer
+ * inside the String object itself.  This is purely a storage detail - the
+ * size, allocation, and static accounting are identical to the heap case.
+ *
  * Most operations result in a string that occupies the minimum amount of
  * memory (allocation = size + 1), but for efficiency, the operations that
  * involve adding characters to the string such as += use a doubling rule for
@@ -53,7 +59,10 @@
  * - Any operator that should be implemented in terms of +=, such as operator+
  *   and operator>>, and the function getline, will then also follow the
  *   doubling rule as a result.
- * - The insert_before function follows the doubling rule.
+ * - The insert_before, replace, and append functions follow the doubling
+ *   rule.
+ * - reserve sets the allocation explicitly and shrink_to_fit returns it to
+ *   the minimum.
  * - All other functions and operators either leave the allocation unchanged
  *   (e.g. swap) or result in the minimum allocation (size +1).
  *
@@ -76,6 +85,9 @@
  * may result in these messages being output, but only because they call a
  * Constructor, Destructor, or Assignment operator as part of their work.
  *
+ * Method entry/exit tracing goes through TRACE_VLOG and is only present in
+ * builds made with TRACE=on.
+ *
  * @author    Marc Schweikert
  * @date      29-Sep-2012
  * @version   1.0
@@ -91,6 +103,12 @@ class String {
         ERROR   /**< Method did not complete execution. */
     };
 
+    /**
+     * Largest allocation (including the null byte) that is stored inside the
+     * String object instead of in a separately allocated heap buffer.
+     */
+    static const int ourInlineCapacity = 16;
+
     /**
      * Constructor that initializes all member variables and nothing else.
      *
@@ -116,7 +134,32 @@ class String {
     Status init(const char* const in_cstr = "");
 
     /**
-     * Does not have to perform cleanup because of boost::shared_array.
+     * Move constructor.  Takes over the C-string of other without copying a
+     * heap buffer; other is left empty with zero allocation, as if it had
+     * just been constructed.
+     *
+     * @pre  None.
+     * @post This String holds the former contents of other.
+     *
+     * @param other String to take the contents from
+     */
+    String(String&& other);
+
+    /**
+     * Move assignment.  Releases the current C-string and takes over the
+     * C-string of other; other is left empty with zero allocation.
+     *
+     * @pre  None.
+     * @post This String holds the former contents of other.
+     *
+     * @param other String to take the contents from
+     *
+     * @return reference to this String
+     */
+    String& operator=(String&& other);
+
+    /**
+     * Releases the heap buffer, if any.
      * Decrements static members.
      *
      * @pre  None.
@@ -187,8 +230,8 @@ class String {
                      String* str) const;
 
     /**
-     * Set to an empty string with minimum allocation by create/swap
-     * with an empty string.
+     * Set to an empty string with minimum allocation, releasing any heap
+     * buffer in place.
      *
      * @pre  None.
      * @post Object has default allocation.
@@ -232,11 +275,74 @@ class String {
     Status insert_before(const int i,
                          const String& src);
 
+    /**
+     * Replace the len characters starting at i with the supplied source
+     * String, shifting the rest of the contents as needed.  The replaced
+     * characters must be contained within the String.  If the result does not
+     * fit, the doubling rule applies; otherwise the allocation is unchanged.
+     *
+     * @pre  i >= 0
+     * @pre  i <= this.size
+     * @pre  len >= 0
+     * @pre  (i + len) <= this.size
+     * @post Requested chars are replaced by the chars of src.
+     *
+     * @param i   Starting position.
+     * @param len Number of chars to replace.
+     * @param src Source String.
+     *
+     * @return String::ERROR if i and/or len is out-of-bounds, otherwise String::OK
+     */
+    Status replace(const int i,
+                   const int len,
+                   const String& src);
+
+    /**
+     * Append len characters from a raw character array, which does not need
+     * to be null-terminated.  Follows the doubling rule.
+     *
+     * @pre  len >= 0
+     * @pre  in_cstr points to at least len characters
+     * @post Requested chars are added to the end of this String.
+     *
+     * @param in_cstr Characters to append.
+     * @param len     Number of characters to append.
+     *
+     * @return String::ERROR if len is negative or in_cstr is NULL,
+     *         otherwise String::OK
+     */
+    Status append(const char* const in_cstr,
+                  const int len);
+
+    /**
+     * Make the allocation at least alloc chars (counting the null byte), so
+     * that contents up to that size can be built without reallocation.
+     * The allocation is never reduced.
+     *
+     * @pre  alloc >= 0
+     * @post this.allocation >= alloc
+     *
+     * @param alloc Allocation wanted.
+     *
+     * @return String::ERROR if alloc is negative, otherwise String::OK
+     */
+    Status reserve(const int alloc);
+
+    /**
+     * Reduce the allocation to the minimum (size + 1), releasing any slack
+     * left by the doubling rule, reserve, or removals.
+     *
+     * @pre  None.
+     * @post this.allocation == this.size + 1, unless it was already smaller.
+     */
+    void shrink_to_fit();
+
     /**
      * Swap the contents of this String with another one.
      * The member variable values are interchanged, along with the pointers to
-     * the allocated C-strings, but the two C-strings are neither copied nor
-     * modified. No memory allocation/deallocation is done.
+     * the allocated C-strings, but heap C-strings are neither copied nor
+     * modified. Inline C-strings are exchanged by value. No memory
+     * allocation/deallocation is done.
      *
      * @pre  None.
      * @post Member variables of two Strings are swapped.
@@ -246,7 +352,8 @@ class String {
     void swap(String& other);  // NOLINT(build/include_what_you_use)
 
     /**
-     * @return the total number of Strings in existence
+     * @return the total number of Strings in existence, as counted by
+     *         Memory_stats
      */
     static int get_number();
 
@@ -257,41 +364,86 @@ class String {
 
   private:
     /**
-     * Resize the internal C-String.
+     * Resize the internal C-String, growing or shrinking it and moving it
+     * between the inline buffer and the heap as needed.  Only the live chars
+     * are copied.  Keeps the total allocation static member up to date.
      *
-     * @pre  alloc > this.allocation
+     * @pre  alloc >= this.size + 1
      * @post Internal C-String resized and chars retained.
      *
      * @param alloc New size of internal buffer.
      *
-     * @return String::ERROR if new fails, otherwise String::OK
+     * @return String::ERROR if alloc cannot hold the current contents,
+     *         otherwise String::OK
      */
     Status resizeCStrBuffer(const int alloc);
 
     /**
-     * Internal C-String using Boost.
+     * Allocate a heap buffer for the internal C-String.
+     *
+     * @warning If new[] fails, the program will LOG and terminate.
+     *
+     * @param alloc Number of chars to allocate.
+     *
+     * @return the new buffer, owned by the caller
      */
-    boost::shared_array<char> myCStr;
+    static char* newCStrBuffer(const int alloc);
 
     /**
-     * Size of internal C-String.
+     * Replace len characters starting at i with srcLen characters from src,
+     * using block moves.  Grows by the doubling rule when the result does
+     * not fit, building the result directly in the new buffer.
+     * src may point into this String.
+     *
+     * @pre  Bounds have been checked by the caller.
+     * @post Internal C-String holds the result.
+     *
+     * @param i      Starting position.
+     * @param len    Number of chars to replace.
+     * @param src    Characters to put in their place.
+     * @param srcLen Number of characters in src.
      */
-    int myCStrSize;
+    void replaceCStr(const int i,
+                     const int len,
+                     const char* const src,
+                     const int srcLen);
 
     /**
-     * Total bytes allocated for the internal C-String.
+     * @pre  None.
+     * @post Object remains unchanged.
+     *
+     * @return the inline buffer or the heap buffer, whichever holds the
+     *         internal C-String for the current allocation
      */
-    int myCStrAllocation;
+    char* getCStrBuffer() const;
 
     /**
-     * Counts the number of String objects in existence.
+     * Storage for the internal C-String: an owned heap buffer when the
+     * allocation is larger than ourInlineCapacity, otherwise the characters
+     * themselves.
      */
-    static int ourNumber;
+    union CStrStorage {
+        /** Owned heap buffer, allocated with new[]. */
+        char* heapCStr;
+
+        /** Characters stored in place. */
+        char inlineCStr[ourInlineCapacity];  // NOLINT(runtime/arrays)
+    };
 
     /**
-     * Counts the total amount of memory allocated.
+     * Internal C-String.
      */
-    static int ourTotalAllocation;
+    CStrStorage myCStr;
+
+    /**
+     * Size of internal C-String.
+     */
+    int myCStrSize;
+
+    /**
+     * Total bytes allocated for the internal C-String.
+     */
+    int myCStrAllocation;
 
     /**
      * Remove copy constructor and assignment operator.
@@ -306,33 +458,42 @@ class String {
 
 
 inline char* String::c_str() const {
-    VLOG(1) << "Method Entry:  String::c_str";
-    VLOG(1) << "Method Exit :  String::c_str";
-    return myCStr.get();
+    TRACE_VLOG(1) << "Method Entry:  String::c_str";
+    TRACE_VLOG(1) << "Method Exit :  String::c_str";
+    return getCStrBuffer();
 }
 
 inline int String::size() const {
-    VLOG(1) << "Method Entry:  String::size";
-    VLOG(1) << "Method Exit :  String::size";
+    TRACE_VLOG(1) << "Method Entry:  String::size";
+    TRACE_VLOG(1) << "Method Exit :  String::size";
     return myCStrSize;
 }
 
 inline int String::get_allocation() const {
-    VLOG(1) << "Method Entry:  String::get_allocation";
-    VLOG(1) << "Method Exit :  String::get_allocation";
+    TRACE_VLOG(1) << "Method Entry:  String::get_allocation";
+    TRACE_VLOG(1) << "Method Exit :  String::get_allocation";
     return myCStrAllocation;
 }
 
 inline int String::get_number() {
-    VLOG(1) << "Method Entry:  String::get_number";
-    VLOG(1) << "Method Exit :  String::get_number";
-    return ourNumber;
+    TRACE_VLOG(1) << "Method Entry:  String::get_number";
+    TRACE_VLOG(1) << "Method Exit :  String::get_number";
+    return static_cast<int>(Memory_stats::get_count(Memory_stats::STRING));
 }
 
 inline int String::get_total_allocation() {
-    VLOG(1) << "Method Entry:  String::get_total_allocation";
-    VLOG(1) << "Method Exit :  String::get_total_allocation";
-    return ourTotalAllocation;
+    TRACE_VLOG(1) << "Method Entry:  String::get_total_allocation";
+    TRACE_VLOG(1) << "Method Exit :  String::get_total_allocation";
+    return static_cast<int>(Memory_stats::get_bytes(Memory_stats::STRING));
+}
+
+inline char* String::getCStrBuffer() const {
+    if (myCStrAllocation > ourInlineCapacity) {
+        return myCStr.heapCStr;
+    }
+
+    // the inline buffer is part of this object; c_str() hands out non-const
+    return const_cast<char*>(myCStr.inlineCStr);
 }
 
 
@@ -0,0 +1,146 @@
+#ifndef MEDIAMANAGER_MANAGER_STRING_VIEW_H_
+#define MEDIAMANAGER_MANAGER_STRING_VIEW_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstring>
+
+#include "manager/String.h"
+
+
+/**
+ * @file String_view.h
+ * @brief Declaration and definition of String_view class.
+ */
+
+
+/**
+ * @class String_view String_view.h manager/String_view.h
+ *
+ * @brief A read-only reference to characters owned by something else.
+ *
+ * @details A String_view is a pointer and a length.  It does not allocate,
+ * copy, or free anything, so it is only valid as long as the characters it
+ * refers to - typically a String, a string literal, or a memory-mapped save
+ * file (see Snapshot_view).  The characters need not be null-terminated, so
+ * there is no c_str(); use data() with size().
+ *
+ * String_views compare by their characters, in the same order as strcmp
+ * gives for C-strings.  They are cheap to copy and are passed by value.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+class String_view {
+  public:
+    /**
+     * Constructor for an empty view.
+     */
+    String_view()
+      : myData(""),
+        mySize(0) {
+    }
+
+    /**
+     * Constructor for a view of size characters starting at data.
+     *
+     * @param data Characters to refer to
+     * @param size Number of characters
+     */
+    String_view(const char* const data, const int size)
+      : myData(data),
+        mySize(size) {
+    }
+
+    /**
+     * Constructor for a view of a C-string, without its null byte.
+     *
+     * @param cstr C-string to refer to
+     */
+    String_view(const char* const cstr)  // NOLINT(runtime/explicit)
+      : myData(cstr),
+        mySize(static_cast<int>(strlen(cstr))) {
+    }
+
+    /**
+     * Constructor for a view of the contents of a String.  The view is
+     * invalidated by any change to the String.
+     *
+     * @param str String to refer to
+     */
+    String_view(const String& str)  // NOLINT(runtime/explicit)
+      : myData(str.c_str()),
+        mySize(str.size()) {
+    }
+
+    /**
+     * @return pointer to the first character, not necessarily followed by a
+     *         null byte
+     */
+    const char* data() const {
+        return myData;
+    }
+
+    /**
+     * @return number of characters
+     */
+    int size() const {
+        return mySize;
+    }
+
+    /**
+     * @return true if there are no characters
+     */
+    bool empty() const {
+        return 0 == mySize;
+    }
+
+    /**
+     * Compare the characters of two views, as strcmp does.
+     *
+     * @param other View to compare with
+     *
+     * @return negative, zero, or positive as this view orders before, the
+     *         same as, or after other
+     */
+    int compare(const String_view other) const {
+        const int common = (mySize < other.mySize) ? mySize : other.mySize;
+        const int result = (0 == common) ?
+            0 : memcmp(myData, other.myData, static_cast<size_t>(common));
+        if (0 != result) {
+            return result;
+        }
+        return (mySize < other.mySize) ? -1 : (mySize > other.mySize);
+    }
+
+    bool operator== (const String_view other) const {
+        return (mySize == other.mySize) && (0 == compare(other));
+    }
+
+    bool operator!= (const String_view other) const {
+        return !(*this == other);
+    }
+
+    bool operator< (const String_view other) const {
+        return compare(other) < 0;
+    }
+
+  private:
+    /**
+     * First character.
+     */
+    const char* myData;
+
+    /**
+     * Number of characters.
+     */
+    int mySize;
+};
+
+#endif  // MEDIAMANAGER_MANAGER_STRING_VIEW_H_
@@ -0,0 +1,608 @@
+#ifndef MEDIAMANAGER_MANAGER_TITLE_INDEX_H_
+#define MEDIAMANAGER_MANAGER_TITLE_INDEX_H_
+
+
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#include "glog/logging.h"
+#include "manager/Id_index.h"
+#include "manager/Ordered_list.h"
+#include "manager/Skip_list.h"
+#include "manager/String.h"
+#include "manager/Utility.h"
+
+
+/**
+ * @file Title_index.h
+ * @brief Declaration and definition of Title_index class template.
+ */
+
+
+/**
+ * @class Title_index Title_index.h manager/Title_index.h
+ *
+ * @brief Index of objects by title for prefix and substring searches, e.g.
+ * of the Records in the Library.
+ *
+ * @details Objects are added and removed one at a time as they enter and
+ * leave the Library; each object's title is obtained once, from its
+ * get_title() member function, when it is added.  The index holds pointers
+ * and does not own the objects.  Titles are compared case-sensitively, as
+ * everywhere else.
+ *
+ * Two structures are kept up to date:
+ * - The titles in order, in a skip list Ordered_list.  A prefix search finds
+ *   the first title not before the prefix in O(log n) and walks forward while
+ *   titles still start with it, so it takes O(log n + k) for k matches.
+ * - A posting list for every trigram (three consecutive characters) that
+ *   occurs in some title, listing the titles containing it.  A substring
+ *   search of three or more characters only checks the titles in the
+ *   shortest posting list among the trigrams of the search text, so its cost
+ *   follows the number of candidates rather than the size of the Library.
+ *   Shorter search texts have too little to go on and check every title.
+ *
+ * Every title remembers its position in each of its posting lists, so
+ * removing it takes time proportional to its length, not to the length of
+ * the posting lists.
+ *
+ * @author    Marc Schweikert
+ * @date      29-Sep-2012
+ * @version   1.0
+ * @copyright TBD
+ */
+template<typename T>
+class Title_index {
+  public:
+    /**
+     * Simple enumeration for returning error codes.
+     */
+    enum Status {OK, ERROR};
+
+    /**
+     * Number of characters in the grams used for substring searches.
+     */
+    static const int ourGramLength = 3;
+
+    /**
+     * Constructor that initializes an empty index.
+     *
+     * @pre  None.
+     * @post Index is empty.
+     */
+    Title_index();
+
+    /**
+     * Deallocates the index.  The objects are not affected.
+     *
+     * @pre  None.
+     * @post Object has been destroyed.
+     */
+    ~Title_index();
+
+    /**
+     * Add an object under its title.
+     *
+     * @pre  None.
+     * @post object is found by searches matching its title.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param object Object to add
+     *
+     * @return ERROR if object is NULL or already in the index, otherwise OK
+     */
+    Status insert(T* const object);
+
+    /**
+     * Remove an object.  Its title must not have changed since it was added.
+     *
+     * @pre  None.
+     * @post object is no longer found by any search.
+     *
+     * @param object Object to remove
+     *
+     * @return ERROR if object is not in the index, otherwise OK
+     */
+    Status erase(T* const object);
+
+    /**
+     * Remove every object.
+     *
+     * @pre  None.
+     * @post Index is empty.
+     */
+    void clear();
+
+    /**
+     * @return the number of objects in the index
+     */
+    int size() const {
+        return myEntries.size();
+    }
+
+    /**
+     * Call function with each object whose title starts with prefix, in
+     * title order.
+     *
+     * @pre  function does not change the index.
+     * @post Index remains unchanged.
+     *
+     * @param prefix   Start of the titles to find; "" finds every title
+     * @param function Function taking a T*
+     */
+    template<typename Function>
+    void apply_prefix(const char* const prefix, Function function) const;
+
+    /**
+     * Call function with each object whose title contains text, in no
+     * particular order.
+     *
+     * @pre  function does not change the index.
+     * @post Index remains unchanged.
+     *
+     * @warning If memory cannot be allocated, the program will LOG and
+     *          terminate.
+     *
+     * @param text     Text to find within the titles; "" finds every title
+     * @param function Function taking a T*
+     */
+    template<typename Function>
+    void apply_substring(const char* const text, Function function) const;
+
+  private:
+    /**
+     * One indexed object.
+     */
+    struct Entry {
+        Entry()
+          : myObject(0),
+            myGrams(0),
+            myPositions(0),
+            myGramCount(0) {
+        }
+
+        ~Entry() {
+            delete [] myGrams;
+            delete [] myPositions;
+        }
+
+        /** Title of the object when it was added. */
+        String myTitle;
+
+        /** The object. */
+        T* myObject;
+
+        /** Distinct grams of the title, in increasing order. */
+        int* myGrams;
+
+        /** Index of this entry in the posting list of each gram. */
+        int* myPositions;
+
+        /** Number of distinct grams. */
+        int myGramCount;
+    };
+
+    /**
+     * Entries whose titles contain one gram.  Kept in an Id_index keyed by
+     * the gram, hence get_ID().
+     */
+    class Posting_list {
+      public:
+        explicit Posting_list(const int gram)
+          : myGram(gram),
+            myEntries(0),
+            mySize(0),
+            myCapacity(0) {
+        }
+
+        ~Posting_list() {
+            delete [] myEntries;
+        }
+
+        int get_ID() const {
+            return myGram;
+        }
+
+        /** The gram. */
+        int myGram;
+
+        /** Entries containing the gram, in no particular order. */
+        Entry** myEntries;
+
+        /** Number of entries. */
+        int mySize;
+
+        /** Number of entries there is room for. */
+        int myCapacity;
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(Posting_list);
+    };
+
+    /**
+     * Orders entries by title.
+     */
+    struct Order_by_title {
+        bool operator() (const Entry* e1, const Entry* e2) const {
+            return strcmp(e1->myTitle.c_str(), e2->myTitle.c_str()) < 0;
+        }
+    };
+
+    typedef Ordered_list<Entry*, Skip_list_nodes, Order_by_title> Entry_list;
+
+    /**
+     * @param title Title to look for
+     * @param object Object to look for
+     *
+     * @return the entry of object under title, or end() if there is none
+     */
+    typename Entry_list::Iterator findEntry(const char* const title,
+                                            const T* const object) const;
+
+    /**
+     * Add an entry to a posting list.
+     *
+     * @warning If the list cannot grow, the program will LOG and terminate.
+     *
+     * @param list  Posting list to add to
+     * @param entry Entry to add
+     *
+     * @return position of the entry in the list
+     */
+    static int appendPosting(Posting_list* const list, Entry* const entry);
+
+    /**
+     * Collect the distinct grams of text in increasing order.
+     *
+     * @param text   C-String to split into grams
+     * @param length Length of text
+     * @param grams  Room for at least length - ourGramLength + 1 grams
+     *
+     * @return number of distinct grams
+     */
+    static int collectGrams(const char* const text,
+                            const int length,
+                            int* const grams);
+
+    /**
+     * @param length Length of a text
+     *
+     * @return a new array with room for the grams of the text
+     *
+     * @warning If the array cannot be allocated, the program will LOG and
+     *          terminate.
+     */
+    static int* newGramArray(const int length);
+
+    /**
+     * Entries in title order.
+     */
+    Entry_list myEntries;
+
+    /**
+     * Posting list of every gram that occurs in some title.
+     */
+    Id_index<Posting_list> myPostings;
+
+    /**
+     * Remove copy constructor and assignment operator.
+     */
+    DISALLOW_COPY_AND_ASSIGN(Title_index);
+};
+
+
+////////////////////////
+//  MEMBER FUNCTIONS  //
+////////////////////////
+
+
+template<typename T>
+const int Title_index<T>::ourGramLength;
+
+// constructor
+template<typename T>
+Title_index<T>::Title_index() {
+    TRACE_VLOG(1) << "Method Entry:  Title_index::Title_index";
+    TRACE_VLOG(1) << "Method Exit :  Title_index::Title_index";
+}
+
+// destructor
+template<typename T>
+Title_index<T>::~Title_index() {
+    TRACE_VLOG(1) << "Method Entry:  Title_index::~Title_index";
+
+    clear();
+
+    TRACE_VLOG(1) << "Method Exit :  Title_index::~Title_index";
+}
+
+// insert
+template<typename T>
+typename Title_index<T>::Status Title_index<T>::insert(T* const object) {
+    TRACE_VLOG(1) << "Method Entry:  Title_index::insert";
+
+    if (0 == object) {
+        LOG(ERROR) << "Title_index::insert - object is NULL!";
+
+        TRACE_VLOG(1) << "Method Exit :  Title_index::insert";
+        return ERROR;
+    }
+
+    Entry* const entry = new(std::nothrow) Entry;
+    if (0 == entry) {
+        LOG(FATAL) << "Title_index::insert - call to new failed!";
+        return ERROR;  // unreachable
+    }
+    entry->myTitle.init(object->get_title().c_str());
+    entry->myObject = object;
+
+    const char* const title = entry->myTitle.c_str();
+    TRACE_VLOG(2) << "Called with arguments\ttitle = ->" << title << "<-";
+
+    if (myEntries.end() != findEntry(title, object)) {
+        LOG(ERROR) << "Title_index::insert - object already present!";
+        delete entry;
+
+        TRACE_VLOG(1) << "Method Exit :  Title_index::insert";
+        return ERROR;
+    }
+
+    // add the entry to the posting list of each of its grams
+    const int length = entry->myTitle.size();
+    entry->myGrams = newGramArray(length);
+    entry->myPositions = newGramArray(length);
+    entry->myGramCount = collectGrams(title, length, entry->myGrams);
+
+    for (int i = 0; i < entry->myGramCount; i++) {
+        Posting_list* list = myPostings.find(entry->myGrams[i]);
+        if (0 == list) {
+            list = new(std::nothrow) Posting_list(entry->myGrams[i]);
+            if (0 == list) {
+                LOG(FATAL) << "Title_index::insert - call to new failed!";
+                return ERROR;  // unreachable
+            }
+            myPostings.insert(list);
+        }
+        entry->myPositions[i] = appendPosting(list, entry);
+    }
+
+    myEntries.insert(entry);
+
+    TRACE_VLOG(1) << "Method Exit :  Title_index::insert";
+    return OK;
+}
+
+// erase
+template<typename T>
+typename Title_index<T>::Status Title_index<T>::erase(T* const object) {
+    TRACE_VLOG(1) << "Method Entry:  Title_index::erase";
+
+    if (0 == object) {
+        TRACE_VLOG(1) << "Method Exit :  Title_index::erase";
+        return ERROR;
+    }
+
+    String title;
+    title.init(object->get_title().c_str());
+    TRACE_VLOG(2) << "Called with arguments\ttitle = ->" << title.c_str()
+                  << "<-";
+
+    const typename Entry_list::Iterator it = findEntry(title.c_str(), object);
+    if (myEntries.end() == it) {
+        TRACE_VLOG(1) << "Method Exit :  Title_index::erase";
+        return ERROR;
+    }
+
+    Entry* const entry = *it;
+    myEntries.erase(it);
+
+    // take the entry out of each posting list by moving the last entry of
+    // the list into its place
+    for (int i = 0; i < entry->myGramCount; i++) {
+        const int gram = entry->myGrams[i];
+        Posting_list* const list = myPostings.find(gram);
+        const int position = entry->myPositions[i];
+
+        list->mySize--;
+        Entry* const moved = list->myEntries[list->mySize];
+        list->myEntries[position] = moved;
+
+        // tell the moved entry where it is now
+        const int* const found = std::lower_bound(
+            moved->myGrams, moved->myGrams + moved->myGramCount, gram);
+        moved->myPositions[found - moved->myGrams] = position;
+
+        if (0 == list->mySize) {
+            myPostings.erase(gram);
+            delete list;
+        }
+    }
+
+    delete entry;
+
+    TRACE_VLOG(1) << "Method Exit :  Title_index::erase";
+    return OK;
+}
+
+// clear
+template<typename T>
+void Title_index<T>::clear() {
+    TRACE_VLOG(1) << "Method Entry:  Title_index::clear";
+
+    myPostings.apply_in_id_order([](Posting_list* list) {delete list;});
+    myPostings.clear();
+
+    for (typename Entry_list::Iterator it = myEntries.begin();
+         it != myEntries.end(); ++it) {
+        delete *it;
+    }
+    myEntries.clear();
+
+    TRACE_VLOG(1) << "Method Exit :  Title_index::clear";
+}
+
+// apply_prefix
+template<typename T>
+template<typename Function>
+void Title_index<T>::apply_prefix(const char* const prefix,
+                                  Function function) const {
+    TRACE_VLOG(1) << "Method Entry:  Title_index::apply_prefix";
+    TRACE_VLOG(2) << "Called with arguments\tprefix = ->" << prefix << "<-";
+
+    Entry probe;
+    probe.myTitle.init(prefix);
+    const size_t length = static_cast<size_t>(probe.myTitle.size());
+
+    // every title with the prefix comes at or after the prefix itself, and
+    // they are all together
+    for (typename Entry_list::Iterator it = myEntries.lower_bound(&probe);
+         (it != myEntries.end()) &&
+         (0 == strncmp((*it)->myTitle.c_str(), prefix, length));
+         ++it) {
+        function((*it)->myObject);
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Title_index::apply_prefix";
+}
+
+// apply_substring
+template<typename T>
+template<typename Function>
+void Title_index<T>::apply_substring(const char* const text,
+                                     Function function) const {
+    TRACE_VLOG(1) << "Method Entry:  Title_index::apply_substring";
+    TRACE_VLOG(2) << "Called with arguments\ttext = ->" << text << "<-";
+
+    const int length = static_cast<int>(strlen(text));
+
+    if (length < ourGramLength) {
+        // no grams to narrow the search with - check every title
+        for (typename Entry_list::Iterator it = myEntries.begin();
+             it != myEntries.end(); ++it) {
+            if (0 != strstr((*it)->myTitle.c_str(), text)) {
+                function((*it)->myObject);
+            }
+        }
+
+        TRACE_VLOG(1) << "Method Exit :  Title_index::apply_substring";
+        return;
+    }
+
+    // every match contains every gram of the text, so only the titles in the
+    // shortest of their posting lists need checking
+    int* const grams = newGramArray(length);
+    const int gramCount = collectGrams(text, length, grams);
+
+    const Posting_list* shortest = 0;
+    for (int i = 0; i < gramCount; i++) {
+        const Posting_list* const list = myPostings.find(grams[i]);
+        if (0 == list) {
+            // no title has this gram, so none can match
+            shortest = 0;
+            break;
+        }
+        if ((0 == shortest) || (list->mySize < shortest->mySize)) {
+            shortest = list;
+        }
+    }
+    delete [] grams;
+
+    if (0 != shortest) {
+        for (int i = 0; i < shortest->mySize; i++) {
+            const Entry* const entry = shortest->myEntries[i];
+            if (0 != strstr(entry->myTitle.c_str(), text)) {
+                function(entry->myObject);
+            }
+        }
+    }
+
+    TRACE_VLOG(1) << "Method Exit :  Title_index::apply_substring";
+}
+
+// findEntry
+template<typename T>
+typename Title_index<T>::Entry_list::Iterator Title_index<T>::findEntry(
+        const char* const title,
+        const T* const object) const {
+    Entry probe;
+    probe.myTitle.init(title);
+
+    // walk the entries with this title until the object turns up
+    typename Entry_list::Iterator it = myEntries.lower_bound(&probe);
+    while ((it != myEntries.end()) &&
+           (0 == strcmp((*it)->myTitle.c_str(), title)) &&
+           ((*it)->myObject != object)) {
+        ++it;
+    }
+
+    if ((it != myEntries.end()) &&
+        (0 != strcmp((*it)->myTitle.c_str(), title))) {
+        it = myEntries.end();
+    }
+
+    return it;
+}
+
+// appendPosting
+template<typename T>
+int Title_index<T>::appendPosting(Posting_list* const list,
+                                  Entry* const entry) {
+    if (list->mySize == list->myCapacity) {
+        const int capacity = std::max(4, 2 * list->myCapacity);
+        Entry** const entries =
+            new(std::nothrow) Entry*[static_cast<size_t>(capacity)];
+        if (0 == entries) {
+            LOG(FATAL) << "Title_index::appendPosting - call to new[] failed!";
+            return 0;  // unreachable
+        }
+
+        std::copy(list->myEntries, list->myEntries + list->mySize, entries);
+        delete [] list->myEntries;
+        list->myEntries = entries;
+        list->myCapacity = capacity;
+    }
+
+    list->myEntries[list->mySize] = entry;
+    return list->mySize++;
+}
+
+// collectGrams
+template<typename T>
+int Title_index<T>::collectGrams(const char* const text,
+                                 const int length,
+                                 int* const grams) {
+    int count = 0;
+    for (int i = 0; i + ourGramLength <= length; i++) {
+        int gram = 0;
+        for (int j = 0; j < ourGramLength; j++) {
+            gram = (gram << 8) | static_cast<unsigned char>(text[i + j]);
+        }
+        grams[count++] = gram;
+    }
+
+    std::sort(grams, grams + count);
+    return static_cast<int>(std::unique(grams, grams + count) - grams);
+}
+
+// newGramArray
+template<typename T>
+int* Title_index<T>::newGramArray(const int length) {
+    const int room = std::max(1, length - ourGramLength + 1);
+    int* const grams = new(std::nothrow) int[static_cast<size_t>(room)];
+    if (0 == grams) {
+        LOG(FATAL) << "Title_index::newGramArray - call to new[] failed!";
+        return 0;  // unreachable
+    }
+    return grams;
+}
+
+#endif  // MEDIAMANAGER_MANAGER_TITLE_INDEX_H_
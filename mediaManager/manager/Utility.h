@@ -7,6 +7,9 @@
  */
 
 
+#include <atomic>
+
+
 /**
  * @file Utility.h
  * @brief Utility functions, constants, and classes used by other modules
@@ -22,6 +25,52 @@
   void operator=(const TypeName&)
 
 
+/**
+ * @def TRACE_VLOG(verboselevel)
+ * VLOG used for method entry/exit and argument tracing.  It is only compiled
+ * in when MEDIAMANAGER_TRACE is defined (the TRACE=on build option); otherwise
+ * the whole statement, including the verbosity check, is discarded at compile
+ * time while the streamed arguments are still type-checked.
+ */
+#ifdef MEDIAMANAGER_TRACE
+#define TRACE_VLOG(verboselevel) VLOG(verboselevel)
+#else
+#define TRACE_VLOG(verboselevel) \
+  while (false) VLOG(verboselevel)
+#endif
+
+
+/**
+ * Raise value to candidate if candidate is larger, correctly when several
+ * threads do so at once: the largest candidate of all of them wins.
+ *
+ * @param value     Value to raise
+ * @param candidate Value it should be at least
+ */
+template<typename T>
+void atomic_max(std::atomic<T>* const value, const T candidate) {
+    T current = value->load();
+    while ((current < candidate) &&
+           !value->compare_exchange_weak(current, candidate)) {
+    }
+}
+
+
+/**
+ * Take the next number from a counter, such as the one new Records take
+ * their IDs from; each of several threads doing so at once gets a different
+ * number.
+ *
+ * @param counter Counter holding the last number taken
+ *
+ * @return the number after the last one taken
+ */
+template<typename T>
+T atomic_next(std::atomic<T>* const counter) {
+    return counter->fetch_add(1) + 1;
+}
+
+
 // define a function template named "swapem" that interchanges the values of
 // two variables use in Ordered_list and String where convenient
 
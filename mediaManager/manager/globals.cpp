@@ -1,3 +1,14 @@
 /*
  * Copyright 2012 Marc Schweikert
  */
+
+
+#include "manager/globals.h"
+
+#include "manager/Memory_stats.h"
+
+
+// number of Ordered_list objects in existence
+const Memory_count g_Ordered_list_count(Memory_stats::ORDERED_LIST);
+// number of Ordered_list::Node objects in existence
+const Memory_count g_Ordered_list_Node_count(Memory_stats::LIST_NODE);
@@ -7,15 +7,16 @@
  */
 
 
-/* *** put in p2_globals.h and p2_globals.cpp the appropriate statements to
- * setup two global int variables with the following names. Follow the course
- * guidelines for this.
- */
+#include "manager/Memory_stats.h"
+
+
+// The counts are kept by Memory_stats, which the lists report to; these read
+// them as ints.
 
 // number of Ordered_list objects in existence
-g_Ordered_list_count
+extern const Memory_count g_Ordered_list_count;
 // number of Ordered_list::Node objects in existence
-g_Ordered_list_Node_count
+extern const Memory_count g_Ordered_list_Node_count;
 
 
 #endif  // MEDIAMANAGER_MANAGER_GLOBALS_H_
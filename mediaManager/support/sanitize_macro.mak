@@ -0,0 +1,12 @@
+#### Sanitizers ####
+#
+# SANITIZE=thread builds everything with ThreadSanitizer, for running the
+# concurrency tests (e.g. Concurrent_library_UT.exe) directly; SANITIZE=address
+# does the same with AddressSanitizer.  Use one or the other, and a clean
+# build, since objects built with and without a sanitizer do not mix.  Not
+# for use under valgrind (run_all_unit_tests.pl).
+#
+ifneq ($(SANITIZE),)
+CXXFLAGS += -g -fsanitize=$(SANITIZE)
+LXXFLAGS += -fsanitize=$(SANITIZE)
+endif
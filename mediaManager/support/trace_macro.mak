@@ -0,0 +1,9 @@
+#### Method tracing ####
+#
+# The method entry/exit VLOG tracing is compiled out unless TRACE=on, so
+# release builds pay nothing for it - not even the verbosity check.
+# Diagnostic builds set TRACE=on and control the output with GLOG_v.
+#
+ifeq ($(TRACE),on)
+CXXFLAGS += -DMEDIAMANAGER_TRACE
+endif
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <sstream>
+#include <string>
+    using std::string;
+
+#include "gtest/gtest.h"
+
+#include "manager/Command_batch.h"
+#include "manager/String_view.h"
+
+
+namespace {
+
+// the characters of a view, for comparing
+string text_of(const String_view view) {
+    return string(view.data(), static_cast<size_t>(view.size()));
+}
+
+// a small command set: "pr" prints its argument, "ad" adds two integers,
+// "qq" stops the batch, and anything else is unrecognized
+class Calculator {
+  public:
+    explicit Calculator(Command_batch* const batch)
+      : myBatch(batch) {
+    }
+
+    Command_line::Status operator() (Command_line* line,
+                                     std::ostream* out) const {
+        const String_view command = line->get_command();
+        if (command == "pr") {
+            String_view text;
+            if (Command_line::OK != line->rest(&text)) {
+                return Command_line::ERROR;
+            }
+            *out << text_of(text) << "\n";
+            return Command_line::OK;
+        }
+        if (command == "ad") {
+            int i1 = 0;
+            int i2 = 0;
+            if ((Command_line::OK != line->next_int(&i1)) ||
+                (Command_line::OK != line->next_int(&i2))) {
+                return Command_line::ERROR;
+            }
+            *out << i1 + i2 << "\n";
+            return Command_line::OK;
+        }
+        if (command == "qq") {
+            myBatch->stop();
+            *out << "Done\n";
+            return Command_line::OK;
+        }
+        return line->fail("Unrecognized command!");
+    }
+
+  private:
+    Command_batch* myBatch;
+};
+
+// run a script through the Calculator, returning its output
+string run_script(const string& script, Command_batch::Status* status = 0) {
+    std::istringstream in(script);
+    std::ostringstream out;
+    {
+        Command_batch batch(&out);
+        const Command_batch::Status result = batch.run(&in,
+                                                       Calculator(&batch));
+        if (0 != status) {
+            *status = result;
+        }
+    }
+    return out.str();
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Command_line
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Command_lineUnitTest, Words) {
+    Command_line line(String_view("  fr\t12  -7 Rear  Window  "));
+    EXPECT_EQ("fr", text_of(line.get_command()));
+
+    int ID = 0;
+    EXPECT_EQ(Command_line::OK, line.next_int(&ID));
+    EXPECT_EQ(12, ID);
+    EXPECT_EQ(Command_line::OK, line.next_int(&ID));
+    EXPECT_EQ(-7, ID);
+
+    // the rest keeps inner spaces, but not those around it
+    String_view title;
+    EXPECT_EQ(Command_line::OK, line.rest(&title));
+    EXPECT_EQ("Rear  Window", text_of(title));
+    EXPECT_STREQ(0, line.get_error());
+
+    String_view word;
+    EXPECT_EQ(Command_line::ERROR, line.next_word(&word));
+    EXPECT_STREQ("Missing argument!", line.get_error());
+
+    Command_line blank(String_view(" \t "));
+    EXPECT_TRUE(blank.get_command().empty());
+}
+
+TEST(Command_lineUnitTest, Integers) {
+    const char* const bad[] = {"12x", "x", "-", "+", "2147483648",
+                               "-2147483649", "99999999999999999999"};
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        const string text = string("fr ") + bad[i];
+        Command_line word(String_view(text.c_str()));
+        int value = 5;
+        EXPECT_EQ(Command_line::ERROR, word.next_int(&value)) << bad[i];
+        EXPECT_STREQ("Could not read an integer value!", word.get_error());
+        EXPECT_EQ(5, value);
+    }
+
+    Command_line line(String_view("fr 2147483647 -2147483648 +3"));
+    int value = 0;
+    EXPECT_EQ(Command_line::OK, line.next_int(&value));
+    EXPECT_EQ(2147483647, value);
+    EXPECT_EQ(Command_line::OK, line.next_int(&value));
+    EXPECT_EQ(-2147483647 - 1, value);
+    EXPECT_EQ(Command_line::OK, line.next_int(&value));
+    EXPECT_EQ(3, value);
+    EXPECT_EQ(Command_line::ERROR, line.next_int(&value));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Command_batch
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Command_batchUnitTest, Run) {
+    // blank lines and comments are skipped but counted; \r\n line endings
+    // and a last line without a newline are accepted
+    Command_batch::Status status = Command_batch::ERROR;
+    EXPECT_EQ("Casablanca\n"
+              "5\n"
+              "Vertigo\n"
+              "-1\n",
+              run_script("pr   Casablanca \n"
+                         "\n"
+                         "# a comment\n"
+                         "ad 2 3\r\n"
+                         "pr Vertigo\n"
+                         "ad -3 2",
+                         &status));
+    EXPECT_EQ(Command_batch::OK, status);
+
+    std::istringstream in("pr a\n\npr b\n");
+    std::ostringstream out;
+    Command_batch batch(&out);
+    EXPECT_EQ(Command_batch::OK, batch.run(&in, Calculator(&batch)));
+    EXPECT_EQ(3, batch.get_line_number());
+    EXPECT_EQ(2, batch.get_command_count());
+    EXPECT_EQ(0, batch.get_error_count());
+    EXPECT_EQ("a\nb\n", out.str());
+}
+
+TEST(Command_batchUnitTest, Errors) {
+    // errors are reported in order with the output, and the batch goes on
+    std::istringstream in("pr a\n"
+                          "xx\n"
+                          "ad 1\n"
+                          "ad 1 two\n"
+                          "pr\n"
+                          "pr b\n");
+    std::ostringstream out;
+    Command_batch batch(&out);
+    EXPECT_EQ(Command_batch::OK, batch.run(&in, Calculator(&batch)));
+    EXPECT_EQ("a\n"
+              "Line 2: Unrecognized command!\n"
+              "Line 3: Could not read an integer value!\n"
+              "Line 4: Could not read an integer value!\n"
+              "Line 5: Missing argument!\n"
+              "b\n",
+              out.str());
+    EXPECT_EQ(6, batch.get_command_count());
+    EXPECT_EQ(4, batch.get_error_count());
+
+    // a command that gives no reason
+    std::istringstream in2("zz\n");
+    std::ostringstream out2;
+    Command_batch batch2(&out2);
+    batch2.run(&in2, [](Command_line*, std::ostream*) {
+        return Command_line::ERROR;
+    });
+    EXPECT_EQ("Line 1: Command failed!\n", out2.str());
+}
+
+TEST(Command_batchUnitTest, Stop) {
+    EXPECT_EQ("a\nDone\n", run_script("pr a\nqq\npr b\n"));
+}
+
+TEST(Command_batchUnitTest, OutputBuffered) {
+    // nothing reaches the stream while the commands run
+    std::istringstream in("pr a\npr b\npr c\n");
+    std::ostringstream out;
+    Command_batch batch(&out);
+    bool written = false;
+    Calculator calculator(&batch);
+    batch.run(&in, [&out, &written, &calculator](Command_line* line,
+                                                 std::ostream* output) {
+        written = written || !out.str().empty();
+        return calculator(line, output);
+    });
+    EXPECT_FALSE(written);
+    EXPECT_EQ("a\nb\nc\n", out.str());
+
+    // more than a buffer full is written out as it fills, and all of it
+    // arrives in order
+    std::ostringstream script;
+    std::ostringstream expected;
+    for (int i = 0; i < 20000; i++) {
+        script << "ad " << i << " 1\n";
+        expected << i + 1 << "\n";
+    }
+    EXPECT_EQ(expected.str(), run_script(script.str()));
+}
+
+TEST(Command_batchUnitTest, Chunks) {
+    // lines that straddle the chunks read, and one longer than a chunk
+    const string longTitle(3 * Command_batch::ourChunkSize + 17, 'x');
+    std::ostringstream script;
+    std::ostringstream expected;
+    for (int i = 0; i < 50000; i++) {
+        if (25000 == i) {
+            script << "pr " << longTitle << "\n";
+            expected << longTitle << "\n";
+        }
+        script << "pr title " << i << "\n";
+        expected << "title " << i << "\n";
+    }
+    script << "bad\n";
+    expected << "Line 50002: Unrecognized command!\n";
+    EXPECT_EQ(expected.str(), run_script(script.str()));
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <atomic>  // NOLINT(build/include_order)
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+    using std::vector;
+
+#include "gtest/gtest.h"
+
+#include "manager/Concurrent_library.h"
+#include "manager/globals.h"
+#include "manager/Ordered_list.h"
+#include "manager/Sorted_array.h"
+#include "manager/Utility.h"
+
+
+// To use a test fixture, derive a class from testing::Test.
+class Concurrent_libraryUnitTest : public testing::Test {
+  protected:
+    // every test starts and must finish with no lists or nodes alive
+    virtual void SetUp() {
+        ASSERT_EQ(0, g_Ordered_list_count);
+        ASSERT_EQ(0, g_Ordered_list_Node_count);
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(0, g_Ordered_list_count);
+        EXPECT_EQ(0, g_Ordered_list_Node_count);
+    }
+};
+
+
+namespace {
+
+typedef Ordered_list<int, Sorted_array_storage> List;
+
+// stands in for Record: the Library holds pointers to them
+struct Item {
+    explicit Item(const int in_ID)
+      : ID(in_ID) {
+    }
+
+    int ID;
+};
+
+typedef Item * Item_ptr_t;
+bool item_less(const Item_ptr_t& item1, const Item_ptr_t& item2) {
+    return item1->ID < item2->ID;
+}
+
+typedef Ordered_list<Item*, Sorted_array_storage> Item_list;
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Versions
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Concurrent_libraryUnitTest, Update) {
+    Concurrent_library<List> library;
+    Concurrent_library<List>::Reader reader(&library);
+    EXPECT_TRUE(reader.lock().empty());
+    reader.unlock();
+
+    library.update([](List* list) {
+        list->insert(2);
+        list->insert(1);
+    });
+    EXPECT_EQ(1, library.get_version());
+    const List& list = reader.lock();
+    ASSERT_EQ(2, list.size());
+    EXPECT_EQ(1, *list.begin());
+    reader.unlock();
+}
+
+TEST_F(Concurrent_libraryUnitTest, LockedVersionKept) {
+    Concurrent_library<List> library;
+    library.update([](List* list) {
+        list->insert(1);
+    });
+
+    // the update waits for the reader to let go of the version it holds
+    Concurrent_library<List>::Reader reader(&library);
+    const List& old = reader.lock();
+    std::atomic<bool> done(false);
+    std::thread writer([&library, &done]() {
+        library.update([](List* list) {
+            list->insert(2);
+        });
+        done = true;
+    });
+    while (2 != library.get_version()) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done);
+    EXPECT_EQ(1, old.size());
+
+    // a second lock gets the new version and lets go of the old
+    EXPECT_EQ(2, reader.lock().size());
+    writer.join();
+    EXPECT_TRUE(done);
+}
+
+TEST_F(Concurrent_libraryUnitTest, Readers) {
+    Concurrent_library<List> library;
+    vector<Concurrent_library<List>::Reader*> readers;
+    for (int i = 0; i < Concurrent_library<List>::ourMaxReaders; i++) {
+        readers.push_back(new Concurrent_library<List>::Reader(&library));
+        readers.back()->lock();
+    }
+
+    // slots are reused
+    delete readers[7];
+    readers[7] = new Concurrent_library<List>::Reader(&library);
+    for (size_t i = 0; i < readers.size(); i++) {
+        delete readers[i];
+    }
+    library.update([](List* list) {
+        list->insert(1);
+    });
+    EXPECT_EQ(1, library.get_version());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Threads
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Concurrent_libraryUnitTest, AtomicNext) {
+    std::atomic<int> counter(0);
+    vector<vector<int> > IDs(4);
+    vector<std::thread> threads;
+    for (size_t t = 0; t < IDs.size(); t++) {
+        vector<int>* const taken = &IDs[t];
+        threads.push_back(std::thread([&counter, taken]() {
+            for (int i = 0; i < 10000; i++) {
+                taken->push_back(atomic_next(&counter));
+            }
+        }));
+    }
+    vector<int> all;
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+        all.insert(all.end(), IDs[t].begin(), IDs[t].end());
+    }
+
+    // every number from 1 on, each taken once
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(40000U, all.size());
+    for (size_t i = 0; i < all.size(); i++) {
+        ASSERT_EQ(static_cast<int>(i + 1), all[i]);
+    }
+    EXPECT_EQ(40000, counter.load());
+}
+
+TEST_F(Concurrent_libraryUnitTest, Stress) {
+    // the writer keeps the newest 100 Items, deleting each older one as soon
+    // as the update that removes it returns; the readers look at every Item
+    // they see, so reading a deleted one would show under a sanitizer
+    static const int numReaders = 4;
+    static const int numUpdates = 2000;
+    static const int numKept = 100;
+    Concurrent_library<Item_list> library((Item_list(item_less)));
+    std::atomic<bool> stop(false);
+    std::atomic<int> failures(0);
+    std::atomic<int> reads(0);
+
+    vector<std::thread> readers;
+    for (int r = 0; r < numReaders; r++) {
+        readers.push_back(std::thread([&library, &stop, &failures, &reads]() {
+            Concurrent_library<Item_list>::Reader reader(&library);
+            int newest = 0;
+            while (!stop) {
+                const Item_list& items = reader.lock();
+                int previous = 0;
+                int count = 0;
+                for (Item_list::Iterator it = items.begin();
+                     items.end() != it; ++it) {
+                    // let the writer run while the version is held
+                    if (numKept / 2 == ++count) {
+                        std::this_thread::yield();
+                    }
+                    if ((*it)->ID <= previous) {
+                        failures++;
+                    }
+                    previous = (*it)->ID;
+                }
+                // versions are seen in the order they were made
+                if ((items.size() > numKept) || (previous < newest)) {
+                    failures++;
+                }
+                newest = previous;
+                reader.unlock();
+                reads++;
+                std::this_thread::yield();
+            }
+        }));
+    }
+
+    for (int ID = 1; ID <= numUpdates; ID++) {
+        Item* const item = new Item(ID);
+        Item* removed = 0;
+        library.update([item, &removed](Item_list* items) {
+            items->insert(item);
+            if (items->size() > numKept) {
+                removed = *items->begin();
+                items->erase(items->begin());
+            }
+        });
+        delete removed;
+        std::this_thread::yield();
+    }
+    stop = true;
+    for (size_t r = 0; r < readers.size(); r++) {
+        readers[r].join();
+    }
+
+    EXPECT_EQ(0, failures.load());
+    EXPECT_LT(numUpdates, reads.load());
+    EXPECT_EQ(numUpdates, library.get_version());
+    library.update([](Item_list* items) {
+        for (Item_list::Iterator it = items->begin(); items->end() != it;
+             ++it) {
+            delete *it;
+        }
+        items->clear();
+    });
+}
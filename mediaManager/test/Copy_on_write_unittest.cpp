@@ -0,0 +1,230 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <string>
+    using std::string;
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+
+#include "manager/Copy_on_write.h"
+#include "manager/globals.h"
+#include "manager/Ordered_list.h"
+
+
+// To use a test fixture, derive a class from testing::Test.
+class Copy_on_writeUnitTest : public testing::Test {
+  protected:
+    // every test starts and must finish with no lists or nodes alive
+    virtual void SetUp() {
+        ASSERT_EQ(0, g_Ordered_list_count);
+        ASSERT_EQ(0, g_Ordered_list_Node_count);
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(0, g_Ordered_list_count);
+        EXPECT_EQ(0, g_Ordered_list_Node_count);
+    }
+};
+
+
+namespace {
+
+// not the < operator, so a list that lost its ordering function would show
+bool greater(const int& i1, const int& i2) {
+    return i1 > i2;
+}
+
+typedef Ordered_list<int> List;
+typedef Copy_on_write<List> Shared_list;
+
+// the items of a list, e.g. "3 2 1"
+string items_of(const List& list) {
+    string text;
+    for (List::Iterator it = list.begin(); list.end() != it; ++it) {
+        if (!text.empty()) {
+            text += " ";
+        }
+        text += std::to_string(*it);
+    }
+    return text;
+}
+
+// stands in for Record: the containers hold pointers to them
+struct Item {
+    explicit Item(const int in_ID)
+      : ID(in_ID) {
+        ourCount++;
+    }
+
+    ~Item() {
+        ourCount--;
+    }
+
+    int ID;
+
+    static int ourCount;
+};
+
+int Item::ourCount = 0;
+
+typedef Item * Item_ptr_t;
+bool item_less(const Item_ptr_t& item1, const Item_ptr_t& item2) {
+    return item1->ID < item2->ID;
+}
+
+typedef Ordered_list<Item*> Item_list;
+
+// delete the Items in a list
+void delete_items(const Item_list& list) {
+    for (Item_list::Iterator it = list.begin(); list.end() != it; ++it) {
+        delete *it;
+    }
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Sharing
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Copy_on_writeUnitTest, CopyIsShared) {
+    Shared_list library((List(greater)));
+    EXPECT_TRUE(library.get().empty());
+    for (int i = 1; i <= 5; i++) {
+        library.get_writable()->insert(i);
+    }
+    EXPECT_FALSE(library.is_shared());
+    EXPECT_EQ("5 4 3 2 1", items_of(library.get()));
+
+    // no nodes are copied until one of them changes
+    const int nodes = g_Ordered_list_Node_count;
+    Shared_list backup(library);
+    EXPECT_EQ(nodes, g_Ordered_list_Node_count);
+    EXPECT_TRUE(library.is_shared());
+    EXPECT_EQ(&library.get(), &backup.get());
+
+    library.get_writable()->insert(6);
+    EXPECT_EQ(2 * nodes + 1, g_Ordered_list_Node_count);
+    EXPECT_FALSE(library.is_shared());
+    EXPECT_FALSE(backup.is_shared());
+    EXPECT_EQ("6 5 4 3 2 1", items_of(library.get()));
+    EXPECT_EQ("5 4 3 2 1", items_of(backup.get()));
+
+    // assignment shares too
+    library = backup;
+    EXPECT_EQ(nodes, g_Ordered_list_Node_count);
+    EXPECT_EQ("5 4 3 2 1", items_of(library.get()));
+}
+
+TEST_F(Copy_on_writeUnitTest, Clear) {
+    Shared_list library((List(greater)));
+    library.get_writable()->insert(1);
+    library.get_writable()->insert(2);
+
+    // not shared: emptied in place
+    const List* const list = &library.get();
+    library.clear();
+    EXPECT_EQ(list, &library.get());
+    EXPECT_TRUE(library.get().empty());
+
+    // shared: the copy keeps its items, which are not copied
+    library.get_writable()->insert(7);
+    const Shared_list backup(library);
+    library.clear();
+    EXPECT_TRUE(library.get().empty());
+    EXPECT_EQ(1, g_Ordered_list_Node_count);
+    EXPECT_EQ("7", items_of(backup.get()));
+
+    // the new container keeps the ordering
+    library.get_writable()->insert(3);
+    library.get_writable()->insert(1);
+    library.get_writable()->insert(2);
+    EXPECT_EQ("3 2 1", items_of(library.get()));
+    EXPECT_EQ("7", items_of(backup.get()));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Rolling back a restore
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Copy_on_writeUnitTest, Rollback) {
+    {
+        Copy_on_write<Item_list> library((Item_list(item_less)));
+        for (int ID = 1; ID <= 3; ID++) {
+            library.get_writable()->insert(new Item(ID));
+        }
+
+        // a restore that fails part way through
+        Copy_on_write<Item_list> backup(library);
+        library.clear();
+        library.get_writable()->insert(new Item(10));
+        library.get_writable()->insert(new Item(11));
+        EXPECT_EQ(5, Item::ourCount);
+        EXPECT_EQ(3, backup.get().size());
+
+        delete_items(library.get());
+        library.swap(backup);
+        backup.clear();
+        EXPECT_EQ(3, Item::ourCount);
+        ASSERT_EQ(3, library.get().size());
+        EXPECT_EQ(1, (*library.get().begin())->ID);
+
+        // one that succeeds
+        backup = library;
+        library.clear();
+        library.get_writable()->insert(new Item(20));
+        delete_items(backup.get());
+        backup.clear();
+        EXPECT_EQ(1, Item::ourCount);
+        ASSERT_EQ(1, library.get().size());
+        EXPECT_EQ(20, (*library.get().begin())->ID);
+
+        delete_items(library.get());
+    }
+    EXPECT_EQ(0, Item::ourCount);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Reading on another thread
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Copy_on_writeUnitTest, ConcurrentReads) {
+    Shared_list library;
+    int expected = 0;
+    for (int i = 0; i < 1000; i++) {
+        library.get_writable()->insert(i);
+        expected += i;
+    }
+
+    // the reader's copy does not change while the library does
+    const Shared_list snapshot(library);
+    bool consistent = true;
+    std::thread reader([&snapshot, expected, &consistent]() {
+        for (int pass = 0; pass < 200; pass++) {
+            int total = 0;
+            snapshot.get().apply([&total](const int i) {
+                total += i;
+            });
+            consistent = consistent && (expected == total);
+        }
+    });
+    for (int i = 0; i < 1000; i++) {
+        List* const list = library.get_writable();
+        list->erase(list->begin());
+        list->insert(1000 + i);
+    }
+    reader.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(1000, snapshot.get().size());
+    EXPECT_EQ(1000, *library.get().begin());
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdlib>
+#include <vector>
+    using std::vector;
+
+#include "gtest/gtest.h"
+
+#include "manager/Id_index.h"
+
+
+namespace {
+
+// stands in for Record: anything with a get_ID() member
+class Item {
+  public:
+    explicit Item(const int in_id)
+      : id(in_id) {
+    }
+
+    int get_ID() const {
+        return id;
+    }
+
+  private:
+    int id;
+};
+
+// collects the IDs visited by apply_in_id_order
+class Collect_ids {
+  public:
+    explicit Collect_ids(vector<int>* in_ids)
+      : ids(in_ids) {
+    }
+
+    void operator() (const Item* item) const {
+        ids->push_back(item->get_ID());
+    }
+
+  private:
+    vector<int>* ids;
+};
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Insert / Find
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Id_indexUnitTest, InsertFind) {
+    Id_index<Item> index;
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(0, index.size());
+    EXPECT_EQ(0, index.find(1));
+
+    Item one(1);
+    Item two(2);
+    Item big(123456789);
+    EXPECT_EQ(Id_index<Item>::OK, index.insert(&one));
+    EXPECT_EQ(Id_index<Item>::OK, index.insert(&two));
+    EXPECT_EQ(Id_index<Item>::OK, index.insert(&big));
+
+    EXPECT_EQ(3, index.size());
+    EXPECT_EQ(&one, index.find(1));
+    EXPECT_EQ(&two, index.find(2));
+    EXPECT_EQ(&big, index.find(123456789));
+    EXPECT_EQ(0, index.find(3));
+    EXPECT_EQ(0, index.find(0));
+    EXPECT_EQ(0, index.find(-1));
+}
+
+TEST(Id_indexUnitTest, InsertErrors) {
+    Id_index<Item> index;
+    Item one(1);
+    Item other_one(1);
+
+    EXPECT_EQ(Id_index<Item>::ERROR, index.insert(0));
+    EXPECT_EQ(Id_index<Item>::OK, index.insert(&one));
+    EXPECT_EQ(Id_index<Item>::ERROR, index.insert(&other_one));
+    EXPECT_EQ(1, index.size());
+    EXPECT_EQ(&one, index.find(1));
+}
+
+TEST(Id_indexUnitTest, Grow) {
+    Id_index<Item> index;
+    vector<Item> items;
+    for (int id = 1; id <= 10000; id++) {
+        items.push_back(Item(id));
+    }
+    for (size_t i = 0; i < items.size(); i++) {
+        ASSERT_EQ(Id_index<Item>::OK, index.insert(&items[i]));
+    }
+
+    EXPECT_EQ(10000, index.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        ASSERT_EQ(&items[i], index.find(items[i].get_ID()));
+    }
+    EXPECT_EQ(0, index.find(10001));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Erase
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Id_indexUnitTest, Erase) {
+    Id_index<Item> index;
+    EXPECT_EQ(Id_index<Item>::ERROR, index.erase(1));
+
+    Item one(1);
+    Item two(2);
+    index.insert(&one);
+    index.insert(&two);
+
+    EXPECT_EQ(Id_index<Item>::OK, index.erase(1));
+    EXPECT_EQ(Id_index<Item>::ERROR, index.erase(1));
+    EXPECT_EQ(1, index.size());
+    EXPECT_EQ(0, index.find(1));
+    EXPECT_EQ(&two, index.find(2));
+
+    // the ID can be used again
+    EXPECT_EQ(Id_index<Item>::OK, index.insert(&one));
+    EXPECT_EQ(&one, index.find(1));
+}
+
+// erase in random order while checking every remaining ID is still found,
+// which exercises moving entries back along their probe runs
+TEST(Id_indexUnitTest, EraseKeepsProbeRuns) {
+    Id_index<Item> index;
+    vector<Item> items;
+    for (int id = 1; id <= 2000; id++) {
+        // IDs that are multiples of a power of two collide more
+        items.push_back(Item(id * 1024));
+    }
+    for (size_t i = 0; i < items.size(); i++) {
+        index.insert(&items[i]);
+    }
+
+    vector<bool> present(items.size(), true);
+    unsigned int seed = 381;
+    for (int round = 0; round < 1500; round++) {
+        const size_t victim = static_cast<size_t>(rand_r(&seed)) % items.size();
+        const Id_index<Item>::Status expected =
+            present[victim] ? Id_index<Item>::OK : Id_index<Item>::ERROR;
+        ASSERT_EQ(expected, index.erase(items[victim].get_ID()));
+        present[victim] = false;
+
+        if (0 == round % 100) {
+            for (size_t i = 0; i < items.size(); i++) {
+                ASSERT_EQ(present[i] ? &items[i] : 0,
+                          index.find(items[i].get_ID()));
+            }
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Clear / Swap / ApplyInIdOrder
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Id_indexUnitTest, ClearAndSwap) {
+    Id_index<Item> a;
+    Id_index<Item> b;
+    Item one(1);
+    Item two(2);
+    a.insert(&one);
+    b.insert(&two);
+
+    a.swap(b);
+    EXPECT_EQ(&two, a.find(2));
+    EXPECT_EQ(0, a.find(1));
+    EXPECT_EQ(&one, b.find(1));
+
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(0, a.find(2));
+    EXPECT_EQ(Id_index<Item>::OK, a.insert(&two));
+}
+
+TEST(Id_indexUnitTest, ApplyInIdOrder) {
+    Id_index<Item> index;
+    vector<int> ids;
+    index.apply_in_id_order(Collect_ids(&ids));
+    EXPECT_TRUE(ids.empty());
+
+    Item items[] = {Item(42), Item(7), Item(1000), Item(1), Item(99)};
+    for (int i = 0; i < 5; i++) {
+        index.insert(&items[i]);
+    }
+    index.erase(1000);
+
+    index.apply_in_id_order(Collect_ids(&ids));
+    ASSERT_EQ(4U, ids.size());
+    EXPECT_EQ(1, ids[0]);
+    EXPECT_EQ(7, ids[1]);
+    EXPECT_EQ(42, ids[2]);
+    EXPECT_EQ(99, ids[3]);
+}
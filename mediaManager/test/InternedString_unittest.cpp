@@ -0,0 +1,161 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <string>
+    using std::string;
+
+#include "gtest/gtest.h"
+
+#include "manager/InternedString.h"
+#include "manager/String.h"
+
+
+// To use a test fixture, derive a class from testing::Test.
+class InternedStringUnitTest : public testing::Test {
+  protected:
+    // every test starts and must finish with an empty pool
+    virtual void SetUp() {
+        ASSERT_EQ(0, InternedString::get_pool_size());
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(0, InternedString::get_pool_size());
+    }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Init
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(InternedStringUnitTest, Init) {
+    InternedString a;
+    EXPECT_STREQ("", a.c_str());
+    EXPECT_EQ(0, a.size());
+
+    ASSERT_EQ(String::OK, a.init("DVD"));
+    EXPECT_STREQ("DVD", a.c_str());
+    EXPECT_EQ(3, a.size());
+    EXPECT_EQ(1, InternedString::get_pool_size());
+
+    // re-init releases the old entry
+    ASSERT_EQ(String::OK, a.init("VHS"));
+    EXPECT_STREQ("VHS", a.c_str());
+    EXPECT_EQ(1, InternedString::get_pool_size());
+
+    // the empty string is not pooled
+    ASSERT_EQ(String::OK, a.init(""));
+    EXPECT_EQ(InternedString(), a);
+    EXPECT_EQ(0, InternedString::get_pool_size());
+
+    // invalid
+    EXPECT_EQ(String::ERROR, a.init(0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// sharing and equality
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(InternedStringUnitTest, Sharing) {
+    const int hits = InternedString::get_hit_count();
+    const int misses = InternedString::get_miss_count();
+
+    InternedString a;
+    InternedString b;
+    InternedString c;
+    ASSERT_EQ(String::OK, a.init("DVD"));
+    ASSERT_EQ(String::OK, b.init("DVD"));
+    ASSERT_EQ(String::OK, c.init("LP"));
+
+    // same characters, same buffer
+    EXPECT_EQ(a.c_str(), b.c_str());
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a != b);
+    EXPECT_TRUE(a != c);
+
+    EXPECT_EQ(2, InternedString::get_pool_size());
+    EXPECT_EQ(hits + 1, InternedString::get_hit_count());
+    EXPECT_EQ(misses + 2, InternedString::get_miss_count());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// copy and assignment
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(InternedStringUnitTest, CopyAndAssign) {
+    InternedString a;
+    ASSERT_EQ(String::OK, a.init("CD"));
+
+    {
+        InternedString b(a);
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a.c_str(), b.c_str());
+    }  // b goes out of scope - the entry stays for a
+
+    EXPECT_STREQ("CD", a.c_str());
+    EXPECT_EQ(1, InternedString::get_pool_size());
+
+    InternedString c;
+    ASSERT_EQ(String::OK, c.init("LP"));
+    c = a;
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(1, InternedString::get_pool_size());
+
+    // self-assignment keeps the entry alive
+    c = c;
+    EXPECT_STREQ("CD", c.c_str());
+    EXPECT_EQ(1, InternedString::get_pool_size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// pool growth and memory
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(InternedStringUnitTest, ManyValues) {
+    const int numValues = 1000;
+    InternedString* const values = new InternedString[numValues];
+
+    for (int i = 0; i < numValues; i++) {
+        const string value = "medium " + std::to_string(i);
+        ASSERT_EQ(String::OK, values[i].init(value.c_str()));
+    }
+    EXPECT_EQ(numValues, InternedString::get_pool_size());
+
+    // every value is still found after the table has grown
+    for (int i = 0; i < numValues; i++) {
+        const string value = "medium " + std::to_string(i);
+        InternedString probe;
+        ASSERT_EQ(String::OK, probe.init(value.c_str()));
+        EXPECT_EQ(values[i], probe);
+    }
+    EXPECT_EQ(numValues, InternedString::get_pool_size());
+
+    delete [] values;
+}
+
+TEST_F(InternedStringUnitTest, SharedAllocation) {
+    const int numStrings = String::get_number();
+    const int totalAllocation = String::get_total_allocation();
+    const int numRecords = 100;
+    static const char* const media[] = {"DVD", "VHS", "CD", "LP"};
+
+    InternedString* const medium = new InternedString[numRecords];
+    for (int i = 0; i < numRecords; i++) {
+        ASSERT_EQ(String::OK, medium[i].init(media[i % 4]));
+    }
+
+    // only one String per distinct medium, not one per Record
+    EXPECT_EQ(numStrings + 4, String::get_number());
+    EXPECT_EQ(totalAllocation + 4 + 4 + 3 + 3,
+              String::get_total_allocation());
+
+    delete [] medium;
+    EXPECT_EQ(numStrings, String::get_number());
+    EXPECT_EQ(totalAllocation, String::get_total_allocation());
+}
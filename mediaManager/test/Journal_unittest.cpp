@@ -0,0 +1,424 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <map>
+#include <sstream>
+    using std::stringstream;
+#include <string>
+    using std::string;
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "manager/Journal.h"
+#include "manager/Snapshot.h"
+
+
+namespace {
+
+// stands in for the Library and Catalog, changed as the commands will change
+// them
+class Library {
+  public:
+    struct Item {
+        int rating;
+        string medium;
+        string title;
+    };
+
+    static Item item(const int rating,
+                     const string& medium,
+                     const string& title) {
+        Item result;
+        result.rating = rating;
+        result.medium = medium;
+        result.title = title;
+        return result;
+    }
+
+    // make the change of an entry, or return false if it does not apply
+    bool apply(const Journal::Entry& entry) {
+        switch (entry.operation) {
+          case Journal::ADD_RECORD:
+            if (0 != records.count(entry.ID)) {
+                return false;
+            }
+            records[entry.ID] = item(entry.rating, entry.medium, entry.name);
+            return true;
+          case Journal::DELETE_RECORD:
+            return 1 == records.erase(entry.ID);
+          case Journal::MODIFY_RATING:
+            if (0 == records.count(entry.ID)) {
+                return false;
+            }
+            records[entry.ID].rating = entry.rating;
+            return true;
+          case Journal::ADD_COLLECTION:
+            if (0 != collections.count(entry.name)) {
+                return false;
+            }
+            collections[entry.name];
+            return true;
+          case Journal::DELETE_COLLECTION:
+            return 1 == collections.erase(entry.name);
+          case Journal::ADD_MEMBER:
+            if ((0 == collections.count(entry.name)) ||
+                (0 == records.count(entry.ID))) {
+                return false;
+            }
+            collections[entry.name].push_back(entry.ID);
+            return true;
+          case Journal::DELETE_MEMBER:
+            if (0 == collections.count(entry.name)) {
+                return false;
+            }
+            std::vector<int>& members = collections[entry.name];
+            for (size_t i = 0; i < members.size(); i++) {
+                if (entry.ID == members[i]) {
+                    members.erase(members.begin() +
+                                  static_cast<std::ptrdiff_t>(i));
+                    return true;
+                }
+            }
+            return false;
+        }
+        return false;
+    }
+
+    // replay a journal into this Library
+    Journal::Status replay(Journal* journal) {
+        return journal->replay(
+            [this](const Journal::Entry& entry) { return apply(entry); });
+    }
+
+    void from_snapshot(const Snapshot& snapshot) {
+        records.clear();
+        collections.clear();
+        for (int i = 0; i < snapshot.get_record_count(); i++) {
+            const Snapshot::Record_data& record = snapshot.get_record(i);
+            records[record.ID] = item(record.rating, record.medium.c_str(),
+                                      record.title.c_str());
+        }
+        for (int i = 0; i < snapshot.get_collection_count(); i++) {
+            const Snapshot::Collection_data& collection =
+                snapshot.get_collection(i);
+            std::vector<int>& members = collections[collection.name.c_str()];
+            members.assign(snapshot.get_members(collection),
+                           snapshot.get_members(collection) +
+                               collection.member_count);
+        }
+    }
+
+    void to_snapshot(Snapshot* snapshot) const {
+        snapshot->clear();
+        for (const auto& record : records) {
+            snapshot->add_record(record.first, record.second.rating,
+                                 record.second.medium.c_str(),
+                                 record.second.title.c_str());
+        }
+        for (const auto& collection : collections) {
+            snapshot->add_collection(collection.first.c_str());
+            for (const int ID : collection.second) {
+                snapshot->add_member(ID);
+            }
+        }
+    }
+
+    // the contents, as a text save file
+    string to_string() const {
+        Snapshot snapshot;
+        to_snapshot(&snapshot);
+        stringstream out;
+        snapshot.save(&out, Snapshot::TEXT);
+        return out.str();
+    }
+
+    std::map<int, Item> records;
+    std::map<string, std::vector<int> > collections;
+};
+
+// a directory for the files of one test, removed when done
+class Temporary_directory {
+  public:
+    Temporary_directory() {
+        char name[] = "/tmp/Journal_unittest.XXXXXX";
+        EXPECT_NE(static_cast<char*>(0), mkdtemp(name));
+        path = name;
+        snapshot = path + "/library.mms";
+        journal = path + "/library.mmj";
+    }
+
+    ~Temporary_directory() {
+        remove(snapshot.c_str());
+        remove(journal.c_str());
+        rmdir(path.c_str());
+    }
+
+    void append(const string& file, const string& contents) const {
+        FILE* const out = fopen(file.c_str(), "ab");
+        ASSERT_NE(static_cast<FILE*>(0), out);
+        fwrite(contents.data(), 1, contents.size(), out);
+        fclose(out);
+    }
+
+    string path;
+    string snapshot;
+    string journal;
+};
+
+// open and replay journal into library
+Journal::Status restore(Journal* journal, Library* library) {
+    Snapshot snapshot;
+    if (Journal::OK != journal->open(&snapshot)) {
+        return Journal::ERROR;
+    }
+    library->from_snapshot(snapshot);
+    return library->replay(journal);
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Appending and replaying
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(JournalUnitTest, Replay) {
+    const Temporary_directory directory;
+    Library expected;
+    {
+        // the first run has neither file
+        Journal journal(directory.snapshot.c_str(), directory.journal.c_str());
+        EXPECT_FALSE(journal.is_open());
+        ASSERT_EQ(Journal::OK, restore(&journal, &expected));
+        ASSERT_TRUE(journal.is_open());
+        EXPECT_EQ(0, journal.get_entry_count());
+        EXPECT_TRUE(expected.records.empty());
+
+        EXPECT_EQ(Journal::OK, journal.add_collection("favorites"));
+        EXPECT_EQ(Journal::OK, journal.add_record(1, 5, "DVD", "Alien"));
+        EXPECT_EQ(Journal::OK, journal.add_record(2, 0, "VHS", "The Thing"));
+        EXPECT_EQ(Journal::OK, journal.add_member("favorites", 1));
+        EXPECT_EQ(Journal::OK, journal.modify_rating(2, 3));
+        EXPECT_EQ(Journal::OK,
+                  journal.add_record(7, 4, "DVD", " Tora!  Tora! Tora! "));
+        EXPECT_EQ(Journal::OK, journal.add_record(8, 1, "LP", "Gone"));
+        EXPECT_EQ(Journal::OK, journal.delete_record(8));
+        EXPECT_EQ(Journal::OK, journal.add_member("favorites", 7));
+        EXPECT_EQ(Journal::OK, journal.delete_member("favorites", 1));
+        EXPECT_EQ(Journal::OK, journal.add_collection("empty"));
+        EXPECT_EQ(Journal::OK, journal.add_collection("gone"));
+        EXPECT_EQ(Journal::OK, journal.delete_collection("gone"));
+        EXPECT_EQ(13, journal.get_entry_count());
+        EXPECT_FALSE(journal.needs_compaction());
+    }
+
+    expected.records[1] = Library::item(5, "DVD", "Alien");
+    expected.records[2] = Library::item(3, "VHS", "The Thing");
+    expected.records[7] = Library::item(4, "DVD", " Tora!  Tora! Tora! ");
+    expected.collections["favorites"].push_back(7);
+    expected.collections["empty"];
+
+    // every entry comes back, in order
+    Library library;
+    Journal journal(directory.snapshot.c_str(), directory.journal.c_str());
+    ASSERT_EQ(Journal::OK, restore(&journal, &library));
+    EXPECT_EQ(13, journal.get_entry_count());
+    EXPECT_EQ(expected.to_string(), library.to_string());
+
+    // and more can be added
+    EXPECT_EQ(Journal::OK, journal.modify_rating(1, 0));
+    EXPECT_EQ(14, journal.get_entry_count());
+    journal.close();
+    EXPECT_FALSE(journal.is_open());
+    EXPECT_EQ(Journal::ERROR, journal.modify_rating(1, 1));
+
+    Library again;
+    ASSERT_EQ(Journal::OK, restore(&journal, &again));
+    EXPECT_EQ(0, again.records[1].rating);
+}
+
+TEST(JournalUnitTest, Compact) {
+    const Temporary_directory directory;
+    Library library;
+    Journal journal(directory.snapshot.c_str(), directory.journal.c_str());
+    ASSERT_EQ(Journal::OK, restore(&journal, &library));
+
+    // grow the journal until it is worth compacting
+    ASSERT_EQ(Journal::OK, journal.add_collection("all"));
+    library.collections["all"];
+    int ID = 0;
+    while (!journal.needs_compaction()) {
+        ID++;
+        const string title = "Title of a rather long series " +
+                             std::to_string(ID);
+        ASSERT_EQ(Journal::OK, journal.add_record(ID, ID % 6, "DVD",
+                                                  title.c_str()));
+        ASSERT_EQ(Journal::OK, journal.add_member("all", ID));
+        library.records[ID] = Library::item(ID % 6, "DVD", title);
+        library.collections["all"].push_back(ID);
+    }
+    EXPECT_EQ(1 + 2 * ID, journal.get_entry_count());
+
+    for (int format = Snapshot::TEXT; format <= Snapshot::BINARY; format++) {
+        Snapshot snapshot;
+        library.to_snapshot(&snapshot);
+        ASSERT_EQ(Journal::OK,
+                  journal.compact(snapshot,
+                                  static_cast<Snapshot::Format>(format)));
+        EXPECT_TRUE(journal.is_open());
+        EXPECT_EQ(0, journal.get_entry_count());
+        EXPECT_FALSE(journal.needs_compaction());
+
+        // the snapshot holds everything, and the journal only what follows
+        ASSERT_EQ(Journal::OK, journal.modify_rating(1, 5));
+        library.records[1].rating = 5;
+
+        Library restored;
+        Journal reopened(directory.snapshot.c_str(),
+                         directory.journal.c_str());
+        ASSERT_EQ(Journal::OK, restore(&reopened, &restored));
+        EXPECT_EQ(1, reopened.get_entry_count());
+        EXPECT_EQ(library.to_string(), restored.to_string());
+    }
+
+    // the journal now has to grow as large as the snapshot, at least
+    // ourMinCompactionSize, before compacting again
+    journal.close();
+    ASSERT_EQ(Journal::OK, restore(&journal, &library));
+    int entries = 0;
+    while (!journal.needs_compaction()) {
+        ASSERT_EQ(Journal::OK, journal.modify_rating(1, entries % 6));
+        entries++;
+    }
+    EXPECT_GE(entries * static_cast<int>(sizeof("mr 1 0\n") - 1),
+              static_cast<int>(Journal::ourMinCompactionSize) - 64);
+}
+
+TEST(JournalUnitTest, InterruptedCompaction) {
+    const Temporary_directory directory;
+    Library library;
+    {
+        Journal journal(directory.snapshot.c_str(),
+                        directory.journal.c_str());
+        ASSERT_EQ(Journal::OK, restore(&journal, &library));
+        ASSERT_EQ(Journal::OK, journal.add_record(1, 5, "DVD", "Alien"));
+        ASSERT_EQ(Journal::OK, journal.add_record(2, 0, "VHS", "The Thing"));
+    }
+
+    // a compaction that wrote the snapshot but not the new journal leaves a
+    // journal that no longer follows the snapshot; its entries are all in
+    // the snapshot, and are not applied again
+    library.records[1] = Library::item(5, "DVD", "Alien");
+    library.records[2] = Library::item(0, "VHS", "The Thing");
+    directory.append(directory.snapshot, library.to_string());
+
+    Library restored;
+    Journal journal(directory.snapshot.c_str(), directory.journal.c_str());
+    ASSERT_EQ(Journal::OK, restore(&journal, &restored));
+    EXPECT_EQ(0, journal.get_entry_count());
+    EXPECT_EQ(library.to_string(), restored.to_string());
+
+    // a new journal was started for the snapshot
+    ASSERT_EQ(Journal::OK, journal.delete_record(2));
+    Library again;
+    ASSERT_EQ(Journal::OK, restore(&journal, &again));
+    EXPECT_EQ(1, journal.get_entry_count());
+    EXPECT_EQ(1U, again.records.size());
+}
+
+TEST(JournalUnitTest, IncompleteEntry) {
+    const Temporary_directory directory;
+    Library library;
+    Journal journal(directory.snapshot.c_str(), directory.journal.c_str());
+    ASSERT_EQ(Journal::OK, restore(&journal, &library));
+    ASSERT_EQ(Journal::OK, journal.add_record(1, 5, "DVD", "Alien"));
+    journal.close();
+
+    // a crash part way through appending an entry
+    directory.append(directory.journal, "mr 1 3");
+
+    Library restored;
+    ASSERT_EQ(Journal::OK, restore(&journal, &restored));
+    EXPECT_EQ(1, journal.get_entry_count());
+    EXPECT_EQ(5, restored.records[1].rating);
+
+    // the next entry replaces what was left of it
+    ASSERT_EQ(Journal::OK, journal.modify_rating(1, 2));
+    Library again;
+    ASSERT_EQ(Journal::OK, restore(&journal, &again));
+    EXPECT_EQ(2, journal.get_entry_count());
+    EXPECT_EQ(2, again.records[1].rating);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Errors
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(JournalUnitTest, Invalid) {
+    const Temporary_directory directory;
+    Library library;
+    Journal journal(directory.snapshot.c_str(), directory.journal.c_str());
+
+    // nothing is appended before replaying
+    EXPECT_EQ(Journal::ERROR, journal.add_collection("favorites"));
+    ASSERT_EQ(Journal::OK, restore(&journal, &library));
+
+    // arguments that cannot be read back
+    EXPECT_EQ(Journal::ERROR, journal.add_record(0, 5, "DVD", "Alien"));
+    EXPECT_EQ(Journal::ERROR, journal.add_record(1, 6, "DVD", "Alien"));
+    EXPECT_EQ(Journal::ERROR, journal.add_record(1, 5, "Blu ray", "Alien"));
+    EXPECT_EQ(Journal::ERROR, journal.add_record(1, 5, "DVD", ""));
+    EXPECT_EQ(Journal::ERROR, journal.add_record(1, 5, "DVD", "Ali\nen"));
+    EXPECT_EQ(Journal::ERROR, journal.delete_record(-1));
+    EXPECT_EQ(Journal::ERROR, journal.modify_rating(1, -1));
+    EXPECT_EQ(Journal::ERROR, journal.add_collection(""));
+    EXPECT_EQ(Journal::ERROR, journal.delete_collection("my favorites"));
+    EXPECT_EQ(Journal::ERROR, journal.add_member("favorites", 0));
+    EXPECT_EQ(Journal::ERROR, journal.delete_member("\t", 1));
+    EXPECT_EQ(0, journal.get_entry_count());
+
+    // an entry that does not apply
+    ASSERT_EQ(Journal::OK, journal.delete_record(1));
+    EXPECT_EQ(Journal::ERROR, restore(&journal, &library));
+    EXPECT_FALSE(journal.is_open());
+
+    // entries that cannot be read
+    const char* const entries[] = {
+        "xx 1\n",
+        "ar 1 DVD 5\n",
+        "ar 1 DVD 6 Alien\n",
+        "ar x DVD 5 Alien\n",
+        "dr 0\n",
+        "dr 1 2\n",
+        "dr\n",
+        "mr 1\n",
+        "mr 1 5 \n",
+        "ac\n",
+        "am favorites\n",
+        "dm favorites 99999999999\n",
+        "\n",
+    };
+    for (size_t i = 0; i < sizeof(entries) / sizeof(entries[0]); i++) {
+        remove(directory.journal.c_str());
+        ASSERT_EQ(Journal::OK, restore(&journal, &library));
+        journal.close();
+        directory.append(directory.journal, entries[i]);
+        EXPECT_EQ(Journal::ERROR, restore(&journal, &library))
+            << entries[i];
+    }
+
+    // a snapshot that cannot be restored
+    directory.append(directory.snapshot, "x\n");
+    Snapshot snapshot;
+    EXPECT_EQ(Journal::ERROR, journal.open(&snapshot));
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+    using std::string;
+#include <vector>
+    using std::vector;
+
+#include "gtest/gtest.h"
+
+#include "manager/Membership_index.h"
+
+
+namespace {
+
+// stands in for Collection: add_member and remove_member keep the index up
+// to date, as Collection's will
+class Group {
+  public:
+    Group(const string& in_name, Membership_index<Group>* in_index)
+      : name(in_name),
+        index(in_index) {
+    }
+
+    bool add_member(const int ID) {
+        if (Membership_index<Group>::OK != index->add(ID, this)) {
+            return false;
+        }
+        members.push_back(ID);
+        return true;
+    }
+
+    bool remove_member(const int ID) {
+        if (Membership_index<Group>::OK != index->remove(ID, this)) {
+            return false;
+        }
+        forget(ID);
+        return true;
+    }
+
+    // drop a member whose entry the index has already forgotten
+    void forget(const int ID) {
+        members.erase(std::find(members.begin(), members.end(), ID));
+    }
+
+    bool is_member_present(const int ID) const {
+        return members.end() != std::find(members.begin(), members.end(), ID);
+    }
+
+    string name;
+    vector<int> members;
+    Membership_index<Group>* index;
+};
+
+// the names of the Groups holding ID, as the index lists them
+string groups_of(const Membership_index<Group>& index, const int ID) {
+    string names;
+    index.apply_to_collections(ID, [&names](Group* group) {
+        names += group->name + " ";
+    });
+    return names;
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Add / Remove
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Membership_indexUnitTest, AddRemove) {
+    Membership_index<Group> index;
+    Group favorites("favorites", &index);
+    Group horror("horror", &index);
+    EXPECT_EQ(0, index.size());
+    EXPECT_EQ(0, index.get_count(1));
+    EXPECT_EQ("", groups_of(index, 1));
+
+    ASSERT_TRUE(favorites.add_member(1));
+    ASSERT_TRUE(horror.add_member(1));
+    ASSERT_TRUE(horror.add_member(2));
+    EXPECT_FALSE(horror.add_member(2));
+    EXPECT_EQ(2, index.size());
+    EXPECT_EQ(2, index.get_count(1));
+    EXPECT_TRUE(index.contains(1, &favorites));
+    EXPECT_FALSE(index.contains(2, &favorites));
+    EXPECT_EQ("favorites horror ", groups_of(index, 1));
+    EXPECT_EQ("horror ", groups_of(index, 2));
+
+    ASSERT_TRUE(favorites.remove_member(1));
+    EXPECT_FALSE(favorites.remove_member(1));
+    EXPECT_FALSE(favorites.remove_member(3));
+    EXPECT_EQ("horror ", groups_of(index, 1));
+
+    // a Record in no Group has no entry
+    ASSERT_TRUE(horror.remove_member(2));
+    EXPECT_EQ(1, index.size());
+    EXPECT_EQ(0, index.get_count(2));
+}
+
+TEST(Membership_indexUnitTest, ManyGroups) {
+    Membership_index<Group> index;
+    vector<Group*> groups;
+    for (int i = 0; i < 20; i++) {
+        groups.push_back(new Group(std::to_string(i), &index));
+    }
+
+    // past the ones held in the entry itself
+    string expected;
+    for (size_t i = 0; i < groups.size(); i++) {
+        ASSERT_TRUE(groups[i]->add_member(7));
+        ASSERT_TRUE(groups[i]->add_member(static_cast<int>(100 + i)));
+        expected += groups[i]->name + " ";
+    }
+    EXPECT_EQ(20, index.get_count(7));
+    EXPECT_EQ(expected, groups_of(index, 7));
+
+    // the rest keep their order
+    ASSERT_TRUE(groups[0]->remove_member(7));
+    ASSERT_TRUE(groups[10]->remove_member(7));
+    EXPECT_EQ(18, index.get_count(7));
+    EXPECT_EQ("1 2 3 4 5 6 7 8 9 11 ",
+              groups_of(index, 7).substr(0, 21));
+
+    index.clear();
+    EXPECT_EQ(0, index.size());
+    EXPECT_EQ(0, index.get_count(7));
+    for (size_t i = 0; i < groups.size(); i++) {
+        delete groups[i];
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Deleting Records
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Membership_indexUnitTest, RemoveRecord) {
+    Membership_index<Group> index;
+    Group favorites("favorites", &index);
+    Group horror("horror", &index);
+    Group empty("empty", &index);
+    favorites.add_member(1);
+    favorites.add_member(2);
+    horror.add_member(2);
+    horror.add_member(1);
+
+    // only the Groups holding the Record are visited
+    vector<Group*> visited;
+    EXPECT_EQ(2, index.remove_record(1, [&visited](Group* group) {
+        visited.push_back(group);
+        group->forget(1);
+    }));
+    ASSERT_EQ(2U, visited.size());
+    EXPECT_EQ(&favorites, visited[0]);
+    EXPECT_EQ(&horror, visited[1]);
+    EXPECT_FALSE(favorites.is_member_present(1));
+    EXPECT_FALSE(horror.is_member_present(1));
+    EXPECT_EQ(0, index.get_count(1));
+    EXPECT_EQ(2, index.get_count(2));
+
+    EXPECT_EQ(0, index.remove_record(1, [](Group* /* group */) { FAIL(); }));
+}
+
+TEST(Membership_indexUnitTest, Random) {
+    Membership_index<Group> index;
+    vector<Group*> groups;
+    for (int i = 0; i < 30; i++) {
+        groups.push_back(new Group(std::to_string(i), &index));
+    }
+
+    // the index agrees with asking every Group
+    unsigned int seed = 20;
+    for (int step = 0; step < 20000; step++) {
+        Group* const group = groups[static_cast<size_t>(rand_r(&seed) % 30)];
+        const int ID = 1 + rand_r(&seed) % 200;
+        const bool present = group->is_member_present(ID);
+        switch (rand_r(&seed) % 5) {
+          case 0:
+          case 1:
+            ASSERT_EQ(!present, group->add_member(ID));
+            break;
+          case 2:
+          case 3:
+            ASSERT_EQ(present, group->remove_member(ID));
+            break;
+          default: {
+            int count = 0;
+            for (size_t i = 0; i < groups.size(); i++) {
+                count += groups[i]->is_member_present(ID);
+            }
+            ASSERT_EQ(count, index.remove_record(ID, [ID](Group* holder) {
+                holder->forget(ID);
+            }));
+          }
+        }
+    }
+
+    for (int ID = 1; ID <= 200; ID++) {
+        int count = 0;
+        for (size_t i = 0; i < groups.size(); i++) {
+            const bool present = groups[i]->is_member_present(ID);
+            count += present;
+            ASSERT_EQ(present, index.contains(ID, groups[i]));
+        }
+        ASSERT_EQ(count, index.get_count(ID));
+    }
+
+    for (size_t i = 0; i < groups.size(); i++) {
+        delete groups[i];
+    }
+}
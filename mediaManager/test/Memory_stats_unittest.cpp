@@ -0,0 +1,235 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <atomic>  // NOLINT(build/include_order)
+#include <sstream>
+#include <string>
+    using std::string;
+#include <thread>  // NOLINT
+#include <vector>
+    using std::vector;
+
+#include "gtest/gtest.h"
+
+#include "manager/globals.h"
+#include "manager/Memory_stats.h"
+#include "manager/Ordered_list.h"
+#include "manager/Sorted_array.h"
+#include "manager/String.h"
+
+
+// To use a test fixture, derive a class from testing::Test.
+class Memory_statsUnitTest : public testing::Test {
+  protected:
+    // nothing in these tests makes Records, so each starts with none; the
+    // high-water marks count from the start of each test
+    virtual void SetUp() {
+        ASSERT_EQ(0, Memory_stats::get_count(Memory_stats::RECORD));
+        ASSERT_EQ(0, Memory_stats::get_bytes(Memory_stats::RECORD));
+        Memory_stats::reset_peaks();
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(0, Memory_stats::get_count(Memory_stats::RECORD));
+        EXPECT_EQ(0, Memory_stats::get_bytes(Memory_stats::RECORD));
+    }
+};
+
+
+namespace {
+
+// the statistics of a kind
+Memory_stats::Totals totals_of(const Memory_stats::Kind kind) {
+    Memory_stats::Totals totals;
+    Memory_stats::get_totals(kind, &totals);
+    return totals;
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Counts
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Memory_statsUnitTest, Counts) {
+    const Memory_stats::Totals before = totals_of(Memory_stats::RECORD);
+
+    Memory_stats::allocated(Memory_stats::RECORD, 48);
+    Memory_stats::allocated(Memory_stats::RECORD, 48);
+    Memory_stats::allocated(Memory_stats::RECORD, 100);
+    EXPECT_EQ(3, Memory_stats::get_count(Memory_stats::RECORD));
+    EXPECT_EQ(196, Memory_stats::get_bytes(Memory_stats::RECORD));
+
+    // sizes go in power of two buckets: 48 in 32-63, 100 in 64-127
+    Memory_stats::Totals after = totals_of(Memory_stats::RECORD);
+    EXPECT_EQ(before.allocations + 3, after.allocations);
+    EXPECT_EQ(before.histogram[5] + 2, after.histogram[5]);
+    EXPECT_EQ(before.histogram[6] + 1, after.histogram[6]);
+
+    // add changes the count and bytes only
+    Memory_stats::add(Memory_stats::RECORD, -2, -148);
+    Memory_stats::deallocated(Memory_stats::RECORD, 48);
+    after = totals_of(Memory_stats::RECORD);
+    EXPECT_EQ(0, after.count);
+    EXPECT_EQ(0, after.bytes);
+    EXPECT_EQ(before.allocations + 3, after.allocations);
+
+    // the largest sizes share the last bucket
+    Memory_stats::note_allocation(Memory_stats::RECORD, 1);
+    Memory_stats::note_allocation(Memory_stats::RECORD, 1 << 20);
+    after = totals_of(Memory_stats::RECORD);
+    EXPECT_EQ(before.histogram[0] + 1, after.histogram[0]);
+    EXPECT_EQ(before.histogram[Memory_stats::ourNumBuckets - 1] + 1,
+              after.histogram[Memory_stats::ourNumBuckets - 1]);
+}
+
+TEST_F(Memory_statsUnitTest, Peaks) {
+    for (int i = 0; i < 3; i++) {
+        Memory_stats::allocated(Memory_stats::RECORD, 10);
+    }
+    Memory_stats::deallocated(Memory_stats::RECORD, 10);
+    Memory_stats::deallocated(Memory_stats::RECORD, 10);
+    Memory_stats::allocated(Memory_stats::RECORD, 10);
+
+    Memory_stats::Totals totals = totals_of(Memory_stats::RECORD);
+    EXPECT_EQ(2, totals.count);
+    EXPECT_EQ(3, totals.peak_count);
+    EXPECT_EQ(30, totals.peak_bytes);
+
+    // the marks come down to the present values
+    Memory_stats::reset_peaks();
+    totals = totals_of(Memory_stats::RECORD);
+    EXPECT_EQ(2, totals.peak_count);
+    EXPECT_EQ(20, totals.peak_bytes);
+
+    Memory_stats::add(Memory_stats::RECORD, -2, -20);
+}
+
+TEST_F(Memory_statsUnitTest, Strings) {
+    const int numStrings = String::get_number();
+    const Memory_stats::Totals before = totals_of(Memory_stats::STRING);
+    {
+        // 40 characters and the NULL go on the heap, in the 32-63 bucket
+        String string;
+        string.init("0123456789012345678901234567890123456789");
+        EXPECT_EQ(numStrings + 1, String::get_number());
+        EXPECT_EQ(String::get_number(),
+                  Memory_stats::get_count(Memory_stats::STRING));
+        EXPECT_EQ(String::get_total_allocation(),
+                  Memory_stats::get_bytes(Memory_stats::STRING));
+
+        const Memory_stats::Totals after = totals_of(Memory_stats::STRING);
+        EXPECT_EQ(before.allocations + 1, after.allocations);
+        EXPECT_EQ(before.histogram[5] + 1, after.histogram[5]);
+        EXPECT_LE(before.bytes + 41, after.peak_bytes);
+    }
+    EXPECT_EQ(numStrings, String::get_number());
+    EXPECT_EQ(before.bytes, Memory_stats::get_bytes(Memory_stats::STRING));
+}
+
+TEST_F(Memory_statsUnitTest, Lists) {
+    const int lists = g_Ordered_list_count;
+    const int nodes = g_Ordered_list_Node_count;
+    const int64_t listBytes =
+        Memory_stats::get_bytes(Memory_stats::ORDERED_LIST);
+    {
+        Ordered_list<int> list;
+        for (int i = 0; i < 10; i++) {
+            list.insert(i);
+        }
+        EXPECT_EQ(lists + 1, g_Ordered_list_count);
+        EXPECT_EQ(nodes + 10, g_Ordered_list_Node_count);
+        EXPECT_EQ(nodes + 10,
+                  Memory_stats::get_count(Memory_stats::LIST_NODE));
+
+        // a Sorted_array counts its array, not nodes
+        typedef Ordered_list<int, Sorted_array_storage> Array;
+        Array array;
+        array.insert(1);
+        EXPECT_EQ(lists + 2, g_Ordered_list_count);
+        EXPECT_EQ(nodes + 10, g_Ordered_list_Node_count);
+        EXPECT_EQ(listBytes + Array::min_allocation *
+                              static_cast<int64_t>(sizeof(*array.begin())),
+                  Memory_stats::get_bytes(Memory_stats::ORDERED_LIST));
+    }
+    EXPECT_EQ(lists, g_Ordered_list_count);
+    EXPECT_EQ(nodes, g_Ordered_list_Node_count);
+    EXPECT_EQ(listBytes, Memory_stats::get_bytes(Memory_stats::ORDERED_LIST));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Threads
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Memory_statsUnitTest, Threads) {
+    // more threads than shards, all running at once, so that some share
+    static const int numThreads = 24;
+    static const int numChanges = 10000;
+    static const int numKept = 5;
+    std::atomic<bool> go(false);
+    std::atomic<int> ready(0);
+
+    vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&go, &ready]() {
+            ready++;
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < numChanges; i++) {
+                Memory_stats::allocated(Memory_stats::RECORD, 16);
+                Memory_stats::deallocated(Memory_stats::RECORD, 16);
+            }
+            for (int i = 0; i < numKept; i++) {
+                Memory_stats::allocated(Memory_stats::RECORD, 16);
+            }
+        }));
+    }
+    while (numThreads != ready) {
+        std::this_thread::yield();
+    }
+    go = true;
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    // the counts of threads that have ended are kept
+    const Memory_stats::Totals totals = totals_of(Memory_stats::RECORD);
+    EXPECT_EQ(numThreads * numKept, totals.count);
+    EXPECT_EQ(numThreads * numKept * 16, totals.bytes);
+    EXPECT_LE(totals.count, totals.peak_count);
+
+    // the shards given up can be taken again, and still add up
+    std::thread cleaner([]() {
+        Memory_stats::add(Memory_stats::RECORD, -numThreads * numKept,
+                          -numThreads * numKept * 16);
+    });
+    cleaner.join();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// The pa command
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Memory_statsUnitTest, Print) {
+    Memory_stats::allocated(Memory_stats::RECORD, 48);
+    std::ostringstream os;
+    Memory_stats::print(&os);
+    const string report = os.str();
+
+    EXPECT_EQ(0U, report.find("Memory allocations:\n"));
+    EXPECT_NE(string::npos, report.find("Strings"));
+    EXPECT_NE(string::npos, report.find("List nodes"));
+    EXPECT_NE(string::npos, report.find("Records allocation sizes:\n"));
+    EXPECT_NE(string::npos, report.find("      32 - 63       bytes"));
+
+    Memory_stats::deallocated(Memory_stats::RECORD, 48);
+}
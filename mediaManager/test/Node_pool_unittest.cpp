@@ -0,0 +1,103 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include "gtest/gtest.h"
+
+#include "manager/Node_pool.h"
+
+
+namespace {
+
+struct Pair {
+    int first;
+    double second;
+};
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Allocate
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Node_poolUnitTest, Allocate) {
+    Node_pool<Pair> pool;
+
+    // enough nodes to span several chunks
+    const int count = 3 * Node_pool<Pair>::ourMinChunkNodes + 1;
+    Pair* nodes[count];
+    for (int i = 0; i < count; i++) {
+        nodes[i] = pool.allocate();
+        ASSERT_NE(static_cast<Pair*>(0), nodes[i]);
+        EXPECT_EQ(0U, reinterpret_cast<size_t>(nodes[i]) % alignof(Pair));
+        nodes[i]->first = i;
+        nodes[i]->second = i;
+    }
+
+    // no two nodes share storage
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(i, nodes[i]->first);
+        EXPECT_EQ(i, nodes[i]->second);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Deallocate
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Node_poolUnitTest, DeallocateReuses) {
+    Node_pool<Pair> pool;
+    Pair* a = pool.allocate();
+    Pair* b = pool.allocate();
+
+    pool.deallocate(a);
+    EXPECT_EQ(a, pool.allocate());
+
+    pool.deallocate(b);
+    EXPECT_EQ(b, pool.allocate());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ReleaseAll / Swap
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Node_poolUnitTest, ReleaseAll) {
+    Node_pool<Pair> pool;
+    for (int i = 0; i < 100; i++) {
+        pool.allocate();
+    }
+
+    EXPECT_TRUE(pool.release_all());
+
+    // the pool is usable again afterwards
+    Pair* node = pool.allocate();
+    node->first = 1;
+    EXPECT_EQ(1, node->first);
+}
+
+TEST(Node_poolUnitTest, Swap) {
+    Node_pool<Pair> a;
+    Node_pool<Pair> b;
+    Pair* node = a.allocate();
+
+    a.swap(b);
+    b.deallocate(node);
+    EXPECT_EQ(node, b.allocate());
+}
+
+TEST(Node_poolUnitTest, HeapNodeAllocator) {
+    Heap_node_allocator<Pair> heap;
+    Pair* node = heap.allocate();
+    ASSERT_NE(static_cast<Pair*>(0), node);
+    node->first = 1;
+    heap.deallocate(node);
+
+    EXPECT_FALSE(heap.release_all());
+}
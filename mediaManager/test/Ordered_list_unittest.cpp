@@ -0,0 +1,483 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdlib>
+#include <functional>
+#include <string>
+    using std::string;
+
+#include "gtest/gtest.h"
+
+#include "manager/globals.h"
+#include "manager/Node_pool.h"
+#include "manager/Ordered_list.h"
+
+
+// To use a test fixture, derive a class from testing::Test.
+class Ordered_listUnitTest : public testing::Test {
+  protected:
+    // every test starts and must finish with no lists or nodes alive
+    virtual void SetUp() {
+        ASSERT_EQ(0, g_Ordered_list_count);
+        ASSERT_EQ(0, g_Ordered_list_Node_count);
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(0, g_Ordered_list_count);
+        EXPECT_EQ(0, g_Ordered_list_Node_count);
+    }
+};
+
+
+namespace {
+
+// an item whose ordering ignores its tag, to check where equal items go
+struct Tagged {
+    Tagged()
+      : key(0), tag(0) {
+    }
+
+    Tagged(const int in_key, const char in_tag)
+      : key(in_key), tag(in_tag) {
+    }
+
+    bool operator< (const Tagged& rhs) const {
+        return key < rhs.key;
+    }
+
+    int key;
+    char tag;
+};
+
+bool greater_than(const int& a, const int& b) {
+    return a > b;
+}
+
+// a function object ordering
+struct Greater {
+    bool operator() (const int& a, const int& b) const {
+        return a > b;
+    }
+};
+
+// a type with no < operator, so it needs an ordering function
+struct Unordered {
+    explicit Unordered(const int in_value)
+      : value(in_value) {
+    }
+
+    int value;
+};
+
+bool order_unordered(const Unordered& a, const Unordered& b) {
+    return a.value < b.value;
+}
+
+int g_sum = 0;
+
+void add_to_sum(const int& i) {
+    g_sum += i;
+}
+
+bool is_negative(const int& i) {
+    return i < 0;
+}
+
+void add_to(const int& i, int* total) {
+    *total += i;
+}
+
+bool is_equal(const int& i, int probe) {
+    return i == probe;
+}
+
+// render an int list as "1 2 3" for easy comparison
+template<typename List>
+string to_string(const List& list) {
+    string result;
+    for (typename List::Iterator it = list.begin(); it != list.end(); ++it) {
+        if (!result.empty()) {
+            result += ' ';
+        }
+        result += static_cast<char>('0' + *it);
+    }
+    return result;
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Insert
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Ordered_listUnitTest, Insert) {
+    Ordered_list<int> list;
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(0, list.size());
+    EXPECT_TRUE(list.begin() == list.end());
+
+    list.insert(5);
+    list.insert(1);
+    list.insert(9);
+    list.insert(3);
+
+    EXPECT_FALSE(list.empty());
+    EXPECT_EQ(4, list.size());
+    EXPECT_EQ("1 3 5 9", to_string(list));
+    EXPECT_EQ(1, g_Ordered_list_count);
+    EXPECT_EQ(4, g_Ordered_list_Node_count);
+}
+
+TEST_F(Ordered_listUnitTest, InsertOrderingFunction) {
+    Ordered_list<int> list(greater_than);
+    list.insert(5);
+    list.insert(1);
+    list.insert(9);
+
+    EXPECT_EQ("9 5 1", to_string(list));
+}
+
+TEST_F(Ordered_listUnitTest, InsertEqualGoesBefore) {
+    Ordered_list<Tagged> list;
+    list.insert(Tagged(1, 'a'));
+    list.insert(Tagged(2, 'b'));
+    list.insert(Tagged(1, 'c'));
+
+    Ordered_list<Tagged>::Iterator it = list.begin();
+    EXPECT_EQ('c', it->tag);
+    EXPECT_EQ('a', (++it)->tag);
+    EXPECT_EQ('b', (++it)->tag);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Ordering
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Ordered_listUnitTest, OrderingFunctionObject) {
+    Ordered_list<int, Node_pool, Greater> list;
+    list.insert(1);
+    list.insert(3);
+    list.insert(2);
+    EXPECT_EQ("3 2 1", to_string(list));
+    EXPECT_EQ(2, *list.find(2));
+
+    Ordered_list<int, Node_pool, Greater> assigned(list);
+    assigned = list;
+    EXPECT_EQ("3 2 1", to_string(assigned));
+}
+
+TEST_F(Ordered_listUnitTest, OrderingLambda) {
+    const int pivot = 5;
+    // order by distance from the pivot
+    auto by_distance = [pivot](const int& a, const int& b) {
+        return std::abs(a - pivot) < std::abs(b - pivot);
+    };
+
+    Ordered_list<int, Node_pool, decltype(by_distance)> list(by_distance);
+    list.insert(9);
+    list.insert(4);
+    list.insert(6);
+    list.insert(1);
+    EXPECT_EQ("6 4 1 9", to_string(list));
+}
+
+TEST_F(Ordered_listUnitTest, OrderingFunctionPointer) {
+    // the default ordering also accepts less_than explicitly
+    Ordered_list<int> list(less_than<int>);
+    list.insert(2);
+    list.insert(1);
+    EXPECT_EQ("1 2", to_string(list));
+
+    // and a type with no < operator works given an ordering function
+    Ordered_list<Unordered> unordered(order_unordered);
+    unordered.insert(Unordered(2));
+    unordered.insert(Unordered(1));
+    EXPECT_EQ(1, unordered.begin()->value);
+    EXPECT_EQ(2, unordered.find(Unordered(2))->value);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// InsertRange
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Ordered_listUnitTest, InsertRange) {
+    const int batch[] = {5, 1, 9, 3};
+
+    Ordered_list<int> list;
+    list.insert_range(batch, batch);
+    EXPECT_TRUE(list.empty());
+
+    list.insert_range(batch, batch + 4);
+    EXPECT_EQ("1 3 5 9", to_string(list));
+    EXPECT_EQ(4, list.size());
+
+    list.insert_range(batch + 1, batch + 3);
+    EXPECT_EQ("1 1 3 5 9 9", to_string(list));
+    EXPECT_EQ(6, list.size());
+    EXPECT_EQ(6, g_Ordered_list_Node_count);
+}
+
+TEST_F(Ordered_listUnitTest, RangeConstructor) {
+    const int batch[] = {5, 1, 9, 3};
+
+    Ordered_list<int> list(batch, batch + 4);
+    EXPECT_EQ("1 3 5 9", to_string(list));
+    EXPECT_EQ(1, g_Ordered_list_count);
+
+    Ordered_list<int, Heap_node_allocator> reversed(list.begin(), list.end(),
+                                                    greater_than);
+    EXPECT_EQ("9 5 3 1", to_string(reversed));
+    EXPECT_EQ(8, g_Ordered_list_Node_count);
+}
+
+// a batch, with duplicates within it and against the list, ends up exactly
+// as if it were inserted one item at a time
+TEST_F(Ordered_listUnitTest, InsertRangeMatchesInsert) {
+    Ordered_list<Tagged> one_at_a_time;
+    Ordered_list<Tagged> batched;
+
+    Tagged batch[20];
+    for (int i = 0; i < 20; i++) {
+        batch[i] = Tagged((i * 7) % 4, static_cast<char>('a' + i));
+        one_at_a_time.insert(batch[i]);
+    }
+    batched.insert_range(batch, batch + 10);
+    batched.insert_range(batch + 10, batch + 20);
+
+    string expected;
+    for (Ordered_list<Tagged>::Iterator it = one_at_a_time.begin();
+         it != one_at_a_time.end(); ++it) {
+        expected += it->tag;
+    }
+    string actual;
+    for (Ordered_list<Tagged>::Iterator it = batched.begin();
+         it != batched.end(); ++it) {
+        actual += it->tag;
+    }
+    EXPECT_EQ(expected, actual);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Find / Erase
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Ordered_listUnitTest, Find) {
+    Ordered_list<Tagged> list;
+    list.insert(Tagged(1, 'a'));
+    list.insert(Tagged(3, 'b'));
+    list.insert(Tagged(3, 'c'));
+
+    Ordered_list<Tagged>::Iterator it = list.find(Tagged(3, 'x'));
+    ASSERT_TRUE(it != list.end());
+    EXPECT_EQ('c', it->tag);
+
+    EXPECT_TRUE(list.end() == list.find(Tagged(0, 'x')));
+    EXPECT_TRUE(list.end() == list.find(Tagged(2, 'x')));
+    EXPECT_TRUE(list.end() == list.find(Tagged(4, 'x')));
+}
+
+TEST_F(Ordered_listUnitTest, Erase) {
+    Ordered_list<int> list;
+    for (int i = 1; i <= 5; i++) {
+        list.insert(i);
+    }
+
+    list.erase(list.find(3));
+    EXPECT_EQ("1 2 4 5", to_string(list));
+    list.erase(list.begin());
+    EXPECT_EQ("2 4 5", to_string(list));
+    list.erase(list.find(5));
+    EXPECT_EQ("2 4", to_string(list));
+    EXPECT_EQ(2, list.size());
+    EXPECT_EQ(2, g_Ordered_list_Node_count);
+
+    // erased storage is reused by the next insert
+    list.insert(7);
+    EXPECT_EQ("2 4 7", to_string(list));
+}
+
+
+TEST_F(Ordered_listUnitTest, LowerBound) {
+    Ordered_list<Tagged> list;
+    EXPECT_TRUE(list.end() == list.lower_bound(Tagged(1, 'x')));
+
+    list.insert(Tagged(1, 'a'));
+    list.insert(Tagged(3, 'b'));
+    list.insert(Tagged(3, 'c'));
+
+    EXPECT_EQ('a', list.lower_bound(Tagged(0, 'x'))->tag);
+    EXPECT_EQ('a', list.lower_bound(Tagged(1, 'x'))->tag);
+    EXPECT_EQ('c', list.lower_bound(Tagged(2, 'x'))->tag);
+    EXPECT_EQ('c', list.lower_bound(Tagged(3, 'x'))->tag);
+    EXPECT_TRUE(list.end() == list.lower_bound(Tagged(4, 'x')));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copy / Assign / Swap / Clear
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Ordered_listUnitTest, Copy) {
+    Ordered_list<int> a(greater_than);
+    a.insert(1);
+    a.insert(2);
+
+    Ordered_list<int> b(a);
+    EXPECT_EQ("2 1", to_string(b));
+    EXPECT_EQ(2, g_Ordered_list_count);
+    EXPECT_EQ(4, g_Ordered_list_Node_count);
+
+    // the copy keeps the ordering function and is independent
+    b.insert(3);
+    EXPECT_EQ("3 2 1", to_string(b));
+    EXPECT_EQ("2 1", to_string(a));
+}
+
+TEST_F(Ordered_listUnitTest, Assign) {
+    Ordered_list<int> a;
+    a.insert(1);
+    a.insert(2);
+
+    Ordered_list<int> b;
+    b.insert(9);
+    b = a;
+    EXPECT_EQ("1 2", to_string(b));
+    EXPECT_EQ(4, g_Ordered_list_Node_count);
+
+    b = b;
+    EXPECT_EQ("1 2", to_string(b));
+    EXPECT_EQ(4, g_Ordered_list_Node_count);
+}
+
+TEST_F(Ordered_listUnitTest, Swap) {
+    Ordered_list<int> a;
+    a.insert(1);
+    Ordered_list<int> b(greater_than);
+    b.insert(2);
+    b.insert(3);
+
+    a.swap(b);
+    EXPECT_EQ("3 2", to_string(a));
+    EXPECT_EQ("1", to_string(b));
+
+    // the ordering functions travel with the nodes
+    a.insert(4);
+    b.insert(0);
+    EXPECT_EQ("4 3 2", to_string(a));
+    EXPECT_EQ("0 1", to_string(b));
+}
+
+TEST_F(Ordered_listUnitTest, Clear) {
+    Ordered_list<int> list;
+    for (int i = 0; i < 100; i++) {
+        list.insert(i % 10);
+    }
+    EXPECT_EQ(100, g_Ordered_list_Node_count);
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(0, list.size());
+    EXPECT_EQ(0, g_Ordered_list_Node_count);
+
+    list.insert(4);
+    EXPECT_EQ("4", to_string(list));
+}
+
+TEST_F(Ordered_listUnitTest, ClearNonTrivial) {
+    Ordered_list<string> list;
+    list.insert("b");
+    list.insert("a");
+    EXPECT_EQ(2, g_Ordered_list_Node_count);
+
+    list.clear();
+    EXPECT_EQ(0, g_Ordered_list_Node_count);
+
+    list.insert("c");
+    EXPECT_EQ("c", *list.begin());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Apply
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Ordered_listUnitTest, Apply) {
+    Ordered_list<int> list;
+    list.insert(1);
+    list.insert(2);
+    list.insert(3);
+
+    g_sum = 0;
+    list.apply(add_to_sum);
+    EXPECT_EQ(6, g_sum);
+
+    EXPECT_FALSE(list.apply_if(is_negative));
+    list.insert(-1);
+    EXPECT_TRUE(list.apply_if(is_negative));
+
+    int total = 0;
+    list.apply_arg(add_to, &total);
+    EXPECT_EQ(5, total);
+
+    EXPECT_TRUE(list.apply_if_arg(is_equal, 2));
+    EXPECT_FALSE(list.apply_if_arg(is_equal, 7));
+}
+
+TEST_F(Ordered_listUnitTest, ApplyLambda) {
+    Ordered_list<int> list;
+    list.insert(1);
+    list.insert(2);
+    list.insert(3);
+
+    int total = 0;
+    list.apply([&total](const int& i) {total += i;});
+    EXPECT_EQ(6, total);
+
+    EXPECT_TRUE(list.apply_if([](const int& i) {return i > 2;}));
+    EXPECT_FALSE(list.apply_if([](const int& i) {return i > 3;}));
+
+    list.apply_arg([](const int& i, int& sum) {sum += i;}, std::ref(total));
+    EXPECT_EQ(12, total);
+
+    // Arg can be given explicitly to pass by reference
+    list.apply_arg<int&>([](const int& i, int& sum) {sum -= i;}, total);
+    EXPECT_EQ(6, total);
+
+    EXPECT_TRUE(list.apply_if_arg(
+        [](const int& i, const int limit) {return i >= limit;}, 3));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Heap_node_allocator
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Ordered_listUnitTest, HeapNodeAllocator) {
+    Ordered_list<int, Heap_node_allocator> a;
+    a.insert(2);
+    a.insert(1);
+
+    Ordered_list<int, Heap_node_allocator> b(a);
+    b.erase(b.begin());
+    b.insert(3);
+    EXPECT_EQ("1 2", to_string(a));
+    EXPECT_EQ("2 3", to_string(b));
+
+    a.swap(b);
+    EXPECT_EQ("2 3", to_string(a));
+    a.clear();
+    EXPECT_EQ(2, g_Ordered_list_Node_count);
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <sstream>
+    using std::stringstream;
+#include <string>
+    using std::string;
+
+#include "gtest/gtest.h"
+
+#include "manager/Id_index.h"
+#include "manager/Restore_journal.h"
+#include "manager/Snapshot.h"
+#include "manager/Snapshot_reader.h"
+
+
+namespace {
+
+// stands in for Record: new objects take IDs from a static counter, which a
+// restore advances past the IDs it reads
+class Item {
+  public:
+    explicit Item(const int ID)
+      : myID(ID) {
+        if (ID > ourIDCounter) {
+            ourIDCounter = ID;
+        }
+        ourCount++;
+    }
+
+    ~Item() {
+        ourCount--;
+    }
+
+    int get_ID() const {
+        return myID;
+    }
+
+    static void save_ID_counter() {
+        ourSavedIDCounter = ourIDCounter;
+    }
+
+    static void restore_ID_counter() {
+        ourIDCounter = ourSavedIDCounter;
+    }
+
+    static int ourIDCounter;
+    static int ourSavedIDCounter;
+    static int ourCount;
+
+  private:
+    const int myID;
+};
+
+int Item::ourIDCounter = 0;
+int Item::ourSavedIDCounter = 0;
+int Item::ourCount = 0;
+
+// delete every Item in library
+void destroy(Id_index<Item>* library) {
+    library->apply_in_id_order([](Item* item) { delete item; });
+    library->clear();
+}
+
+// restore the Records of a file into library, as the rA command will: each
+// chunk is checked against library and added to it as it is read, and
+// everything added is undone if any of the file is bad
+bool restore(const string& file, Id_index<Item>* library) {
+    stringstream in(file);
+    Snapshot_reader reader(2);
+    Restore_journal<Item> journal;
+    journal.begin();
+
+    bool valid = Snapshot_reader::OK == reader.open(&in);
+    int count = 1;
+    while (valid && (count > 0)) {
+        valid = Snapshot_reader::OK == reader.next_records(&count);
+        for (int i = 0; valid && (i < count); i++) {
+            Item* const item = new Item(reader.get_record(i).ID);
+            valid = Id_index<Item>::OK == library->insert(item);
+            if (valid) {
+                journal.add(item);
+            } else {
+                delete item;
+            }
+        }
+    }
+
+    bool found = true;
+    while (valid && found) {
+        valid = Snapshot_reader::OK == reader.next_collection(&found);
+        for (int j = 0; valid && found && (j < reader.get_member_count());
+             j++) {
+            valid = 0 != library->find(reader.get_member_ID(j));
+        }
+    }
+
+    if (valid) {
+        journal.commit();
+    } else {
+        journal.rollback([library](Item* item) {
+            library->erase(item->get_ID());
+            delete item;
+        });
+    }
+    return valid;
+}
+
+// a binary file of Records with the given IDs, and one Collection holding
+// member
+string binary_file(const int* const IDs, const int count, const int member) {
+    Snapshot snapshot;
+    for (int i = 0; i < count; i++) {
+        snapshot.add_record(IDs[i], 0, "DVD", std::to_string(IDs[i]).c_str());
+    }
+    snapshot.add_collection("favorites");
+    snapshot.add_member(member);
+
+    stringstream out;
+    snapshot.save(&out, Snapshot::BINARY);
+    return out.str();
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Journal
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Restore_journalUnitTest, CommitAndRollback) {
+    Item::ourIDCounter = 10;
+    Restore_journal<Item> journal;
+
+    journal.begin();
+    Item* const first = new Item(20);
+    Item* const second = new Item(30);
+    journal.add(first);
+    journal.add(second);
+    EXPECT_EQ(2, journal.size());
+    EXPECT_EQ(30, Item::ourIDCounter);
+
+    journal.commit();
+    EXPECT_EQ(0, journal.size());
+    EXPECT_EQ(30, Item::ourIDCounter);
+
+    // undone newest first, and the counter goes back to where begin() was
+    journal.begin();
+    for (int ID = 31; ID <= 40; ID++) {
+        journal.add(new Item(ID));
+    }
+    int expected = 40;
+    journal.rollback([&expected](Item* item) {
+        EXPECT_EQ(expected--, item->get_ID());
+        delete item;
+    });
+    EXPECT_EQ(30, expected);
+    EXPECT_EQ(0, journal.size());
+    EXPECT_EQ(30, Item::ourIDCounter);
+    EXPECT_EQ(2, Item::ourCount);
+
+    delete first;
+    delete second;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Restore
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Restore_journalUnitTest, Restore) {
+    Item::ourIDCounter = 0;
+    Id_index<Item> library;
+    library.insert(new Item(1));
+
+    // added chunk by chunk
+    const int IDs[] = {2, 3, 4, 5, 6};
+    ASSERT_TRUE(restore(binary_file(IDs, 5, 4), &library));
+    EXPECT_EQ(6, library.size());
+    EXPECT_EQ(6, Item::ourIDCounter);
+    EXPECT_EQ(6, Item::ourCount);
+
+    destroy(&library);
+    EXPECT_EQ(0, Item::ourCount);
+}
+
+TEST(Restore_journalUnitTest, RestoreFails) {
+    Item::ourIDCounter = 0;
+    Id_index<Item> library;
+    library.insert(new Item(1));
+
+    // a duplicate in the third chunk undoes the first two
+    const int duplicate[] = {7, 8, 9, 10, 1};
+    EXPECT_FALSE(restore(binary_file(duplicate, 5, 7), &library));
+    EXPECT_EQ(1, library.size());
+    EXPECT_EQ(1, Item::ourIDCounter);
+    EXPECT_EQ(1, Item::ourCount);
+
+    // a bad member, after every Record has been read, undoes them all
+    const int IDs[] = {7, 8, 9, 10, 11};
+    string bad = binary_file(IDs, 5, 7);
+    bad[bad.size() - 4] = 99;
+    EXPECT_FALSE(restore(bad, &library));
+    EXPECT_EQ(1, library.size());
+    EXPECT_EQ(1, Item::ourIDCounter);
+    EXPECT_EQ(1, Item::ourCount);
+    EXPECT_EQ(0, library.find(7));
+
+    // a truncated file
+    const string good = binary_file(IDs, 5, 7);
+    EXPECT_FALSE(restore(good.substr(0, good.size() / 2), &library));
+    EXPECT_EQ(1, library.size());
+    EXPECT_EQ(1, Item::ourCount);
+
+    destroy(&library);
+}
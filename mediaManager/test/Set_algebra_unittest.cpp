@@ -0,0 +1,260 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+    using std::string;
+#include <vector>
+    using std::vector;
+
+#include "gtest/gtest.h"
+
+#include "manager/Ordered_list.h"
+#include "manager/Set_algebra.h"
+#include "manager/Sorted_array.h"
+
+
+namespace {
+
+typedef Ordered_list<int> List;
+typedef Ordered_list<int, Sorted_array_storage> Array;
+
+// the ordering the lists are kept in
+bool less(const int& i1, const int& i2) {
+    return i1 < i2;
+}
+
+// a list holding the numbers in text, e.g. "1 3 5"
+template<typename L>
+L make_list(const string& text) {
+    L list;
+    const char* position = text.c_str();
+    char* end = 0;
+    for (int i = strtol(position, &end, 10); end != position;
+         i = strtol(position, &end, 10)) {
+        list.insert(i);
+        position = end;
+    }
+    return list;
+}
+
+// collects a result as text, to compare with make_list's
+class Printer {
+  public:
+    explicit Printer(string* in_text)
+      : text(in_text) {
+    }
+
+    void operator() (const int i) {
+        if (!text->empty()) {
+            *text += " ";
+        }
+        *text += std::to_string(i);
+    }
+
+  private:
+    string* text;
+};
+
+// a sorted list of distinct numbers below limit, each there by chance
+vector<int> random_set(const int limit, const int percent,
+                       unsigned int* const seed) {
+    vector<int> set;
+    for (int i = 0; i < limit; i++) {
+        if (rand_r(seed) % 100 < percent) {
+            set.push_back(i);
+        }
+    }
+    return set;
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Two lists
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Set_algebraUnitTest, Pairs) {
+    const List odd = make_list<List>("1 3 5 7 9");
+    const List low = make_list<List>("1 2 3 4");
+    const List none;
+
+    string text;
+    merge_union(odd, low, less, Printer(&text));
+    EXPECT_EQ("1 2 3 4 5 7 9", text);
+    text.clear();
+    merge_intersection(odd, low, less, Printer(&text));
+    EXPECT_EQ("1 3", text);
+    text.clear();
+    merge_difference(odd, low, less, Printer(&text));
+    EXPECT_EQ("5 7 9", text);
+    text.clear();
+    merge_difference(low, odd, less, Printer(&text));
+    EXPECT_EQ("2 4", text);
+
+    // with an empty list
+    text.clear();
+    merge_union(none, low, less, Printer(&text));
+    EXPECT_EQ("1 2 3 4", text);
+    text.clear();
+    merge_intersection(odd, none, less, Printer(&text));
+    EXPECT_EQ("", text);
+    text.clear();
+    merge_difference(odd, none, less, Printer(&text));
+    EXPECT_EQ("1 3 5 7 9", text);
+}
+
+TEST(Set_algebraUnitTest, IntoNewList) {
+    const Array odd = make_list<Array>("1 3 5 7 9");
+    const Array high = make_list<Array>("5 6 7 8 9 10");
+
+    // a Sorted_array_storage list takes the result in order at its end
+    Array both;
+    merge_union(odd, high, less, [&both](const int i) {
+        both.insert(i);
+    });
+    EXPECT_EQ(8, both.size());
+    string text;
+    both.apply(Printer(&text));
+    EXPECT_EQ("1 3 5 6 7 8 9 10", text);
+
+    // a linked list takes it all at once
+    vector<int> items;
+    merge_intersection(odd, high, less, [&items](const int i) {
+        items.push_back(i);
+    });
+    const List common(items.begin(), items.end());
+    text.clear();
+    common.apply(Printer(&text));
+    EXPECT_EQ("5 7 9", text);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Many lists
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Set_algebraUnitTest, Batch) {
+    const List library = make_list<List>("1 2 3 4 5 6 7 8 9 10 11 12");
+    const List odd = make_list<List>("1 3 5 7 9 11");
+    const List threes = make_list<List>("3 6 9 12");
+    const List low = make_list<List>("1 2 3 9");
+    const List none;
+    const List* const lists[] = {&odd, &threes, &low, &none};
+
+    string text;
+    merge_union_all(lists, 4, less, Printer(&text));
+    EXPECT_EQ("1 2 3 5 6 7 9 11 12", text);
+    text.clear();
+    merge_intersection_all(lists, 3, less, Printer(&text));
+    EXPECT_EQ("3 9", text);
+    text.clear();
+    merge_in_none(library, lists, 4, less, Printer(&text));
+    EXPECT_EQ("4 8 10", text);
+
+    // an empty list leaves nothing in all of them
+    text.clear();
+    merge_intersection_all(lists, 4, less, Printer(&text));
+    EXPECT_EQ("", text);
+
+    // no lists at all
+    text.clear();
+    merge_union_all(lists, 0, less, Printer(&text));
+    merge_intersection_all(lists, 0, less, Printer(&text));
+    EXPECT_EQ("", text);
+    merge_in_none(library, lists, 0, less, Printer(&text));
+    EXPECT_EQ("1 2 3 4 5 6 7 8 9 10 11 12", text);
+}
+
+TEST(Set_algebraUnitTest, Random) {
+    unsigned int seed = 21;
+    for (int round = 0; round < 50; round++) {
+        const int count = 1 + rand_r(&seed) % 12;
+        const vector<int> library = random_set(500, 90, &seed);
+        vector<vector<int> > sets;
+        for (int i = 0; i < count; i++) {
+            sets.push_back(random_set(500, 20 + rand_r(&seed) % 80, &seed));
+        }
+        vector<const vector<int>*> lists;
+        for (int i = 0; i < count; i++) {
+            lists.push_back(&sets[static_cast<size_t>(i)]);
+        }
+
+        // the standard algorithms, one pair at a time
+        vector<int> expected;
+        std::set_union(sets[0].begin(), sets[0].end(),
+                       sets.back().begin(), sets.back().end(),
+                       std::back_inserter(expected));
+        vector<int> result;
+        merge_union(sets[0], sets.back(), less, [&result](const int i) {
+            result.push_back(i);
+        });
+        ASSERT_EQ(expected, result);
+
+        expected.clear();
+        result.clear();
+        std::set_intersection(sets[0].begin(), sets[0].end(),
+                              sets.back().begin(), sets.back().end(),
+                              std::back_inserter(expected));
+        merge_intersection(sets[0], sets.back(), less,
+                           [&result](const int i) {
+            result.push_back(i);
+        });
+        ASSERT_EQ(expected, result);
+
+        expected.clear();
+        result.clear();
+        std::set_difference(sets[0].begin(), sets[0].end(),
+                            sets.back().begin(), sets.back().end(),
+                            std::back_inserter(expected));
+        merge_difference(sets[0], sets.back(), less, [&result](const int i) {
+            result.push_back(i);
+        });
+        ASSERT_EQ(expected, result);
+
+        // the batch versions agree with folding the pairs together
+        vector<int> in_any = sets[0];
+        vector<int> in_all = sets[0];
+        for (int i = 1; i < count; i++) {
+            const vector<int>& set = sets[static_cast<size_t>(i)];
+            vector<int> next;
+            std::set_union(in_any.begin(), in_any.end(), set.begin(),
+                           set.end(), std::back_inserter(next));
+            in_any.swap(next);
+            next.clear();
+            std::set_intersection(in_all.begin(), in_all.end(), set.begin(),
+                                  set.end(), std::back_inserter(next));
+            in_all.swap(next);
+        }
+
+        result.clear();
+        merge_union_all(&lists[0], count, less, [&result](const int i) {
+            result.push_back(i);
+        });
+        ASSERT_EQ(in_any, result);
+
+        result.clear();
+        merge_intersection_all(&lists[0], count, less,
+                               [&result](const int i) {
+            result.push_back(i);
+        });
+        ASSERT_EQ(in_all, result);
+
+        expected.clear();
+        result.clear();
+        std::set_difference(library.begin(), library.end(), in_any.begin(),
+                            in_any.end(), std::back_inserter(expected));
+        merge_in_none(library, &lists[0], count, less,
+                      [&result](const int i) {
+            result.push_back(i);
+        });
+        ASSERT_EQ(expected, result);
+    }
+}
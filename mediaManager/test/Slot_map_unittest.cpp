@@ -0,0 +1,189 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+    using std::vector;
+
+#include "gtest/gtest.h"
+
+#include "manager/Slot_map.h"
+#include "manager/String.h"
+
+
+namespace {
+
+typedef Slot_map<int>::Handle Handle;
+
+// stands in for Record: owns a String, so can be moved but not copied
+class Item {
+  public:
+    Item(const int in_id, const char* const in_title)
+      : id(in_id) {
+        title.init(in_title);
+    }
+
+    Item(Item&& other)
+      : id(other.id),
+        title(std::move(other.title)) {
+    }
+
+    int id;
+    String title;
+};
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Handles
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Slot_mapUnitTest, EmplaceGet) {
+    Slot_map<int> map;
+    EXPECT_EQ(0, map.size());
+    EXPECT_EQ(0, map.get(Slot_map<int>::null_handle()));
+    EXPECT_FALSE(map.contains(Slot_map<int>::null_handle()));
+
+    const Handle one = map.emplace(1);
+    const Handle two = map.emplace(2);
+    EXPECT_NE(one, two);
+    EXPECT_EQ(2, map.size());
+    ASSERT_TRUE(map.contains(one));
+    EXPECT_EQ(1, *map.get(one));
+    EXPECT_EQ(2, *map.get(two));
+
+    *map.get(two) = 22;
+    const Slot_map<int>& constant = map;
+    EXPECT_EQ(22, *constant.get(two));
+
+    // a Handle from outside the slot table
+    const Handle outside = {99, 1};
+    EXPECT_EQ(0, map.get(outside));
+}
+
+TEST(Slot_mapUnitTest, Erase) {
+    Slot_map<int> map;
+    const Handle one = map.emplace(1);
+    const Handle two = map.emplace(2);
+    const Handle three = map.emplace(3);
+
+    // the last object fills the hole, and keeps its Handle
+    ASSERT_EQ(Slot_map<int>::OK, map.erase(one));
+    EXPECT_EQ(2, map.size());
+    EXPECT_EQ(0, map.get(one));
+    EXPECT_EQ(3, map.data()[0]);
+    EXPECT_EQ(three, map.handle_at(0));
+    EXPECT_EQ(3, *map.get(three));
+    EXPECT_EQ(2, *map.get(two));
+    EXPECT_EQ(Slot_map<int>::ERROR, map.erase(one));
+
+    // the freed slot is reused under a new generation, so the old Handle
+    // stays stale
+    const Handle four = map.emplace(4);
+    EXPECT_EQ(one.slot, four.slot);
+    EXPECT_NE(one, four);
+    EXPECT_EQ(0, map.get(one));
+    EXPECT_EQ(4, *map.get(four));
+
+    // the last object
+    ASSERT_EQ(Slot_map<int>::OK, map.erase(four));
+    ASSERT_EQ(Slot_map<int>::OK, map.erase(two));
+    ASSERT_EQ(Slot_map<int>::OK, map.erase(three));
+    EXPECT_EQ(0, map.size());
+}
+
+TEST(Slot_mapUnitTest, Clear) {
+    Slot_map<int> map;
+    vector<Handle> handles;
+    for (int i = 0; i < 100; i++) {
+        handles.push_back(map.emplace(i));
+    }
+
+    map.clear();
+    EXPECT_EQ(0, map.size());
+    for (size_t i = 0; i < handles.size(); i++) {
+        EXPECT_FALSE(map.contains(handles[i]));
+    }
+
+    // the slots are reused
+    const Handle handle = map.emplace(7);
+    EXPECT_LT(handle.slot, 100);
+    EXPECT_EQ(7, *map.get(handle));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Objects
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Slot_mapUnitTest, Moves) {
+    const int strings = String::get_number();
+    {
+        Slot_map<Item> map;
+        const Slot_map<Item>::Handle alien = map.emplace(1, "Alien");
+        map.reserve(1000);
+        EXPECT_STREQ("Alien", map.get(alien)->title.c_str());
+
+        vector<Slot_map<Item>::Handle> handles;
+        for (int i = 2; i <= 1000; i++) {
+            handles.push_back(map.emplace(i, "The Thing"));
+        }
+        EXPECT_EQ(1000, map.size());
+        EXPECT_STREQ("Alien", map.get(alien)->title.c_str());
+
+        ASSERT_EQ(Slot_map<Item>::OK, map.erase(alien));
+        EXPECT_EQ(1000, map.data()[0].id);
+        EXPECT_STREQ("The Thing", map.data()[0].title.c_str());
+        EXPECT_EQ(999, map.size());
+    }
+    // every String was destroyed exactly once
+    EXPECT_EQ(strings, String::get_number());
+}
+
+TEST(Slot_mapUnitTest, Random) {
+    Slot_map<int> map;
+    std::map<int, Handle> expected;
+    unsigned int seed = 12;
+
+    for (int i = 0; i < 20000; i++) {
+        if ((0 == rand_r(&seed) % 3) && !expected.empty()) {
+            // erase one in the middle
+            std::map<int, Handle>::iterator victim =
+                expected.lower_bound(rand_r(&seed) % i);
+            if (expected.end() == victim) {
+                victim = expected.begin();
+            }
+            ASSERT_EQ(Slot_map<int>::OK, map.erase(victim->second));
+            ASSERT_FALSE(map.contains(victim->second));
+            expected.erase(victim);
+        } else {
+            expected[i] = map.emplace(i);
+        }
+    }
+
+    // every Handle still finds its object, and the objects are contiguous
+    ASSERT_EQ(static_cast<int>(expected.size()), map.size());
+    for (std::map<int, Handle>::const_iterator it = expected.begin();
+         it != expected.end(); ++it) {
+        ASSERT_EQ(it->first, *map.get(it->second));
+    }
+    int64_t total = 0;
+    int64_t scanned = 0;
+    for (std::map<int, Handle>::const_iterator it = expected.begin();
+         it != expected.end(); ++it) {
+        total += it->first;
+    }
+    for (int i = 0; i < map.size(); i++) {
+        scanned += map.data()[i];
+        ASSERT_EQ(map.data()[i], *map.get(map.handle_at(i)));
+    }
+    EXPECT_EQ(total, scanned);
+}
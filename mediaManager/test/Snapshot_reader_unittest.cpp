@@ -0,0 +1,241 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <sstream>
+    using std::stringstream;
+#include <string>
+    using std::string;
+
+#include "gtest/gtest.h"
+
+#include "manager/Snapshot.h"
+#include "manager/Snapshot_reader.h"
+#include "manager/String_view.h"
+
+
+namespace {
+
+const char text_file[] =
+    "3\n"
+    "1 DVD 5 Alien\n"
+    "2 VHS 0 The Thing\n"
+    "7 DVD 3 Tora! Tora! Tora!\n"
+    "2\n"
+    "favorites 2\n"
+    "Alien\n"
+    "Tora! Tora! Tora!\n"
+    "empty 0\n";
+
+string binary_file() {
+    Snapshot snapshot;
+    stringstream in(text_file);
+    snapshot.restore(&in);
+    stringstream out;
+    snapshot.save(&out, Snapshot::BINARY);
+    return out.str();
+}
+
+// read the Records of text_file in one chunk
+void expect_records(Snapshot_reader* reader) {
+    int count;
+    ASSERT_EQ(Snapshot_reader::OK, reader->next_records(&count));
+    ASSERT_EQ(3, count);
+
+    const Snapshot_reader::Record_view& alien = reader->get_record(0);
+    EXPECT_EQ(1, alien.ID);
+    EXPECT_EQ(5, alien.rating);
+    EXPECT_TRUE(String_view("DVD") == alien.medium);
+    EXPECT_TRUE(String_view("Alien") == alien.title);
+    EXPECT_STREQ("Alien", alien.title.data());
+    EXPECT_EQ(2, reader->get_record(1).ID);
+    EXPECT_EQ(0, reader->get_record(1).rating);
+    EXPECT_STREQ("VHS", reader->get_record(1).medium.data());
+    EXPECT_STREQ("The Thing", reader->get_record(1).title.data());
+    EXPECT_EQ(7, reader->get_record(2).ID);
+    EXPECT_STREQ("Tora! Tora! Tora!", reader->get_record(2).title.data());
+
+    ASSERT_EQ(Snapshot_reader::OK, reader->next_records(&count));
+    EXPECT_EQ(0, count);
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Reading
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Snapshot_readerUnitTest, Text) {
+    stringstream in(text_file);
+    Snapshot_reader reader;
+    ASSERT_EQ(Snapshot_reader::OK, reader.open(&in));
+    EXPECT_EQ(Snapshot::TEXT, reader.get_format());
+    EXPECT_EQ(3, reader.get_record_count());
+    expect_records(&reader);
+
+    bool found;
+    ASSERT_EQ(Snapshot_reader::OK, reader.next_collection(&found));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(2, reader.get_collection_count());
+    EXPECT_STREQ("favorites", reader.get_collection_name().data());
+    ASSERT_EQ(2, reader.get_member_count());
+    EXPECT_TRUE(String_view("Alien") == reader.get_member_title(0));
+    EXPECT_TRUE(String_view("Tora! Tora! Tora!") ==
+                reader.get_member_title(1));
+
+    ASSERT_EQ(Snapshot_reader::OK, reader.next_collection(&found));
+    ASSERT_TRUE(found);
+    EXPECT_TRUE(String_view("empty") == reader.get_collection_name());
+    EXPECT_EQ(0, reader.get_member_count());
+
+    ASSERT_EQ(Snapshot_reader::OK, reader.next_collection(&found));
+    EXPECT_FALSE(found);
+}
+
+TEST(Snapshot_readerUnitTest, Binary) {
+    stringstream in(binary_file());
+    Snapshot_reader reader;
+    ASSERT_EQ(Snapshot_reader::OK, reader.open(&in));
+    EXPECT_EQ(Snapshot::BINARY, reader.get_format());
+    EXPECT_EQ(3, reader.get_record_count());
+    expect_records(&reader);
+
+    bool found;
+    ASSERT_EQ(Snapshot_reader::OK, reader.next_collection(&found));
+    ASSERT_TRUE(found);
+    EXPECT_STREQ("favorites", reader.get_collection_name().data());
+    ASSERT_EQ(2, reader.get_member_count());
+    EXPECT_EQ(1, reader.get_member_ID(0));
+    EXPECT_EQ(7, reader.get_member_ID(1));
+
+    ASSERT_EQ(Snapshot_reader::OK, reader.next_collection(&found));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(0, reader.get_member_count());
+    ASSERT_EQ(Snapshot_reader::OK, reader.next_collection(&found));
+    EXPECT_FALSE(found);
+
+    // reading again starts over
+    stringstream again(text_file);
+    ASSERT_EQ(Snapshot_reader::OK, reader.open(&again));
+    EXPECT_EQ(Snapshot::TEXT, reader.get_format());
+    expect_records(&reader);
+}
+
+TEST(Snapshot_readerUnitTest, Chunks) {
+    const int recordCount = 1000;
+    Snapshot snapshot;
+    for (int i = 1; i <= recordCount; i++) {
+        const string title = "Title " + std::to_string(i);
+        snapshot.add_record(i, i % 6, (i % 2) ? "DVD" : "VHS", title.c_str());
+    }
+    snapshot.add_collection("all");
+    for (int i = 1; i <= recordCount; i++) {
+        snapshot.add_member(i);
+    }
+
+    for (int format = Snapshot::TEXT; format <= Snapshot::BINARY; format++) {
+        stringstream file;
+        ASSERT_EQ(Snapshot::OK,
+                  snapshot.save(&file, static_cast<Snapshot::Format>(format)));
+
+        Snapshot_reader reader(64);
+        ASSERT_EQ(Snapshot_reader::OK, reader.open(&file));
+        EXPECT_EQ(64, reader.get_chunk_size());
+
+        // no chunk is larger than asked for, and together they hold every
+        // Record in order
+        int read = 0;
+        int chunks = 0;
+        int count;
+        do {
+            ASSERT_EQ(Snapshot_reader::OK, reader.next_records(&count));
+            ASSERT_LE(count, 64);
+            for (int i = 0; i < count; i++) {
+                const Snapshot_reader::Record_view& record =
+                    reader.get_record(i);
+                read++;
+                ASSERT_EQ(read, record.ID);
+                ASSERT_EQ(read % 6, record.rating);
+                ASSERT_EQ("Title " + std::to_string(read),
+                          string(record.title.data(),
+                                 static_cast<size_t>(record.title.size())));
+            }
+            chunks += (count > 0);
+        } while (count > 0);
+        EXPECT_EQ(recordCount, read);
+        EXPECT_EQ((recordCount + 63) / 64, chunks);
+
+        bool found;
+        ASSERT_EQ(Snapshot_reader::OK, reader.next_collection(&found));
+        ASSERT_TRUE(found);
+        ASSERT_EQ(recordCount, reader.get_member_count());
+        if (Snapshot::TEXT == format) {
+            EXPECT_STREQ("Title 1000", reader.get_member_title(999).data());
+        } else {
+            EXPECT_EQ(1000, reader.get_member_ID(999));
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Errors
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Snapshot_readerUnitTest, Invalid) {
+    const char* const files[] = {
+        "",
+        "x\n",
+        "-1\n",
+        "1\n1 DVD 5\n0\n",                      // no title
+        "1\n1 DVD 6 Alien\n0\n",                // rating out of range
+        "1\n0 DVD 5 Alien\n0\n",                // ID not positive
+        "2\n1 DVD 5 Alien\n",                   // truncated
+        "1\n1 DVD 5 Alien\n1\nfavorites 2\nAlien\n",   // missing member
+        "1\n1 DVD 5 Alien\nx\n",                // no Collection count
+    };
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        stringstream in(files[i]);
+        Snapshot_reader reader;
+        Snapshot_reader::Status status = reader.open(&in);
+        int count = 1;
+        while ((Snapshot_reader::OK == status) && (count > 0)) {
+            status = reader.next_records(&count);
+        }
+        bool found = true;
+        while ((Snapshot_reader::OK == status) && found) {
+            status = reader.next_collection(&found);
+        }
+        EXPECT_EQ(Snapshot_reader::ERROR, status) << files[i];
+    }
+
+    // every truncation of a binary file fails somewhere
+    const string binary = binary_file();
+    for (size_t length = 0; length < binary.size(); length++) {
+        stringstream in(binary.substr(0, length));
+        Snapshot_reader reader(2);
+        Snapshot_reader::Status status = reader.open(&in);
+        int count = 1;
+        while ((Snapshot_reader::OK == status) && (count > 0)) {
+            status = reader.next_records(&count);
+        }
+        bool found = true;
+        while ((Snapshot_reader::OK == status) && found) {
+            status = reader.next_collection(&found);
+        }
+        ASSERT_EQ(Snapshot_reader::ERROR, status) << length;
+    }
+
+    // the Collections follow the Records
+    stringstream in(text_file);
+    Snapshot_reader reader;
+    ASSERT_EQ(Snapshot_reader::OK, reader.open(&in));
+    bool found;
+    EXPECT_EQ(Snapshot_reader::ERROR, reader.next_collection(&found));
+    EXPECT_FALSE(found);
+}
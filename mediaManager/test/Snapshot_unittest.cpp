@@ -0,0 +1,417 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <atomic>  // NOLINT(build/include_order)
+#include <cstring>
+#include <sstream>
+    using std::stringstream;
+#include <string>
+    using std::string;
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "manager/InternedString.h"
+#include "manager/Snapshot.h"
+#include "manager/String.h"
+#include "manager/Utility.h"
+
+
+namespace {
+
+const char text_file[] =
+    "3\n"
+    "1 DVD 5 Alien\n"
+    "2 VHS 0 The Thing\n"
+    "7 DVD 3 Tora! Tora! Tora!\n"
+    "2\n"
+    "favorites 2\n"
+    "Alien\n"
+    "Tora! Tora! Tora!\n"
+    "empty 0\n";
+
+// the Records and Collections of text_file
+void fill(Snapshot* snapshot) {
+    snapshot->add_record(1, 5, "DVD", "Alien");
+    snapshot->add_record(2, 0, "VHS", "The Thing");
+    snapshot->add_record(7, 3, "DVD", "Tora! Tora! Tora!");
+    snapshot->add_collection("favorites");
+    snapshot->add_member(1);
+    snapshot->add_member(7);
+    snapshot->add_collection("empty");
+}
+
+void expect_filled(const Snapshot& snapshot) {
+    ASSERT_EQ(3, snapshot.get_record_count());
+    EXPECT_EQ(1, snapshot.get_record(0).ID);
+    EXPECT_EQ(5, snapshot.get_record(0).rating);
+    EXPECT_STREQ("DVD", snapshot.get_record(0).medium.c_str());
+    EXPECT_STREQ("Alien", snapshot.get_record(0).title.c_str());
+    EXPECT_EQ(2, snapshot.get_record(1).ID);
+    EXPECT_EQ(0, snapshot.get_record(1).rating);
+    EXPECT_STREQ("VHS", snapshot.get_record(1).medium.c_str());
+    EXPECT_STREQ("The Thing", snapshot.get_record(1).title.c_str());
+    EXPECT_EQ(7, snapshot.get_record(2).ID);
+    EXPECT_STREQ("Tora! Tora! Tora!", snapshot.get_record(2).title.c_str());
+
+    // one interned medium shared by both DVDs
+    EXPECT_TRUE(snapshot.get_record(0).medium ==
+                snapshot.get_record(2).medium);
+
+    ASSERT_EQ(2, snapshot.get_collection_count());
+    const Snapshot::Collection_data& favorites = snapshot.get_collection(0);
+    EXPECT_STREQ("favorites", favorites.name.c_str());
+    ASSERT_EQ(2, favorites.member_count);
+    EXPECT_EQ(1, snapshot.get_members(favorites)[0]);
+    EXPECT_EQ(7, snapshot.get_members(favorites)[1]);
+    EXPECT_STREQ("empty", snapshot.get_collection(1).name.c_str());
+    EXPECT_EQ(0, snapshot.get_collection(1).member_count);
+}
+
+string binary_file() {
+    Snapshot snapshot;
+    fill(&snapshot);
+    stringstream out;
+    snapshot.save(&out, Snapshot::BINARY);
+    return out.str();
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Save / Restore
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(SnapshotUnitTest, SaveText) {
+    Snapshot snapshot;
+    fill(&snapshot);
+
+    stringstream out;
+    EXPECT_EQ(Snapshot::OK, snapshot.save(&out, Snapshot::TEXT));
+    EXPECT_EQ(text_file, out.str());
+}
+
+TEST(SnapshotUnitTest, RestoreText) {
+    stringstream in(text_file);
+    Snapshot snapshot;
+    EXPECT_EQ(Snapshot::OK, snapshot.restore(&in));
+    expect_filled(snapshot);
+}
+
+TEST(SnapshotUnitTest, BinaryRoundTrip) {
+    const string binary = binary_file();
+    EXPECT_EQ(0, memcmp("\x89MMS", binary.data(), 4));
+
+    stringstream in(binary);
+    Snapshot snapshot;
+    EXPECT_EQ(Snapshot::OK, snapshot.restore(&in));
+    expect_filled(snapshot);
+
+    // saving again gives the same bytes
+    stringstream out;
+    EXPECT_EQ(Snapshot::OK, snapshot.save(&out, Snapshot::BINARY));
+    EXPECT_EQ(binary, out.str());
+}
+
+TEST(SnapshotUnitTest, Empty) {
+    Snapshot snapshot;
+    stringstream text;
+    stringstream binary;
+    EXPECT_EQ(Snapshot::OK, snapshot.save(&text, Snapshot::TEXT));
+    EXPECT_EQ(Snapshot::OK, snapshot.save(&binary, Snapshot::BINARY));
+    EXPECT_EQ("0\n0\n", text.str());
+
+    snapshot.add_record(1, 0, "", "x");
+    EXPECT_EQ(Snapshot::OK, snapshot.restore(&binary));
+    EXPECT_EQ(0, snapshot.get_record_count());
+    EXPECT_EQ(0, snapshot.get_collection_count());
+}
+
+// restoring over a snapshot replaces it, and no Strings are leaked or lost
+TEST(SnapshotUnitTest, RestoreReplaces) {
+    const int strings = String::get_number();
+    {
+        Snapshot snapshot;
+        snapshot.add_record(99, 1, "LP", "Abbey Road");
+        snapshot.add_collection("vinyl");
+        snapshot.add_member(99);
+
+        stringstream in(text_file);
+        EXPECT_EQ(Snapshot::OK, snapshot.restore(&in));
+        expect_filled(snapshot);
+    }
+    EXPECT_EQ(strings, String::get_number());
+    EXPECT_EQ(0, InternedString::get_pool_size());
+}
+
+TEST(SnapshotUnitTest, Grow) {
+    const int count = 1000;
+    Snapshot snapshot;
+    snapshot.add_collection("all");
+    for (int i = 1; i <= count; i++) {
+        std::ostringstream title;
+        title << "Title number " << i;
+        snapshot.add_record(i, i % 6, (i % 2) ? "DVD" : "Blu-ray",
+                            title.str().c_str());
+        snapshot.add_member(i);
+    }
+
+    stringstream binary;
+    ASSERT_EQ(Snapshot::OK, snapshot.save(&binary, Snapshot::BINARY));
+    Snapshot restored;
+    ASSERT_EQ(Snapshot::OK, restored.restore(&binary));
+
+    ASSERT_EQ(count, restored.get_record_count());
+    EXPECT_STREQ("Title number 1000",
+                 restored.get_record(count - 1).title.c_str());
+    EXPECT_STREQ("Blu-ray", restored.get_record(count - 1).medium.c_str());
+    EXPECT_EQ(count, restored.get_collection(0).member_count);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Parallel restore
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(SnapshotUnitTest, RestoreParallel) {
+    const string text = text_file;
+    for (int threads = 1; threads <= 8; threads++) {
+        Snapshot snapshot;
+        std::atomic<int> ID_counter(3);
+        ASSERT_EQ(Snapshot::OK,
+                  snapshot.restore_parallel(text.data(), text.size(), threads,
+                                            &ID_counter)) << threads;
+        expect_filled(snapshot);
+        EXPECT_EQ(7, ID_counter.load());
+
+        // the counter is never lowered
+        ID_counter = 10;
+        ASSERT_EQ(Snapshot::OK,
+                  snapshot.restore_parallel(text.data(), text.size(), threads,
+                                            &ID_counter));
+        EXPECT_EQ(10, ID_counter.load());
+    }
+
+    // a binary file is restored too
+    const string binary = binary_file();
+    Snapshot snapshot;
+    std::atomic<int> ID_counter(0);
+    ASSERT_EQ(Snapshot::OK,
+              snapshot.restore_parallel(binary.data(), binary.size(), 4,
+                                        &ID_counter));
+    expect_filled(snapshot);
+    EXPECT_EQ(7, ID_counter.load());
+
+    // no Records
+    ASSERT_EQ(Snapshot::OK, snapshot.restore_parallel("0\n0\n", 4, 3, 0));
+    EXPECT_EQ(0, snapshot.get_record_count());
+}
+
+// the same Records and Collections however the file is split
+TEST(SnapshotUnitTest, RestoreParallelLarge) {
+    const int count = 1000;
+    Snapshot snapshot;
+    for (int i = 1; i <= count; i++) {
+        std::ostringstream title;
+        title << "Title number " << i;
+        snapshot.add_record(i, i % 6, (i % 3) ? "DVD" : "Blu-ray",
+                            title.str().c_str());
+        if (1 == i % 100) {
+            snapshot.add_collection(title.str().substr(13).c_str());
+        }
+        snapshot.add_member(i);
+    }
+    stringstream file;
+    ASSERT_EQ(Snapshot::OK, snapshot.save(&file, Snapshot::TEXT));
+    const string text = file.str();
+
+    const int threads[] = {1, 2, 3, 7, 16, 2000};
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        Snapshot restored;
+        ASSERT_EQ(Snapshot::OK,
+                  restored.restore_parallel(text.data(), text.size(),
+                                            threads[t], 0)) << threads[t];
+        stringstream out;
+        ASSERT_EQ(Snapshot::OK, restored.save(&out, Snapshot::TEXT));
+        EXPECT_EQ(text, out.str()) << threads[t];
+    }
+}
+
+// many threads raising the same counter leave it at the largest value
+TEST(SnapshotUnitTest, IDCounter) {
+    std::atomic<int> ID_counter(0);
+    std::thread threads[8];
+    for (int t = 0; t < 8; t++) {
+        threads[t] = std::thread([&ID_counter, t]() {
+            for (int i = 0; i < 10000; i++) {
+                atomic_max(&ID_counter, (i * 8 + t) % 50000);
+            }
+        });
+    }
+    for (int t = 0; t < 8; t++) {
+        threads[t].join();
+    }
+    EXPECT_EQ(49999, ID_counter.load());
+}
+
+TEST(SnapshotUnitTest, InvalidParallel) {
+    const char* const files[] = {
+        "",
+        "x\n",
+        "1\n1 DVD 5\n0\n",                      // no title
+        "1\n1 DVD 6 Alien\n0\n",                // rating out of range
+        "2\n1 DVD 5 Alien\n1 VHS 0 Aliens\n0\n",  // duplicate ID
+        "1\n1 DVD 5 Alien\n1\nfavorites 1\nAliens\n",  // unknown member
+        "2\n1 DVD 5 Alien\n",                   // truncated
+        "2\n1 DVD 5 Alien\n2 VHS 0 Aliens\n",   // no Collection count
+        "1\n1 DVD\n5 Alien\n0\n",              // a Record over two lines
+    };
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        for (int threads = 1; threads <= 4; threads++) {
+            Snapshot snapshot;
+            std::atomic<int> ID_counter(0);
+            EXPECT_EQ(Snapshot::ERROR,
+                      snapshot.restore_parallel(files[i], strlen(files[i]),
+                                                threads, &ID_counter))
+                << files[i];
+            EXPECT_EQ(0, snapshot.get_record_count());
+            EXPECT_EQ(0, ID_counter.load());
+        }
+    }
+}
+
+// restore() and restore_parallel() accept the same files, with the same
+// result
+TEST(SnapshotUnitTest, RestoreParallelAgrees) {
+    std::vector<string> files = {
+        text_file,
+        "2\n1 DVD 5 Alien\n\n2 VHS 3 Vertigo\n0\n",   // blank line
+        "2\n\n \t\n1 DVD 5 Alien\n2 VHS 3 Vertigo\n\n0\n",
+        "1\n  1  DVD\t5   Alien \n0\n",              // spaces around fields
+        "1\n1 DVD\n5 Alien\n0\n",                    // a Record over two lines
+        "1\n1\nDVD 5 Alien\n0\n",
+        "1 1 DVD 5 Alien\n0\n",                      // a Record after the count
+        "1\n1 DVD 5 Alien\n",                        // no Collection count
+        "0\n0\n",
+    };
+
+    // large enough to be split, with blank lines scattered through it
+    std::ostringstream large;
+    large << "500\n";
+    for (int i = 1; i <= 500; i++) {
+        large << ((0 == i % 7) ? "\n" : "") << ((0 == i % 11) ? "  \n" : "")
+              << i << " DVD " << i % 6 << " Title number " << i << "\n";
+    }
+    large << "\n1\nfavorites 1\nTitle number 42\n";
+    files.push_back(large.str());
+
+    for (size_t i = 0; i < files.size(); i++) {
+        stringstream in(files[i]);
+        Snapshot expected;
+        const Snapshot::Status status = expected.restore(&in);
+        stringstream expectedText;
+        if (Snapshot::OK == status) {
+            ASSERT_EQ(Snapshot::OK, expected.save(&expectedText,
+                                                  Snapshot::TEXT));
+        }
+
+        for (int threads = 1; threads <= 4; threads++) {
+            Snapshot snapshot;
+            EXPECT_EQ(status,
+                      snapshot.restore_parallel(files[i].data(),
+                                                files[i].size(), threads, 0))
+                << files[i] << threads;
+            stringstream text;
+            if (Snapshot::OK == status) {
+                ASSERT_EQ(Snapshot::OK, snapshot.save(&text, Snapshot::TEXT));
+            }
+            EXPECT_EQ(expectedText.str(), text.str()) << files[i] << threads;
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Convert
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(SnapshotUnitTest, Convert) {
+    stringstream text(text_file);
+    stringstream binary;
+    EXPECT_EQ(Snapshot::OK,
+              Snapshot::convert(&text, &binary, Snapshot::BINARY));
+    EXPECT_EQ(binary_file(), binary.str());
+
+    stringstream back;
+    EXPECT_EQ(Snapshot::OK, Snapshot::convert(&binary, &back, Snapshot::TEXT));
+    EXPECT_EQ(text_file, back.str());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Errors
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(SnapshotUnitTest, InvalidText) {
+    const char* const files[] = {
+        "",
+        "x\n",
+        "1\n1 DVD 5\n0\n",                      // no title
+        "1\n1 DVD 6 Alien\n0\n",                // rating out of range
+        "2\n1 DVD 5 Alien\n1 VHS 0 Aliens\n0\n",  // duplicate ID
+        "1\n0 DVD 5 Alien\n0\n",                // ID not positive
+        "1\n1 DVD 5 Alien\n1\nfavorites 1\nAliens\n",  // unknown member
+        "1\n1 DVD 5 Alien\n1\nfavorites 2\nAlien\n",   // missing member
+        "2\n1 DVD 5 Alien\n",                   // truncated
+    };
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        stringstream in(files[i]);
+        Snapshot snapshot;
+        EXPECT_EQ(Snapshot::ERROR, snapshot.restore(&in)) << files[i];
+        EXPECT_EQ(0, snapshot.get_record_count());
+        EXPECT_EQ(0, snapshot.get_collection_count());
+    }
+}
+
+TEST(SnapshotUnitTest, InvalidBinary) {
+    const string binary = binary_file();
+
+    // every truncation fails
+    for (size_t length = 1; length < binary.size(); length++) {
+        stringstream in(binary.substr(0, length));
+        Snapshot snapshot;
+        ASSERT_EQ(Snapshot::ERROR, snapshot.restore(&in)) << length;
+        ASSERT_EQ(0, snapshot.get_record_count());
+    }
+
+    // wrong magic
+    string bad = binary;
+    bad[1] = 'X';
+    stringstream bad_magic(bad);
+    Snapshot snapshot;
+    EXPECT_EQ(Snapshot::ERROR, snapshot.restore(&bad_magic));
+
+    // unknown version
+    bad = binary;
+    bad[4] = static_cast<char>(Snapshot::ourVersion + 1);
+    stringstream bad_version(bad);
+    EXPECT_EQ(Snapshot::ERROR, snapshot.restore(&bad_version));
+
+    // a member that is not a Record cannot be saved
+    Snapshot unknown_member;
+    fill(&unknown_member);
+    unknown_member.add_member(8);
+    stringstream out;
+    EXPECT_EQ(Snapshot::ERROR, unknown_member.save(&out, Snapshot::BINARY));
+    EXPECT_EQ(Snapshot::ERROR, unknown_member.save(&out, Snapshot::TEXT));
+}
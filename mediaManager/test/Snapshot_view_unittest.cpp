@@ -0,0 +1,219 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+    using std::stringstream;
+#include <string>
+    using std::string;
+
+#include "gtest/gtest.h"
+
+#include "manager/Mapped_file.h"
+#include "manager/Snapshot.h"
+#include "manager/Snapshot_view.h"
+#include "manager/String.h"
+#include "manager/String_view.h"
+
+
+namespace {
+
+string binary_file() {
+    Snapshot snapshot;
+    snapshot.add_record(1, 5, "DVD", "Alien");
+    snapshot.add_record(2, 0, "VHS", "The Thing");
+    snapshot.add_record(7, 3, "DVD", "Tora! Tora! Tora!");
+    snapshot.add_collection("favorites");
+    snapshot.add_member(1);
+    snapshot.add_member(7);
+    snapshot.add_collection("empty");
+
+    stringstream out;
+    snapshot.save(&out, Snapshot::BINARY);
+    return out.str();
+}
+
+void expect_contents(const Snapshot_view& view) {
+    ASSERT_EQ(3, view.get_record_count());
+    EXPECT_EQ(1, view.get_record(0).ID);
+    EXPECT_EQ(5, view.get_record(0).rating);
+    EXPECT_TRUE(String_view("DVD") == view.get_record(0).medium);
+    EXPECT_TRUE(String_view("Alien") == view.get_record(0).title);
+    EXPECT_EQ(2, view.get_record(1).ID);
+    EXPECT_EQ(0, view.get_record(1).rating);
+    EXPECT_TRUE(String_view("VHS") == view.get_record(1).medium);
+    EXPECT_TRUE(String_view("The Thing") == view.get_record(1).title);
+    EXPECT_EQ(7, view.get_record(2).ID);
+    EXPECT_TRUE(String_view("Tora! Tora! Tora!") == view.get_record(2).title);
+
+    // both DVDs refer to the one copy in the string table
+    EXPECT_EQ(view.get_record(0).medium.data(),
+              view.get_record(2).medium.data());
+
+    ASSERT_EQ(2, view.get_collection_count());
+    const Snapshot_view::Collection_view& favorites = view.get_collection(0);
+    EXPECT_TRUE(String_view("favorites") == favorites.name);
+    ASSERT_EQ(2, favorites.member_count);
+    EXPECT_EQ(1, Snapshot_view::get_member(favorites, 0));
+    EXPECT_EQ(7, Snapshot_view::get_member(favorites, 1));
+    EXPECT_TRUE(String_view("empty") == view.get_collection(1).name);
+    EXPECT_EQ(0, view.get_collection(1).member_count);
+}
+
+// a file in the temporary directory, removed when done
+class Temporary_file {
+  public:
+    explicit Temporary_file(const string& contents) {
+        char name[] = "/tmp/Snapshot_view_unittest.XXXXXX";
+        const int fd = mkstemp(name);
+        path = name;
+        if (-1 != fd) {
+            const ssize_t written = write(fd, contents.data(), contents.size());
+            EXPECT_EQ(static_cast<ssize_t>(contents.size()), written);
+            close(fd);
+        }
+    }
+
+    ~Temporary_file() {
+        remove(path.c_str());
+    }
+
+    string path;
+};
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// String_view
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Snapshot_viewUnitTest, StringView) {
+    const char text[] = "Alien Aliens";
+    const String_view alien(text, 5);
+    const String_view aliens(text + 6, 6);
+    String str;
+    str.init("Alien");
+
+    EXPECT_EQ(5, alien.size());
+    EXPECT_FALSE(alien.empty());
+    EXPECT_TRUE(String_view().empty());
+    EXPECT_TRUE(String_view("") == String_view());
+
+    EXPECT_TRUE(alien == String_view(str));
+    EXPECT_TRUE(alien != aliens);
+    EXPECT_TRUE(alien < aliens);
+    EXPECT_FALSE(aliens < alien);
+    EXPECT_FALSE(alien < alien);
+    EXPECT_GT(0, alien.compare(aliens));
+    EXPECT_LT(0, aliens.compare(alien));
+    EXPECT_EQ(0, alien.compare(String_view("Alien")));
+    EXPECT_TRUE(String_view("Alien") < String_view("Alien\x80"));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Attach / Open
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Snapshot_viewUnitTest, Attach) {
+    const string binary = binary_file();
+    Snapshot_view view;
+    EXPECT_EQ(0, view.get_record_count());
+
+    ASSERT_EQ(Snapshot_view::OK, view.attach(binary.data(), binary.size()));
+    expect_contents(view);
+
+    // the titles are not copied
+    const char* const title = view.get_record(1).title.data();
+    EXPECT_TRUE((title > binary.data()) &&
+                (title < binary.data() + binary.size()));
+
+    view.close();
+    EXPECT_EQ(0, view.get_record_count());
+    EXPECT_EQ(0, view.get_collection_count());
+}
+
+TEST(Snapshot_viewUnitTest, Open) {
+    const Temporary_file file(binary_file());
+
+    Snapshot_view view;
+    ASSERT_EQ(Snapshot_view::OK, view.open(file.path.c_str()));
+    expect_contents(view);
+
+    // reopening replaces the contents
+    ASSERT_EQ(Snapshot_view::OK, view.open(file.path.c_str()));
+    expect_contents(view);
+}
+
+TEST(Snapshot_viewUnitTest, MappedFile) {
+    const Temporary_file file("contents");
+    const Temporary_file empty("");
+
+    Mapped_file mapped;
+    EXPECT_FALSE(mapped.is_open());
+    ASSERT_EQ(Mapped_file::OK, mapped.open(file.path.c_str()));
+    EXPECT_TRUE(mapped.is_open());
+    ASSERT_EQ(8U, mapped.size());
+    EXPECT_EQ(string("contents"), string(mapped.data(), mapped.size()));
+
+    ASSERT_EQ(Mapped_file::OK, mapped.open(empty.path.c_str()));
+    EXPECT_TRUE(mapped.is_open());
+    EXPECT_EQ(0U, mapped.size());
+
+    mapped.close();
+    EXPECT_FALSE(mapped.is_open());
+    EXPECT_EQ(Mapped_file::ERROR, mapped.open("/nonexistent/snapshot"));
+    EXPECT_FALSE(mapped.is_open());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Errors
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Snapshot_viewUnitTest, Invalid) {
+    const string binary = binary_file();
+    Snapshot_view view;
+
+    // every truncation fails
+    for (size_t length = 0; length < binary.size(); length++) {
+        ASSERT_EQ(Snapshot_view::ERROR, view.attach(binary.data(), length))
+            << length;
+        ASSERT_EQ(0, view.get_record_count());
+    }
+
+    // text format
+    const string text = "1\n1 DVD 5 Alien\n0\n";
+    EXPECT_EQ(Snapshot_view::ERROR, view.attach(text.data(), text.size()));
+
+    // unknown version
+    string bad = binary;
+    bad[4] = static_cast<char>(Snapshot::ourVersion + 1);
+    EXPECT_EQ(Snapshot_view::ERROR, view.attach(bad.data(), bad.size()));
+
+    // a Record count far larger than the file
+    bad = binary;
+    const size_t records = binary.find("Alien") - 4 - 4 - 1 - 4 - 4;
+    bad[records + 3] = '\x10';
+    EXPECT_EQ(Snapshot_view::ERROR, view.attach(bad.data(), bad.size()));
+
+    // a rating out of range
+    bad = binary;
+    bad[binary.find("Alien") - 4 - 4 - 1] = 6;
+    EXPECT_EQ(Snapshot_view::ERROR, view.attach(bad.data(), bad.size()));
+
+    // missing or empty files
+    EXPECT_EQ(Snapshot_view::ERROR, view.open("/nonexistent/snapshot"));
+    const Temporary_file empty("");
+    EXPECT_EQ(Snapshot_view::ERROR, view.open(empty.path.c_str()));
+    EXPECT_EQ(0, view.get_record_count());
+}
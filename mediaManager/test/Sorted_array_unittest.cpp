@@ -0,0 +1,392 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <cstdlib>
+#include <string>
+    using std::string;
+
+#include "gtest/gtest.h"
+
+#include "manager/globals.h"
+#include "manager/Ordered_list.h"
+#include "manager/Sorted_array.h"
+
+
+// To use a test fixture, derive a class from testing::Test.
+class Sorted_arrayUnitTest : public testing::Test {
+  protected:
+    // every test starts and must finish with no lists or nodes alive
+    virtual void SetUp() {
+        ASSERT_EQ(0, g_Ordered_list_count);
+        ASSERT_EQ(0, g_Ordered_list_Node_count);
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(0, g_Ordered_list_count);
+        EXPECT_EQ(0, g_Ordered_list_Node_count);
+    }
+};
+
+
+namespace {
+
+// an item whose ordering ignores its tag, to check where equal items go
+struct Tagged {
+    Tagged()
+      : key(0), tag(0) {
+    }
+
+    Tagged(const int in_key, const int in_tag)
+      : key(in_key), tag(in_tag) {
+    }
+
+    bool operator< (const Tagged& rhs) const {
+        return key < rhs.key;
+    }
+
+    int key;
+    int tag;
+};
+
+typedef Ordered_list<int, Sorted_array_storage> Int_list;
+typedef Ordered_list<Tagged, Sorted_array_storage> Tagged_list;
+
+bool greater_than(const int& a, const int& b) {
+    return a > b;
+}
+
+// a function object ordering
+struct Greater {
+    bool operator() (const int& a, const int& b) const {
+        return a > b;
+    }
+};
+
+void add_to(const int& i, int* total) {
+    *total += i;
+}
+
+bool is_equal(const int& i, int probe) {
+    return i == probe;
+}
+
+// render an int list as "1 2 3" for easy comparison
+template<typename List>
+string to_string(const List& list) {
+    string result;
+    for (typename List::Iterator it = list.begin(); it != list.end(); ++it) {
+        if (!result.empty()) {
+            result += ' ';
+        }
+        result += static_cast<char>('0' + *it);
+    }
+    return result;
+}
+
+// true if both lists hold the same tags in the same order
+bool same_order(const Tagged_list& array, const Ordered_list<Tagged>& plain) {
+    Tagged_list::Iterator s = array.begin();
+    Ordered_list<Tagged>::Iterator p = plain.begin();
+    for (; (s != array.end()) && (p != plain.end()); ++s, ++p) {
+        if (s->tag != p->tag) {
+            return false;
+        }
+    }
+    return (s == array.end()) && (p == plain.end());
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Insert / Find / Erase
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Sorted_arrayUnitTest, Insert) {
+    Int_list list;
+    EXPECT_TRUE(list.empty());
+    EXPECT_TRUE(list.begin() == list.end());
+
+    list.insert(5);
+    list.insert(1);
+    list.insert(9);
+    list.insert(3);
+
+    EXPECT_EQ(4, list.size());
+    EXPECT_EQ("1 3 5 9", to_string(list));
+    EXPECT_EQ(1, g_Ordered_list_count);
+    // there are no nodes to count
+    EXPECT_EQ(0, g_Ordered_list_Node_count);
+
+    Int_list reversed(greater_than);
+    reversed.insert(1);
+    reversed.insert(3);
+    reversed.insert(2);
+    EXPECT_EQ("3 2 1", to_string(reversed));
+}
+
+TEST_F(Sorted_arrayUnitTest, Find) {
+    Tagged_list list;
+    list.insert(Tagged(1, 'a'));
+    list.insert(Tagged(3, 'b'));
+    list.insert(Tagged(3, 'c'));
+
+    Tagged_list::Iterator it = list.find(Tagged(3, 'x'));
+    ASSERT_TRUE(it != list.end());
+    EXPECT_EQ('c', it->tag);
+
+    EXPECT_TRUE(list.end() == list.find(Tagged(0, 'x')));
+    EXPECT_TRUE(list.end() == list.find(Tagged(2, 'x')));
+    EXPECT_TRUE(list.end() == list.find(Tagged(4, 'x')));
+}
+
+TEST_F(Sorted_arrayUnitTest, Erase) {
+    Int_list list;
+    for (int i = 1; i <= 5; i++) {
+        list.insert(i);
+    }
+
+    list.erase(list.find(3));
+    EXPECT_EQ("1 2 4 5", to_string(list));
+    list.erase(list.begin());
+    list.erase(list.find(5));
+    EXPECT_EQ("2 4", to_string(list));
+
+    list.erase(list.begin());
+    list.erase(list.begin());
+    EXPECT_TRUE(list.empty());
+
+    list.insert(7);
+    EXPECT_EQ("7", to_string(list));
+}
+
+// insert, find and erase a large number of items with many duplicates and
+// check the result always matches the plain list
+TEST_F(Sorted_arrayUnitTest, MatchesPlainList) {
+    Tagged_list array;
+    Ordered_list<Tagged> plain;
+
+    unsigned int seed = 381;
+    for (int i = 0; i < 2000; i++) {
+        const Tagged item(rand_r(&seed) % 100, i);
+        array.insert(item);
+        plain.insert(item);
+    }
+    EXPECT_EQ(plain.size(), array.size());
+    EXPECT_TRUE(same_order(array, plain));
+
+    for (int key = -1; key <= 100; key++) {
+        Tagged_list::Iterator s = array.find(Tagged(key, 0));
+        Ordered_list<Tagged>::Iterator p = plain.find(Tagged(key, 0));
+        ASSERT_EQ(p == plain.end(), s == array.end());
+        if (p != plain.end()) {
+            EXPECT_EQ(p->tag, s->tag);
+        }
+    }
+
+    // erase an item from the middle of each run of equal items
+    for (int i = 0; i < 1500; i++) {
+        const Tagged probe(rand_r(&seed) % 100, 0);
+        Tagged_list::Iterator s = array.find(probe);
+        Ordered_list<Tagged>::Iterator p = plain.find(probe);
+        if (s == array.end()) {
+            continue;
+        }
+        for (int skips = i % 3; skips > 0; skips--) {
+            Tagged_list::Iterator s_next = s;
+            Ordered_list<Tagged>::Iterator p_next = p;
+            ++s_next;
+            ++p_next;
+            if ((s_next == array.end()) || (s_next->key != probe.key)) {
+                break;
+            }
+            s = s_next;
+            p = p_next;
+        }
+        array.erase(s);
+        plain.erase(p);
+    }
+    EXPECT_EQ(plain.size(), array.size());
+    EXPECT_TRUE(same_order(array, plain));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// InsertRange
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Sorted_arrayUnitTest, InsertRange) {
+    const int batch[] = {5, 1, 9, 3};
+
+    Int_list list;
+    list.insert_range(batch, batch);
+    EXPECT_TRUE(list.empty());
+
+    list.insert_range(batch, batch + 4);
+    EXPECT_EQ("1 3 5 9", to_string(list));
+
+    list.insert_range(batch + 1, batch + 3);
+    EXPECT_EQ("1 1 3 5 9 9", to_string(list));
+    EXPECT_EQ(1, *list.find(1));
+}
+
+TEST_F(Sorted_arrayUnitTest, RangeConstructor) {
+    const int batch[] = {5, 1, 9, 3};
+
+    Int_list list(batch, batch + 4);
+    EXPECT_EQ("1 3 5 9", to_string(list));
+
+    Int_list reversed(list.begin(), list.end(), greater_than);
+    EXPECT_EQ("9 5 3 1", to_string(reversed));
+}
+
+// a batch, with duplicates within it and against the list, ends up exactly
+// as if it were inserted one item at a time
+TEST_F(Sorted_arrayUnitTest, InsertRangeMatchesInsert) {
+    Tagged_list array;
+    Ordered_list<Tagged> plain;
+
+    unsigned int seed = 381;
+    for (int i = 0; i < 200; i++) {
+        const Tagged item(rand_r(&seed) % 50, i);
+        array.insert(item);
+        plain.insert(item);
+    }
+
+    Tagged* const batch = new Tagged[1000 - 200];
+    for (int i = 200; i < 1000; i++) {
+        batch[i - 200] = Tagged(rand_r(&seed) % 50, i);
+        plain.insert(batch[i - 200]);
+    }
+    array.insert_range(batch, batch + (1000 - 200));
+    delete [] batch;
+
+    EXPECT_EQ(plain.size(), array.size());
+    EXPECT_TRUE(same_order(array, plain));
+}
+
+TEST_F(Sorted_arrayUnitTest, InsertRangeFromList) {
+    Ordered_list<int> source(greater_than);
+    source.insert(2);
+    source.insert(7);
+
+    Int_list list;
+    list.insert(4);
+    list.insert_range(source.begin(), source.end());
+    EXPECT_EQ("2 4 7", to_string(list));
+}
+
+
+TEST_F(Sorted_arrayUnitTest, LowerBound) {
+    Tagged_list list;
+    EXPECT_TRUE(list.end() == list.lower_bound(Tagged(1, 'x')));
+
+    list.insert(Tagged(1, 'a'));
+    list.insert(Tagged(3, 'b'));
+    list.insert(Tagged(3, 'c'));
+
+    EXPECT_EQ('a', list.lower_bound(Tagged(0, 'x'))->tag);
+    EXPECT_EQ('a', list.lower_bound(Tagged(1, 'x'))->tag);
+    EXPECT_EQ('c', list.lower_bound(Tagged(2, 'x'))->tag);
+    EXPECT_EQ('c', list.lower_bound(Tagged(3, 'x'))->tag);
+    EXPECT_TRUE(list.end() == list.lower_bound(Tagged(4, 'x')));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copy / Assign / Swap / Clear
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Sorted_arrayUnitTest, CopyAndAssign) {
+    Int_list a(greater_than);
+    for (int i = 0; i < 10; i++) {
+        a.insert(i);
+    }
+
+    Int_list b(a);
+    EXPECT_EQ(to_string(a), to_string(b));
+
+    // the copy is searchable and keeps the ordering function
+    EXPECT_EQ(7, *b.find(7));
+    b.erase(b.find(7));
+    b.insert(7);
+    EXPECT_EQ(to_string(a), to_string(b));
+
+    Int_list c;
+    c.insert(1);
+    c = a;
+    EXPECT_EQ(to_string(a), to_string(c));
+    c = c;
+    EXPECT_EQ(to_string(a), to_string(c));
+}
+
+TEST_F(Sorted_arrayUnitTest, SwapAndClear) {
+    Int_list a;
+    a.insert(1);
+    Int_list b(greater_than);
+    b.insert(2);
+    b.insert(3);
+
+    a.swap(b);
+    a.insert(4);
+    b.insert(0);
+    EXPECT_EQ("4 3 2", to_string(a));
+    EXPECT_EQ("0 1", to_string(b));
+
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(0, a.size());
+    EXPECT_TRUE(a.begin() == a.end());
+    EXPECT_TRUE(a.end() == a.find(3));
+
+    // the array is reused after a clear
+    a.insert(5);
+    EXPECT_EQ("5", to_string(a));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Ordering
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Sorted_arrayUnitTest, OrderingFunctionObject) {
+    const int batch[] = {5, 1, 9, 3};
+
+    Ordered_list<int, Sorted_array_storage, Greater> list(batch, batch + 4);
+    list.insert(4);
+    EXPECT_EQ("9 5 4 3 1", to_string(list));
+    EXPECT_EQ(4, *list.find(4));
+    list.erase(list.find(4));
+    EXPECT_TRUE(list.end() == list.find(4));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Apply
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(Sorted_arrayUnitTest, Apply) {
+    Int_list list;
+    list.insert(1);
+    list.insert(2);
+    list.insert(3);
+
+    int total = 0;
+    list.apply_arg(add_to, &total);
+    EXPECT_EQ(6, total);
+
+    EXPECT_TRUE(list.apply_if_arg(is_equal, 2));
+    EXPECT_FALSE(list.apply_if_arg(is_equal, 7));
+
+    total = 0;
+    list.apply([&total](const int& i) {total += i;});
+    EXPECT_EQ(6, total);
+    EXPECT_TRUE(list.apply_if([](const int& i) {return i > 2;}));
+}
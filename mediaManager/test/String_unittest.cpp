@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <string>
     using std::string;
+#include <utility>
 
 #include "boost/shared_ptr.hpp"
   using boost::shared_ptr;
@@ -355,11 +356,11 @@ TEST_F(StringUnitTest, InsertBefore) {
 //
 ///////////////////////////////////////////////////////////////////////////////
 TEST_F(StringUnitTest, Swap) {
-    // make two different Strings
+    // make two different Strings too long for the inline buffer
     String a;
     String b;
-    ASSERT_EQ(String::OK, a.init("alpha beta"));
-    ASSERT_EQ(String::OK, b.init("charlie delta"));
+    ASSERT_EQ(String::OK, a.init("alpha beta gamma"));
+    ASSERT_EQ(String::OK, b.init("charlie delta echo"));
 
     // store the values of the member variables
     const char* const a_cstr = a.c_str();
@@ -395,3 +396,371 @@ TEST_F(StringUnitTest, Swap) {
     EXPECT_EQ(b_alloc, a.get_allocation());
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// swap() - inline buffers
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, SwapInline) {
+    // one String in the inline buffer, one on the heap
+    String a;
+    String b;
+    ASSERT_EQ(String::OK, a.init("DVD"));
+    ASSERT_EQ(String::OK, b.init("The Quick Brown Fox"));
+
+    const char* const b_cstr = b.c_str();
+    const int totalAllocation = String::get_total_allocation();
+
+    a.swap(b);
+    compareStrings("The Quick Brown Fox", a);
+    compareStrings("DVD", b);
+
+    // the heap buffer changed hands without being copied
+    EXPECT_EQ(b_cstr, a.c_str());
+    EXPECT_EQ(totalAllocation, String::get_total_allocation());
+
+    // and back again
+    a.swap(b);
+    compareStrings("DVD", a);
+    compareStrings("The Quick Brown Fox", b);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// small string storage
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, SmallStringInline) {
+    const int numStrings = String::get_number();
+    const int totalAllocation = String::get_total_allocation();
+
+    // largest string that fits in the inline buffer
+    const string longest(static_cast<size_t>(String::ourInlineCapacity - 1),
+                         'x');
+    String test;
+    ASSERT_EQ(String::OK, test.init(longest.c_str()));
+
+    // characters live inside the String object itself
+    const char* const begin = reinterpret_cast<const char*>(&test);
+    const char* const end = begin + sizeof(test);
+    EXPECT_TRUE(test.c_str() >= begin && test.c_str() < end);
+
+    // but the accounting is the same as for a heap String
+    compareStrings(longest, test);
+    EXPECT_EQ(numStrings + 1, String::get_number());
+    EXPECT_EQ(totalAllocation + String::ourInlineCapacity,
+              String::get_total_allocation());
+}
+
+TEST_F(StringUnitTest, SmallStringGrowsToHeap) {
+    String test;
+    String src;
+    ASSERT_EQ(String::OK, test.init("DVD"));
+    ASSERT_EQ(String::OK, src.init(" Collector's Edition"));
+
+    // the doubling rule moves the contents out of the inline buffer
+    EXPECT_EQ(String::OK, test.insert_before(test.size(), src));
+    compareStringsWithAlloc("DVD Collector's Edition", test,
+                            2 * (3 + src.size() + 1));
+
+    const char* const begin = reinterpret_cast<const char*>(&test);
+    const char* const end = begin + sizeof(test);
+    EXPECT_FALSE(test.c_str() >= begin && test.c_str() < end);
+
+    // clearing goes back to the minimum allocation
+    test.clear();
+    compareStrings("", test);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// move construction / assignment
+//
+///////////////////////////////////////////////////////////////////////////////
+static String makeString(const char* const cstr) {
+    String result;
+    result.init(cstr);
+    return result;
+}
+
+TEST_F(StringUnitTest, MoveConstruct) {
+    const int numStrings = String::get_number();
+    const int totalAllocation = String::get_total_allocation();
+    const string heapVal = "a title that lives on the heap";
+
+    String a;
+    ASSERT_EQ(String::OK, a.init(heapVal.c_str()));
+    const char* const a_cstr = a.c_str();
+
+    // the heap buffer is handed over, not copied
+    String b(std::move(a));
+    EXPECT_EQ(a_cstr, b.c_str());
+    compareStrings(heapVal, b);
+
+    // the source is left empty with no allocation
+    EXPECT_STREQ("", a.c_str());
+    EXPECT_EQ(0, a.size());
+    EXPECT_EQ(0, a.get_allocation());
+
+    // the allocation is only counted once
+    EXPECT_EQ(totalAllocation + static_cast<int>(heapVal.length()) + 1,
+              String::get_total_allocation());
+
+    // inline contents move too
+    String c(makeString("VHS"));
+    compareStrings("VHS", c);
+    EXPECT_EQ(numStrings + 3, String::get_number());
+}
+
+TEST_F(StringUnitTest, MoveAssign) {
+    const int totalAllocation = String::get_total_allocation();
+    const string heapVal = "another title that lives on the heap";
+
+    String a;
+    String b;
+    ASSERT_EQ(String::OK, a.init(heapVal.c_str()));
+    ASSERT_EQ(String::OK, b.init("CD"));
+    const char* const a_cstr = a.c_str();
+
+    // b gives up its old contents and takes over a's buffer
+    b = std::move(a);
+    EXPECT_EQ(a_cstr, b.c_str());
+    compareStrings(heapVal, b);
+    EXPECT_EQ(0, a.get_allocation());
+    EXPECT_EQ(totalAllocation + static_cast<int>(heapVal.length()) + 1,
+              String::get_total_allocation());
+
+    // assigning a returned temporary
+    b = makeString("LP");
+    compareStrings("LP", b);
+    EXPECT_EQ(totalAllocation + 3, String::get_total_allocation());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// clear() - accounting
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, ClearAccounting) {
+    const int numStrings = String::get_number();
+    const int totalAllocation = String::get_total_allocation();
+
+    String test;
+    ASSERT_EQ(String::OK, test.init("a title that lives on the heap"));
+    test.clear();
+
+    // clearing in place neither creates nor destroys a String
+    compareStrings("", test);
+    EXPECT_EQ(numStrings + 1, String::get_number());
+    EXPECT_EQ(totalAllocation + 1, String::get_total_allocation());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// insert_before() - overlapping shifts and self insertion
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, InsertBeforeShortSource) {
+    // the tail is longer than the source, so the shift overlaps itself
+    String test;
+    String src;
+    ASSERT_EQ(String::OK, test.init("abcdefghijklmnopqrstuvwxyz"));
+    ASSERT_EQ(String::OK, src.init("-"));
+    EXPECT_EQ(String::OK, test.insert_before(1, src));
+    compareStringsWithAlloc("a-bcdefghijklmnopqrstuvwxyz", test, 2 * 28);
+
+    // fits in the existing allocation - no reallocation
+    const char* const cstr = test.c_str();
+    EXPECT_EQ(String::OK, test.insert_before(0, src));
+    EXPECT_EQ(cstr, test.c_str());
+    compareStringsWithAlloc("-a-bcdefghijklmnopqrstuvwxyz", test, 2 * 28);
+}
+
+TEST_F(StringUnitTest, InsertBeforeSelf) {
+    String test;
+    ASSERT_EQ(String::OK, test.init("abc"));
+    EXPECT_EQ(String::OK, test.insert_before(1, test));
+    compareStringsWithAlloc("aabcbc", test, 2 * 7);
+
+    String heap;
+    ASSERT_EQ(String::OK, heap.init("0123456789012345678901234567890"));
+    EXPECT_EQ(String::OK, heap.remove(10, 21));
+    EXPECT_EQ(String::OK, heap.insert_before(5, heap));
+    compareStringsWithAlloc("01234012345678956789", heap, 32);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// replace()
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, Replace) {
+    const string fullString = "All your base are belong to us";
+    String test;
+    String src;
+    ASSERT_EQ(String::OK, test.init(fullString.c_str()));
+    const int alloc = test.get_allocation();
+
+    // shorter source - allocation unchanged
+    ASSERT_EQ(String::OK, src.init("cat"));
+    EXPECT_EQ(String::OK, test.replace(9, 4, src));
+    compareStringsWithAlloc("All your cat are belong to us", test, alloc);
+
+    // same length source
+    ASSERT_EQ(String::OK, src.init("dog"));
+    EXPECT_EQ(String::OK, test.replace(9, 3, src));
+    compareStringsWithAlloc("All your dog are belong to us", test, alloc);
+
+    // longer source - doubling rule
+    String longer;
+    ASSERT_EQ(String::OK, longer.init("entire collection"));
+    EXPECT_EQ(String::OK, test.replace(9, 3, longer));
+    compareStringsWithAlloc("All your entire collection are belong to us",
+                            test, 2 * (29 - 3 + 17 + 1));
+
+    // replace everything with nothing
+    String empty;
+    ASSERT_EQ(String::OK, empty.init(""));
+    EXPECT_EQ(String::OK, test.replace(0, test.size(), empty));
+    compareStringsWithAlloc("", test, 2 * (29 - 3 + 17 + 1));
+
+    // bounds
+    EXPECT_EQ(String::ERROR, test.replace(-1, 0, src));
+    EXPECT_EQ(String::ERROR, test.replace(0, -1, src));
+    EXPECT_EQ(String::ERROR, test.replace(1, 0, src));
+    EXPECT_EQ(String::ERROR, test.replace(0, 1, src));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// append()
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, Append) {
+    const int totalAllocation = String::get_total_allocation();
+
+    String test;
+    ASSERT_EQ(String::OK, test.init("DVD"));
+
+    // only the first len characters are used
+    EXPECT_EQ(String::OK, test.append(" / VHS / CD", 6));
+    compareStringsWithAlloc("DVD / VHS", test, 2 * 10);
+
+    // grows onto the heap by the doubling rule
+    EXPECT_EQ(String::OK, test.append(" / CD / LP / Blu-ray", 20));
+    compareStringsWithAlloc("DVD / VHS / CD / LP / Blu-ray", test, 2 * 30);
+    EXPECT_EQ(totalAllocation + test.get_allocation(),
+              String::get_total_allocation());
+
+    // appending part of itself
+    EXPECT_EQ(String::OK, test.append(test.c_str(), 3));
+    compareStringsWithAlloc("DVD / VHS / CD / LP / Blu-rayDVD", test, 2 * 30);
+
+    // nothing to append
+    EXPECT_EQ(String::OK, test.append("", 0));
+    EXPECT_EQ(String::OK, test.append(0, 0));
+    EXPECT_EQ(32, test.size());
+
+    // invalid
+    EXPECT_EQ(String::ERROR, test.append("abc", -1));
+    EXPECT_EQ(String::ERROR, test.append(0, 1));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// reserve()
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, Reserve) {
+    const int totalAllocation = String::get_total_allocation();
+
+    String test;
+    ASSERT_EQ(String::OK, test.init("DVD"));
+
+    // pre-size onto the heap; contents are kept
+    EXPECT_EQ(String::OK, test.reserve(100));
+    compareStringsWithAlloc("DVD", test, 100);
+    EXPECT_EQ(totalAllocation + 100, String::get_total_allocation());
+
+    // additions within the reservation do not reallocate
+    const char* const cstr = test.c_str();
+    EXPECT_EQ(String::OK, test.append(" / VHS / CD / LP", 16));
+    EXPECT_EQ(cstr, test.c_str());
+    compareStringsWithAlloc("DVD / VHS / CD / LP", test, 100);
+
+    // never shrinks
+    EXPECT_EQ(String::OK, test.reserve(10));
+    compareStringsWithAlloc("DVD / VHS / CD / LP", test, 100);
+
+    // invalid
+    EXPECT_EQ(String::ERROR, test.reserve(-1));
+    EXPECT_EQ(totalAllocation + 100, String::get_total_allocation());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// shrink_to_fit()
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, ShrinkToFit) {
+    const int totalAllocation = String::get_total_allocation();
+    const string fullString = "All your base are belong to us";
+
+    // heap to smaller heap
+    String test;
+    ASSERT_EQ(String::OK, test.init(fullString.c_str()));
+    ASSERT_EQ(String::OK, test.reserve(200));
+    test.shrink_to_fit();
+    compareStrings(fullString, test);
+    EXPECT_EQ(totalAllocation + test.get_allocation(),
+              String::get_total_allocation());
+
+    // heap back to the inline buffer
+    EXPECT_EQ(String::OK, test.remove(3, test.size() - 3));
+    test.shrink_to_fit();
+    compareStrings("All", test);
+    const char* const begin = reinterpret_cast<const char*>(&test);
+    EXPECT_TRUE(test.c_str() >= begin && test.c_str() < begin + sizeof(test));
+    EXPECT_EQ(totalAllocation + 4, String::get_total_allocation());
+
+    // already minimal
+    test.shrink_to_fit();
+    compareStrings("All", test);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// allocation accounting across operations
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST_F(StringUnitTest, AllocationAccounting) {
+    const int totalAllocation = String::get_total_allocation();
+
+    {
+        String test;
+        String src;
+        String sub;
+        ASSERT_EQ(String::OK, test.init("alpha"));
+        ASSERT_EQ(String::OK, src.init(" beta gamma delta epsilon"));
+
+        EXPECT_EQ(String::OK, test.insert_before(test.size(), src));
+        EXPECT_EQ(String::OK, test.substring(6, 10, &sub));
+        compareStrings("beta gamma", sub);
+
+        // substring into a String that already has a bigger allocation
+        EXPECT_EQ(String::OK, src.substring(1, 4, &test));
+        compareStrings("beta", test);
+
+        // init on a String that is already in use
+        ASSERT_EQ(String::OK, sub.init("a longer title than before"));
+        compareStrings("a longer title than before", sub);
+
+        EXPECT_EQ(totalAllocation + test.get_allocation() +
+                  src.get_allocation() + sub.get_allocation(),
+                  String::get_total_allocation());
+    }
+
+    // everything is given back
+    EXPECT_EQ(totalAllocation, String::get_total_allocation());
+}
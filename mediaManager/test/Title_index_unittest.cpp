@@ -0,0 +1,273 @@
+/*
+ * Copyright 2012 Marc Schweikert
+ */
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+    using std::string;
+#include <vector>
+    using std::vector;
+
+#include "gtest/gtest.h"
+
+#include "manager/String.h"
+#include "manager/Title_index.h"
+
+
+namespace {
+
+// stands in for Record: anything with a get_title() member
+class Item {
+  public:
+    explicit Item(const char* const in_title)
+      : title(in_title) {
+    }
+
+    String get_title() const {
+        String result;
+        result.init(title);
+        return result;
+    }
+
+  private:
+    const char* title;
+};
+
+// collects the titles visited by a search
+class Collect_titles {
+  public:
+    explicit Collect_titles(vector<string>* in_titles)
+      : titles(in_titles) {
+    }
+
+    void operator() (const Item* item) const {
+        titles->push_back(item->get_title().c_str());
+    }
+
+  private:
+    vector<string>* titles;
+};
+
+vector<string> prefix_search(const Title_index<Item>& index,
+                             const char* const prefix) {
+    vector<string> titles;
+    index.apply_prefix(prefix, Collect_titles(&titles));
+    return titles;
+}
+
+// sorted, since substring searches come back in no particular order
+vector<string> substring_search(const Title_index<Item>& index,
+                                const char* const text) {
+    vector<string> titles;
+    index.apply_substring(text, Collect_titles(&titles));
+    std::sort(titles.begin(), titles.end());
+    return titles;
+}
+
+vector<string> make_titles(const char* const t1,
+                           const char* const t2 = 0,
+                           const char* const t3 = 0) {
+    vector<string> titles;
+    titles.push_back(t1);
+    if (0 != t2) {
+        titles.push_back(t2);
+    }
+    if (0 != t3) {
+        titles.push_back(t3);
+    }
+    return titles;
+}
+
+}  // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Insert / Erase
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Title_indexUnitTest, InsertErase) {
+    Title_index<Item> index;
+    EXPECT_EQ(0, index.size());
+
+    Item star_wars("Star Wars");
+    Item star_trek("Star Trek");
+    EXPECT_EQ(Title_index<Item>::OK, index.insert(&star_wars));
+    EXPECT_EQ(Title_index<Item>::OK, index.insert(&star_trek));
+    EXPECT_EQ(2, index.size());
+
+    EXPECT_EQ(Title_index<Item>::OK, index.erase(&star_wars));
+    EXPECT_EQ(1, index.size());
+    EXPECT_TRUE(prefix_search(index, "Star Wars").empty());
+    EXPECT_TRUE(substring_search(index, "Wars").empty());
+    EXPECT_EQ(make_titles("Star Trek"), substring_search(index, "Star"));
+
+    EXPECT_EQ(Title_index<Item>::OK, index.erase(&star_trek));
+    EXPECT_EQ(0, index.size());
+    EXPECT_TRUE(substring_search(index, "Star").empty());
+}
+
+TEST(Title_indexUnitTest, InsertEraseErrors) {
+    Title_index<Item> index;
+    Item alien("Alien");
+    Item other_alien("Alien");
+
+    EXPECT_EQ(Title_index<Item>::ERROR, index.insert(0));
+    EXPECT_EQ(Title_index<Item>::ERROR, index.erase(0));
+    EXPECT_EQ(Title_index<Item>::ERROR, index.erase(&alien));
+
+    EXPECT_EQ(Title_index<Item>::OK, index.insert(&alien));
+    EXPECT_EQ(Title_index<Item>::ERROR, index.insert(&alien));
+    EXPECT_EQ(Title_index<Item>::ERROR, index.erase(&other_alien));
+
+    // a different object with the same title is fine
+    EXPECT_EQ(Title_index<Item>::OK, index.insert(&other_alien));
+    EXPECT_EQ(2, index.size());
+    EXPECT_EQ(Title_index<Item>::OK, index.erase(&alien));
+    EXPECT_EQ(Title_index<Item>::ERROR, index.erase(&alien));
+    EXPECT_EQ(Title_index<Item>::OK, index.erase(&other_alien));
+    EXPECT_EQ(0, index.size());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Prefix search
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Title_indexUnitTest, Prefix) {
+    Title_index<Item> index;
+    Item items[] = {Item("The Thing"), Item("Alien"), Item("The Fly"),
+                    Item("Aliens"), Item("Them!"), Item("Th")};
+    for (size_t i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+        index.insert(&items[i]);
+    }
+
+    EXPECT_EQ(make_titles("The Fly", "The Thing"),
+              prefix_search(index, "The "));
+    EXPECT_EQ(make_titles("Alien", "Aliens"), prefix_search(index, "Alien"));
+    EXPECT_EQ(make_titles("Aliens"), prefix_search(index, "Aliens"));
+    EXPECT_TRUE(prefix_search(index, "Aliens!").empty());
+    EXPECT_TRUE(prefix_search(index, "Zardoz").empty());
+    EXPECT_TRUE(prefix_search(index, "the").empty());
+
+    // every title, in order
+    vector<string> all = prefix_search(index, "");
+    ASSERT_EQ(6U, all.size());
+    EXPECT_TRUE(std::is_sorted(all.begin(), all.end()));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Substring search
+//
+///////////////////////////////////////////////////////////////////////////////
+TEST(Title_indexUnitTest, Substring) {
+    Title_index<Item> index;
+    Item items[] = {Item("The Thing"), Item("Alien"), Item("The Fly"),
+                    Item("Aliens"), Item("Them!"), Item("Nothing")};
+    for (size_t i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+        index.insert(&items[i]);
+    }
+
+    // case-sensitive
+    EXPECT_EQ(make_titles("Nothing"), substring_search(index, "thing"));
+    EXPECT_EQ(make_titles("The Thing"), substring_search(index, "Thing"));
+    EXPECT_EQ(make_titles("Alien", "Aliens"), substring_search(index, "lien"));
+    EXPECT_EQ(make_titles("Them!"), substring_search(index, "m!"));
+    EXPECT_TRUE(substring_search(index, "Alien ").empty());
+    EXPECT_TRUE(substring_search(index, "xyz").empty());
+
+    // the search text's grams are all present, but not together
+    EXPECT_TRUE(substring_search(index, "The Flien").empty());
+
+    // short search texts
+    EXPECT_EQ(make_titles("The Fly", "The Thing", "Them!"),
+              substring_search(index, "Th"));
+    EXPECT_EQ(6U, substring_search(index, "").size());
+}
+
+// repeated grams within a title, and titles sharing grams
+TEST(Title_indexUnitTest, SubstringRepeatedGrams) {
+    Title_index<Item> index;
+    Item tora("Tora! Tora! Tora!");
+    Item tor("Tor");
+    Item aaaa("aaaa");
+    index.insert(&tora);
+    index.insert(&tor);
+    index.insert(&aaaa);
+
+    EXPECT_EQ(make_titles("Tor", "Tora! Tora! Tora!"),
+              substring_search(index, "Tor"));
+    EXPECT_EQ(make_titles("Tora! Tora! Tora!"),
+              substring_search(index, "! Tora!"));
+    EXPECT_EQ(make_titles("aaaa"), substring_search(index, "aaa"));
+    EXPECT_EQ(make_titles("aaaa"), substring_search(index, "aaaa"));
+    EXPECT_TRUE(substring_search(index, "aaaaa").empty());
+
+    EXPECT_EQ(Title_index<Item>::OK, index.erase(&tora));
+    EXPECT_EQ(make_titles("Tor"), substring_search(index, "Tor"));
+    EXPECT_TRUE(substring_search(index, "ora").empty());
+}
+
+// add and remove many titles in an interleaved order and check the searches
+// against a brute force scan, which exercises fixing up posting positions
+TEST(Title_indexUnitTest, InsertEraseMany) {
+    const int count = 500;
+    vector<string> titles;
+    for (int i = 0; i < count; i++) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "Part %d of %d", i % 37, i);
+        titles.push_back(buffer);
+    }
+    vector<Item> items;
+    for (int i = 0; i < count; i++) {
+        items.push_back(Item(titles[static_cast<size_t>(i)].c_str()));
+    }
+
+    Title_index<Item> index;
+    for (int i = 0; i < count; i++) {
+        ASSERT_EQ(Title_index<Item>::OK,
+                  index.insert(&items[static_cast<size_t>(i)]));
+    }
+    // remove every third, starting from the middle
+    vector<bool> present(static_cast<size_t>(count), true);
+    for (int i = count / 2; i < count + count / 2; i += 3) {
+        const size_t j = static_cast<size_t>(i % count);
+        ASSERT_EQ(Title_index<Item>::OK, index.erase(&items[j]));
+        present[j] = false;
+    }
+
+    const char* const searches[] = {"Part 1", "t 3", " of 4", "of 49", "9"};
+    for (size_t s = 0; s < sizeof(searches) / sizeof(searches[0]); s++) {
+        vector<string> expected;
+        for (size_t i = 0; i < titles.size(); i++) {
+            if (present[i] && (string::npos != titles[i].find(searches[s]))) {
+                expected.push_back(titles[i]);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(expected, substring_search(index, searches[s]))
+            << "searching for " << searches[s];
+    }
+}
+
+TEST(Title_indexUnitTest, Clear) {
+    Title_index<Item> index;
+    Item alien("Alien");
+    Item aliens("Aliens");
+    index.insert(&alien);
+    index.insert(&aliens);
+
+    index.clear();
+    EXPECT_EQ(0, index.size());
+    EXPECT_TRUE(prefix_search(index, "").empty());
+    EXPECT_TRUE(substring_search(index, "lie").empty());
+
+    EXPECT_EQ(Title_index<Item>::OK, index.insert(&aliens));
+    EXPECT_EQ(make_titles("Aliens"), substring_search(index, "lie"));
+}